@@ -9,6 +9,7 @@ void Apple::Init(const EngineContext& engineContext)
 {
     this->engineContext = &engineContext;
     SetMesh(engineContext, "default");
+    SetSpriteBatchable(true);
     SetSelected(false);
     SetCollider(std::make_unique<AABBCollider>(this, glm::vec2(0.9, 0.9))); 
     SetCollision(engineContext.stateManager->GetCurrentState()->GetObjectManager(), "apple", { "player_selection" });
@@ -39,6 +39,7 @@ void ApplePlayerController::Init(const EngineContext& engineContext)
 {
     SetMesh(engineContext, "default");
     SetMaterial(engineContext, "m_selection_box");
+    SetSpriteBatchable(true);
     SetRenderLayer(engineContext, "UI");
     SetVisibility(false);
     SetCollider(std::make_unique<AABBCollider>(this, glm::vec2(1, 1)));
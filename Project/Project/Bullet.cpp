@@ -14,7 +14,8 @@ void Bullet::Init(const EngineContext& engineContext)
 {
     SNAKE_LOG("Bullet initialized");
     SetMesh(engineContext, "default");
-    SetMaterial(engineContext, "m_instancing");
+    SetMaterial(engineContext, "m_instancing_compact");
+    SetSpriteBatchable(true);
     SetRenderLayer(engineContext, "Bullet");
     GetMaterial()->EnableInstancing(true, GetMesh());
     AttachAnimator(engineContext.renderManager->GetSpriteSheetByTag("animTest"), 0.08f);
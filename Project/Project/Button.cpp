@@ -8,6 +8,7 @@ void Button::Init(const EngineContext& engineContext)
 {
     SetMesh(engineContext, "default");
     SetMaterial(engineContext, "m_blueMButton");
+    SetSpriteBatchable(true);
     SetCollider(std::make_unique<AABBCollider>(this, glm::vec2(1.f,1.f)));
     collider->SetUseTransformScale(true);
     SetCollision(engineContext.stateManager->GetCurrentState()->GetObjectManager(), "button", { "player" });
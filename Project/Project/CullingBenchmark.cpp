@@ -0,0 +1,229 @@
+#include "CullingBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+
+#include "Debug.h"
+#include "Engine.h"
+#include "MainMenu.h"
+#include "TextObject.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    constexpr size_t OBJECT_COUNTS[] = { 10'000, 100'000, 1'000'000 };
+    constexpr float OBJECT_SIZE = 32.0f;
+    // World area per object; with the default window roughly 2% of the world is on screen.
+    constexpr float WORLD_AREA_PER_OBJECT = 2000.0f;
+    // Same split as RenderManager's parallel draw item build.
+    constexpr size_t MIN_OBJECTS_PER_CHUNK = 1024;
+    constexpr size_t CHUNKS_PER_THREAD = 4;
+
+    int IterationsFor(size_t objectCount)
+    {
+        return objectCount >= 1'000'000 ? 10 : 50;
+    }
+
+    // Best of several runs, in milliseconds.
+    template<typename Func>
+    double MeasureBest(int iterations, Func&& func)
+    {
+        double best = 1e30;
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            func();
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        return best;
+    }
+
+    std::string FormatMs(double ms)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.3f ms", ms);
+        return buffer;
+    }
+}
+
+void CullingBenchmark::Load(const EngineContext& engineContext)
+{
+    SNAKE_LOG("[CullingBenchmark] load called");
+}
+
+void CullingBenchmark::Init(const EngineContext& engineContext)
+{
+    SNAKE_LOG("[CullingBenchmark] init called");
+
+    resultLines.clear();
+    resultLines.push_back(std::string("Culling benchmark (best path: ") + FrustumCuller::GetCullPathName(FrustumCuller::GetBestCullPath()) + ")");
+    for (size_t objectCount : OBJECT_COUNTS)
+        RunBenchmark(engineContext, objectCount);
+    resultLines.push_back("N: main menu   ESC: quit");
+
+    Font* font = engineContext.renderManager->GetFontByTag("default");
+    const float lineHeight = 40.0f;
+    float y = static_cast<float>(engineContext.windowManager->GetHeight()) / 2 - lineHeight;
+    for (const std::string& line : resultLines)
+    {
+        auto* text = static_cast<TextObject*>(objectManager.AddObject(std::make_unique<TextObject>(font, line, TextAlignH::Left, TextAlignV::Top)));
+        text->GetTransform2D().SetPosition({ -static_cast<float>(engineContext.windowManager->GetWidth()) / 2 + 20, y });
+        text->GetTransform2D().SetScale({ 0.5f, 0.5f });
+        text->SetIgnoreCamera(true, cameraManager.GetActiveCamera());
+        text->SetRenderLayer(engineContext, "UI");
+        y -= lineHeight;
+    }
+}
+
+void CullingBenchmark::RunBenchmark(const EngineContext& engineContext, size_t objectCount)
+{
+    std::mt19937 rng(1234);
+    const float halfWorld = std::sqrt(static_cast<float>(objectCount) * WORLD_AREA_PER_OBJECT) / 2;
+    std::uniform_real_distribution<float> position(-halfWorld, halfWorld);
+
+    std::vector<std::unique_ptr<GameObject>> storage;
+    std::vector<Object*> objects;
+    storage.reserve(objectCount);
+    objects.reserve(objectCount);
+    for (size_t i = 0; i < objectCount; ++i)
+    {
+        auto obj = std::make_unique<GameObject>();
+        obj->SetMesh(engineContext, "default");
+        obj->GetTransform2D().SetPosition({ position(rng), position(rng) });
+        obj->GetTransform2D().SetScale({ OBJECT_SIZE, OBJECT_SIZE });
+        objects.push_back(obj.get());
+        storage.push_back(std::move(obj));
+    }
+    // Objects are rarely laid out in allocation order in a real scene.
+    std::shuffle(objects.begin(), objects.end(), rng);
+
+    Camera2D& camera = *cameraManager.GetActiveCamera();
+    const glm::vec2 viewportSize(engineContext.windowManager->GetWidth(), engineContext.windowManager->GetHeight());
+    const int iterations = IterationsFor(objectCount);
+
+    std::vector<Object*> visibleObjects;
+    const double objectPathMs = MeasureBest(iterations, [&]() {
+        FrustumCuller::CullVisible(camera, objects, visibleObjects, viewportSize);
+        });
+
+    CullingBounds bounds;
+    const double fullSyncMs = MeasureBest(1, [&]() { bounds.Sync(objects); });
+    const double steadySyncMs = MeasureBest(iterations, [&]() { bounds.Sync(objects); });
+
+    std::string line = std::to_string(objectCount) + " objects: per-object " + FormatMs(objectPathMs);
+    std::vector<uint32_t> visibleIndices(objectCount);
+    for (CullPath path : { CullPath::Scalar, CullPath::SSE2, CullPath::AVX2 })
+    {
+        if (path > FrustumCuller::GetBestCullPath())
+            break;
+
+        size_t visibleCount = 0;
+        const double ms = MeasureBest(iterations, [&]() {
+            visibleCount = FrustumCuller::CullBounds(camera, bounds, viewportSize, 0, objectCount, visibleIndices.data(), path);
+            });
+        if (visibleCount != visibleObjects.size())
+            SNAKE_WRN("[CullingBenchmark] " << FrustumCuller::GetCullPathName(path) << " found " << visibleCount << " visible, per-object path found " << visibleObjects.size());
+
+        line += std::string(", ") + FrustumCuller::GetCullPathName(path) + " " + FormatMs(ms);
+    }
+
+    VisibilityGrid grid;
+    const double gridBuildMs = MeasureBest(1, [&]() { grid.Sync(objects); });
+    const double gridSyncMs = MeasureBest(iterations, [&]() { grid.Sync(objects); });
+    const double gridQueryMs = MeasureBest(iterations, [&]() { grid.Query(camera, viewportSize, visibleIndices); });
+    if (visibleIndices.size() != visibleObjects.size())
+        SNAKE_WRN("[CullingBenchmark] grid found " << visibleIndices.size() << " visible, per-object path found " << visibleObjects.size());
+    line += ", grid query " + FormatMs(gridQueryMs);
+
+    resultLines.push_back(line);
+    resultLines.push_back("    visible " + std::to_string(visibleObjects.size()) +
+        ", bounds sync: full " + FormatMs(fullSyncMs) + ", unchanged " + FormatMs(steadySyncMs) +
+        ", grid sync: build " + FormatMs(gridBuildMs) + ", unchanged " + FormatMs(gridSyncMs));
+    resultLines.push_back(RunWorkerSweep(camera, bounds, viewportSize, iterations, visibleObjects.size()));
+
+    SNAKE_LOG("[CullingBenchmark] " << resultLines[resultLines.size() - 3]);
+    SNAKE_LOG("[CullingBenchmark] " << resultLines[resultLines.size() - 2]);
+    SNAKE_LOG("[CullingBenchmark] " << resultLines.back());
+}
+
+std::string CullingBenchmark::RunWorkerSweep(const Camera2D& camera, const CullingBounds& bounds, glm::vec2 viewportSize, int iterations, size_t expectedVisible)
+{
+    const size_t objectCount = bounds.GetCount();
+    const unsigned hardwareThreads = std::thread::hardware_concurrency();
+    const unsigned maxWorkers = std::min(hardwareThreads > 1 ? hardwareThreads - 1 : 0u, ThreadPool::MAX_WORKERS);
+
+    std::vector<uint32_t> visibleIndices(objectCount);
+    std::string line = "    " + std::string(FrustumCuller::GetCullPathName(FrustumCuller::GetBestCullPath())) + " by threads:";
+    size_t singleVisible = 0;
+    const double singleMs = MeasureBest(iterations, [&]() {
+        singleVisible = FrustumCuller::CullBounds(camera, bounds, viewportSize, 0, objectCount, visibleIndices.data());
+        });
+    if (singleVisible != expectedVisible)
+        SNAKE_WRN("[CullingBenchmark] 1 thread found " << singleVisible << " visible, per-object path found " << expectedVisible);
+    line += " 1 " + FormatMs(singleMs);
+
+    for (unsigned workerCount = 1; workerCount <= maxWorkers; ++workerCount)
+    {
+        ThreadPool pool;
+        pool.Init(workerCount);
+        const size_t chunkCount = std::min<size_t>(pool.GetThreadCount() * CHUNKS_PER_THREAD,
+            (objectCount + MIN_OBJECTS_PER_CHUNK - 1) / MIN_OBJECTS_PER_CHUNK);
+        std::vector<size_t> chunkVisible(chunkCount);
+
+        const double ms = MeasureBest(iterations, [&]() {
+            pool.ParallelFor(chunkCount, [&](size_t chunk) {
+                const size_t begin = objectCount * chunk / chunkCount;
+                const size_t end = objectCount * (chunk + 1) / chunkCount;
+                chunkVisible[chunk] = FrustumCuller::CullBounds(camera, bounds, viewportSize, begin, end, visibleIndices.data() + begin);
+                });
+            });
+
+        size_t visibleCount = 0;
+        for (size_t count : chunkVisible)
+            visibleCount += count;
+        if (visibleCount != expectedVisible)
+            SNAKE_WRN("[CullingBenchmark] " << pool.GetThreadCount() << " threads found " << visibleCount << " visible, per-object path found " << expectedVisible);
+
+        char speedup[32];
+        std::snprintf(speedup, sizeof(speedup), " (%.2fx)", ms > 0.0 ? singleMs / ms : 0.0);
+        line += ", " + std::to_string(pool.GetThreadCount()) + " " + FormatMs(ms) + speedup;
+    }
+    if (maxWorkers == 0)
+        line += " (no spare hardware threads to sweep)";
+    return line;
+}
+
+void CullingBenchmark::Update(float dt, const EngineContext& engineContext)
+{
+    if (engineContext.inputManager->IsKeyReleased(KEY_N))
+    {
+        engineContext.stateManager->ChangeState(std::make_unique<MainMenu>());
+    }
+    if (engineContext.inputManager->IsKeyPressed(KEY_ESCAPE))
+    {
+        engineContext.engine->RequestQuit();
+    }
+
+    objectManager.UpdateAll(dt, engineContext);
+}
+
+void CullingBenchmark::Draw(const EngineContext& engineContext)
+{
+    engineContext.renderManager->ClearBackground(0, 0, engineContext.windowManager->GetWidth(), engineContext.windowManager->GetHeight(), { 0.1,0.1,0.1,1 });
+    objectManager.DrawAll(engineContext, cameraManager.GetActiveCamera());
+}
+
+void CullingBenchmark::Free(const EngineContext& engineContext)
+{
+    SNAKE_LOG("[CullingBenchmark] free called");
+}
+
+void CullingBenchmark::Unload(const EngineContext& engineContext)
+{
+    SNAKE_LOG("[CullingBenchmark] unload called");
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "GameState.h"
+
+class TextObject;
+
+// Compares the per-object culler with the SoA culling paths and the visibility grid at 10k/100k/1M objects,
+// then times the SoA path split across worker threads for every worker count the machine has.
+// The measurement runs once in Init and the results are logged and shown on screen.
+class CullingBenchmark : public GameState
+{
+public:
+    void Load(const EngineContext& engineContext) override;
+    void Init(const EngineContext& engineContext) override;
+    void Update(float dt, const EngineContext& engineContext) override;
+    void Draw(const EngineContext& engineContext) override;
+    void Free(const EngineContext& engineContext) override;
+    void Unload(const EngineContext& engineContext) override;
+
+private:
+    void RunBenchmark(const EngineContext& engineContext, size_t objectCount);
+
+    // Parallel CullBounds over @p bounds with 1..N workers, chunked the way RenderManager::Submit does it.
+    std::string RunWorkerSweep(const Camera2D& camera, const CullingBounds& bounds, glm::vec2 viewportSize, int iterations, size_t expectedVisible);
+
+    std::vector<std::string> resultLines;
+};
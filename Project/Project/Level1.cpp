@@ -19,12 +19,23 @@ void Level1::Load(const EngineContext& engineContext)
     engineContext.renderManager->RegisterTexture("t_selection_box", "Textures/TransparentSquare.png");
     engineContext.renderManager->RegisterTexture("t_border", "Textures/SquareBorder.png");
     engineContext.renderManager->RegisterTexture("t_fill", "Textures/Square.png");
-    engineContext.renderManager->RegisterMaterial("m_apple", "s_default", { std::pair<std::string, std::string>("u_Texture","t_apple") });
-    engineContext.renderManager->RegisterMaterial("m_apple_highlighted", "s_default", { std::pair<std::string, std::string>("u_Texture","t_apple_selected") });
+    engineContext.renderManager->RegisterMaterial("m_apple", "s_instancing_resident_array", { std::pair<std::string, std::string>("u_Texture","t_apple") });
+    engineContext.renderManager->RegisterMaterial("m_apple_highlighted", "s_instancing_resident_array", { std::pair<std::string, std::string>("u_Texture","t_apple_selected") });
     engineContext.renderManager->RegisterMaterial("m_background", "s_default", { std::pair<std::string, std::string>("u_Texture","t_background") });
     engineContext.renderManager->RegisterMaterial("m_selection_box", "s_default", { std::pair<std::string, std::string>("u_Texture","t_selection_box") });
-    engineContext.renderManager->RegisterMaterial("m_border", "s_default", { std::pair<std::string, std::string>("u_Texture","t_border") });
-    engineContext.renderManager->RegisterMaterial("m_fill", "s_default", { std::pair<std::string, std::string>("u_Texture","t_fill") });
+    engineContext.renderManager->RegisterMaterial("m_border", "s_instancing_resident_array", { std::pair<std::string, std::string>("u_Texture","t_border") });
+    engineContext.renderManager->RegisterMaterial("m_fill", "s_instancing_resident_array", { std::pair<std::string, std::string>("u_Texture","t_fill") });
+
+    // Apples rarely move, so their instance data stays on the GPU and only changed apples are re-uploaded.
+    // Same-size textures are packed into arrays: both apple materials draw as one batch, border and fill as another.
+    for (const char* material : { "m_apple", "m_apple_highlighted", "m_border", "m_fill" })
+        engineContext.renderManager->GetMaterialByTag(material)->EnableInstancing(true, engineContext.renderManager->GetMeshByTag("default"));
+    engineContext.renderManager->MergeTextureArrays();
+
+    // The background and the selection box have no same-size partner, so they share an atlas page instead.
+    engineContext.renderManager->AddTextureToAtlas("t_background", "level1");
+    engineContext.renderManager->AddTextureToAtlas("t_selection_box", "level1");
+    engineContext.renderManager->BuildTextureAtlases();
 
     engineContext.engine->RenderDebugDraws(false);
 }
@@ -51,6 +62,7 @@ void Level1::Init(const EngineContext& engineContext)
     auto* backgroundObj = objectManager.AddObject(std::make_unique<GameObject>(), "background");
     backgroundObj->SetMesh(engineContext, "default");
     backgroundObj->SetMaterial(engineContext, "m_background");
+    backgroundObj->SetSpriteBatchable(true);
     backgroundObj->GetTransform2D().SetScale({ engineContext.windowManager->GetWidth(), engineContext.windowManager->GetHeight() });
     backgroundObj->SetIgnoreCamera(true, cameraManager.GetActiveCamera());
     backgroundObj->SetRenderLayer(engineContext, "Game.Background");
@@ -58,6 +70,7 @@ void Level1::Init(const EngineContext& engineContext)
     auto* scoreUIObj = objectManager.AddObject(std::make_unique<GameObject>(), "score_ui");
     scoreUIObj->SetMesh(engineContext, "default");
     scoreUIObj->SetMaterial(engineContext, "m_apple");
+    scoreUIObj->SetSpriteBatchable(true);
     scoreUIObj->GetTransform2D().SetPosition({ 0, 100 });
     scoreUIObj->GetTransform2D().SetScale({ 300, 300 });
     scoreUIObj->SetIgnoreCamera(true, cameraManager.GetActiveCamera());
@@ -109,6 +122,7 @@ void Level1::Init(const EngineContext& engineContext)
     auto timerBarBackground = objectManager.AddObject(std::make_unique<GameObject>(), "timerBarBackground");
     timerBarBackground->SetMesh(engineContext, "default");
     timerBarBackground->SetMaterial(engineContext, "m_border");
+    timerBarBackground->SetSpriteBatchable(true);
     timerBarBackground->SetColor({ 0.0f, 1.0f, 0.12f, 1.0f });
     timerBarBackground->GetTransform2D().SetPosition(pos);
     timerBarBackground->GetTransform2D().SetScale({ appleSizeX, fillInitialScaleY });
@@ -117,6 +131,7 @@ void Level1::Init(const EngineContext& engineContext)
     timerBarFill = objectManager.AddObject(std::make_unique<GameObject>(), "timerBarFill");
     timerBarFill->SetMesh(engineContext, "default");
     timerBarFill->SetMaterial(engineContext, "m_fill");
+    timerBarFill->SetSpriteBatchable(true);
     timerBarFill->SetColor({ 0.0f, 1.0f, 0.12f, 1.0f });
     timerBarFill->GetTransform2D().SetPosition(pos);
     timerBarFill->GetTransform2D().SetScale({ appleSizeX, fillInitialScaleY });
@@ -199,6 +214,18 @@ void Level1::HandleStateInput(const EngineContext& engineContext)
     {
         Restart(engineContext);
     }
+    if (engineContext.inputManager->IsKeyPressed(KEY_M))
+    {
+        RenderManager& renderManager = *engineContext.renderManager;
+        // The stats overlay (O) shows the active mode next to the draw counts.
+        const bool useMultiDraw = renderManager.GetSubmissionMode() == SubmissionMode::Direct;
+        renderManager.SetSubmissionMode(useMultiDraw ? SubmissionMode::MultiDrawIndirect : SubmissionMode::Direct);
+    }
+    if (engineContext.inputManager->IsKeyPressed(KEY_O))
+    {
+        RenderManager& renderManager = *engineContext.renderManager;
+        renderManager.SetStatsOverlay(!renderManager.IsStatsOverlayEnabled());
+    }
 }
 
 void Level1::HandleSoundInput(const EngineContext& engineContext)
@@ -1,8 +1,10 @@
 ﻿#include "MainMenu.h"
 #include <iostream>
 #include "Button.h"
+#include "CullingBenchmark.h"
 #include "Debug.h"
 #include "Level1.h"
+#include "StaticBenchmark.h"
 
 void MainMenu::Load(const EngineContext& engineContext)
 {
@@ -53,6 +55,14 @@ void MainMenu::Update(float dt, const EngineContext& engineContext)
     {
         engineContext.stateManager->ChangeState(std::make_unique<Level1>());
     }
+    if (engineContext.inputManager->IsKeyReleased(KEY_B))
+    {
+        engineContext.stateManager->ChangeState(std::make_unique<CullingBenchmark>());
+    }
+    if (engineContext.inputManager->IsKeyReleased(KEY_T))
+    {
+        engineContext.stateManager->ChangeState(std::make_unique<StaticBenchmark>());
+    }
     if (engineContext.inputManager->IsKeyPressed(KEY_ESCAPE))
     {
         engineContext.engine->RequestQuit();
@@ -14,6 +14,7 @@ void Player::Init(const EngineContext& engineContext)
 
     SetMesh(engineContext, "default");
     SetMaterial(engineContext, "m_animation");
+    SetSpriteBatchable(true);
     SpriteSheet* sheet = engineContext.renderManager->GetSpriteSheetByTag("animTest");
     sheet->AddClip("sidewalk", { 0,1,2,3,4,5,6,7,8 }, 0.08f, true);
     sheet->AddClip("frontwalk", { 86,87,88,89,90,91 }, 0.08f, true);
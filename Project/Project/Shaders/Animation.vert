@@ -4,7 +4,11 @@ layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec2 aUV;
 
 uniform mat4 u_Model;
-uniform mat4 u_Projection;
+layout (std140) uniform CameraBlock
+{
+    mat4 u_ViewProjections[64];
+};
+uniform int u_CameraIndex;
 uniform vec2 u_UVScale;
 uniform vec2 u_UVOffset;
 out vec2 v_UV;
@@ -12,5 +16,5 @@ out vec2 v_UV;
 void main()
 {
     v_UV = aUV * u_UVScale + u_UVOffset;
-    gl_Position = u_Projection * u_Model * vec4(aPos, 0.0, 1.0);
+    gl_Position = u_ViewProjections[u_CameraIndex] * u_Model * vec4(aPos, 0.0, 1.0);
 }
@@ -3,11 +3,17 @@
 layout (location = 0) in vec3 aPos;
 layout(location = 1) in vec2 a_UV;
 out vec2 v_UV;
-uniform mat4 u_Projection;
+layout (std140) uniform CameraBlock
+{
+    mat4 u_ViewProjections[64];
+};
+uniform int u_CameraIndex;
 uniform mat4 u_Model;
+uniform vec2 u_UVOffset;
+uniform vec2 u_UVScale;
 
 void main()
 {
-    gl_Position = u_Projection * u_Model * vec4(aPos, 1.0);
-    v_UV = a_UV;
+    gl_Position = u_ViewProjections[u_CameraIndex] * u_Model * vec4(aPos, 1.0);
+    v_UV = a_UV * u_UVScale + u_UVOffset;
 }
@@ -11,11 +11,15 @@ layout (location = 8) in vec2 i_UVScale;
 out vec2 v_UV;
 out vec4 v_Color;
 
-uniform mat4 u_Projection;
+layout (std140) uniform CameraBlock
+{
+    mat4 u_ViewProjections[64];
+};
+uniform int u_CameraIndex;
 
 void main()
 {
-    gl_Position = u_Projection * i_Model * vec4(aPos, 1.0);
+    gl_Position = u_ViewProjections[u_CameraIndex] * i_Model * vec4(aPos, 1.0);
     v_UV = a_UV * i_UVScale + i_UVOffset;
     v_Color = i_Color;
 }
@@ -0,0 +1,12 @@
+#version 330 core
+
+out vec4 FragColor;
+in vec2 v_UV;
+in vec4 v_Color;
+flat in uint v_TextureLayer;
+uniform sampler2DArray u_Texture;
+
+void main()
+{
+    FragColor = texture(u_Texture, vec3(v_UV, float(v_TextureLayer))) * v_Color;
+}
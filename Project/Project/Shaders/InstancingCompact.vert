@@ -0,0 +1,27 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 a_UV;
+
+layout (location = 9) in vec3 i_AffineRow0;
+layout (location = 10) in vec3 i_AffineRow1;
+layout (location = 11) in vec4 i_Color;
+layout (location = 12) in vec4 i_UVRect;
+
+out vec2 v_UV;
+out vec4 v_Color;
+
+layout (std140) uniform CameraBlock
+{
+    mat4 u_ViewProjections[64];
+};
+uniform int u_CameraIndex;
+
+void main()
+{
+    vec3 p = vec3(aPos.xy, 1.0);
+    vec2 worldPos = vec2(dot(i_AffineRow0, p), dot(i_AffineRow1, p));
+    gl_Position = u_ViewProjections[u_CameraIndex] * vec4(worldPos, aPos.z, 1.0);
+    v_UV = a_UV * i_UVRect.zw + i_UVRect.xy;
+    v_Color = i_Color;
+}
@@ -0,0 +1,41 @@
+#version 430 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 a_UV;
+
+layout (location = 13) in uint i_Slot;
+layout (location = 14) in uint i_TextureLayer;
+
+struct ResidentInstance
+{
+    vec4 affineRow0;
+    vec4 affineRow1;
+    vec4 color;
+    vec4 uvRect;
+};
+
+layout (std430, binding = 0) readonly buffer InstanceStore
+{
+    ResidentInstance instances[];
+};
+
+out vec2 v_UV;
+out vec4 v_Color;
+flat out uint v_TextureLayer;
+
+layout (std140) uniform CameraBlock
+{
+    mat4 u_ViewProjections[64];
+};
+uniform int u_CameraIndex;
+
+void main()
+{
+    ResidentInstance instance = instances[i_Slot];
+    vec3 p = vec3(aPos.xy, 1.0);
+    vec2 worldPos = vec2(dot(instance.affineRow0.xyz, p), dot(instance.affineRow1.xyz, p));
+    gl_Position = u_ViewProjections[u_CameraIndex] * vec4(worldPos, aPos.z, 1.0);
+    v_UV = a_UV * instance.uvRect.zw + instance.uvRect.xy;
+    v_Color = instance.color;
+    v_TextureLayer = i_TextureLayer;
+}
@@ -0,0 +1,162 @@
+#include "StaticBenchmark.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+#include "Debug.h"
+#include "Engine.h"
+#include "MainMenu.h"
+#include "TextObject.h"
+
+namespace
+{
+    constexpr int GRID_WIDTH = 500;
+    constexpr int GRID_HEIGHT = 400;
+    constexpr float TILE_SPACING = 40.0f;
+    constexpr float TILE_SIZE = 32.0f;
+    constexpr size_t TILES_PER_KILL = 1000;
+    constexpr int FRAMES_PER_REPORT = 30;
+
+    const glm::vec4 TILE_COLORS[] = {
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        { 0.8f, 0.9f, 1.0f, 1.0f },
+        { 1.0f, 0.9f, 0.8f, 1.0f },
+        { 0.85f, 1.0f, 0.85f, 1.0f },
+    };
+}
+
+void StaticBenchmark::Load(const EngineContext& engineContext)
+{
+    SNAKE_LOG("[StaticBenchmark] load called");
+    engineContext.renderManager->RegisterMaterial("m_static_tile", "s_default", { std::pair<std::string, std::string>("u_Texture","default") });
+}
+
+void StaticBenchmark::Init(const EngineContext& engineContext)
+{
+    SNAKE_LOG("[StaticBenchmark] init called");
+
+    tiles.clear();
+    tiles.reserve(static_cast<size_t>(GRID_WIDTH) * GRID_HEIGHT);
+    const glm::vec2 origin(-GRID_WIDTH * TILE_SPACING / 2, -GRID_HEIGHT * TILE_SPACING / 2);
+    for (int y = 0; y < GRID_HEIGHT; ++y)
+    {
+        for (int x = 0; x < GRID_WIDTH; ++x)
+        {
+            auto* tile = static_cast<GameObject*>(objectManager.AddObject(std::make_unique<GameObject>()));
+            tile->SetMesh(engineContext, "default");
+            tile->SetMaterial(engineContext, "m_static_tile");
+            tile->SetRenderLayer(engineContext, "Game.Background");
+            tile->SetColor(TILE_COLORS[(x / 8 + y / 8) % 4]);
+            tile->GetTransform2D().SetPosition(origin + glm::vec2(x, y) * TILE_SPACING);
+            tile->GetTransform2D().SetScale({ TILE_SIZE, TILE_SIZE });
+            tile->SetStatic(isStatic);
+            tile->SetSpriteBatchable(true);
+            tiles.push_back(tile);
+        }
+    }
+
+    cameraManager.GetActiveCamera()->SetZoom(0.25f);
+    isSpriteBatching = engineContext.renderManager->IsSpriteBatchingEnabled();
+
+    statsText = static_cast<TextObject*>(objectManager.AddObject(std::make_unique<TextObject>(engineContext.renderManager->GetFontByTag("default"), "", TextAlignH::Left, TextAlignV::Top)));
+    statsText->GetTransform2D().SetPosition({ -static_cast<float>(engineContext.windowManager->GetWidth()) / 2 + 20, static_cast<float>(engineContext.windowManager->GetHeight()) / 2 - 20 });
+    statsText->GetTransform2D().SetScale({ 0.5f, 0.5f });
+    statsText->SetIgnoreCamera(true, cameraManager.GetActiveCamera());
+    statsText->SetRenderLayer(engineContext, "UI");
+    UpdateStatsText();
+}
+
+void StaticBenchmark::SetTilesStatic(bool shouldBeStatic)
+{
+    isStatic = shouldBeStatic;
+    for (GameObject* tile : tiles)
+        tile->SetStatic(shouldBeStatic);
+    drawAllMsSum = 0.0;
+    measuredFrames = 0;
+}
+
+void StaticBenchmark::KillRandomTiles(size_t count)
+{
+    static std::mt19937 rng(42);
+    for (size_t i = 0; i < count && !tiles.empty(); ++i)
+    {
+        const size_t index = rng() % tiles.size();
+        tiles[index]->Kill();
+        tiles[index] = tiles.back();
+        tiles.pop_back();
+    }
+}
+
+void StaticBenchmark::UpdateStatsText()
+{
+    const StaticBatcher& batcher = objectManager.GetStaticBatcher();
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer), "%zu sprites, static %s (S), sprite batching %s (D)   DrawAll %.3f ms, %zu draw calls\nchunks %zu, baked %zu, rebuilt %zu   K: kill %zu   N: main menu",
+        tiles.size(), isStatic ? "on" : "off", isSpriteBatching ? "on" : "off", measuredFrames ? drawAllMsSum / measuredFrames : 0.0,
+        drawCallCount, batcher.GetChunkCount(), batcher.GetMemberCount(), batcher.GetLastRebuildCount(), TILES_PER_KILL);
+    statsText->SetText(buffer);
+}
+
+void StaticBenchmark::Update(float dt, const EngineContext& engineContext)
+{
+    if (engineContext.inputManager->IsKeyReleased(KEY_N))
+    {
+        engineContext.stateManager->ChangeState(std::make_unique<MainMenu>());
+    }
+    if (engineContext.inputManager->IsKeyPressed(KEY_ESCAPE))
+    {
+        engineContext.engine->RequestQuit();
+    }
+    if (engineContext.inputManager->IsKeyPressed(KEY_S))
+    {
+        SetTilesStatic(!isStatic);
+    }
+    if (engineContext.inputManager->IsKeyPressed(KEY_K))
+    {
+        KillRandomTiles(TILES_PER_KILL);
+    }
+    if (engineContext.inputManager->IsKeyPressed(KEY_D))
+    {
+        isSpriteBatching = !engineContext.renderManager->IsSpriteBatchingEnabled();
+        engineContext.renderManager->SetSpriteBatching(isSpriteBatching);
+        drawAllMsSum = 0.0;
+        measuredFrames = 0;
+    }
+    drawCallCount = engineContext.renderManager->GetRenderStats().drawCallCount;
+
+    time += dt;
+    cameraManager.GetActiveCamera()->SetPosition({ std::cos(time * 0.2f) * 6000.0f, std::sin(time * 0.2f) * 4000.0f });
+
+    objectManager.UpdateAll(dt, engineContext);
+}
+
+void StaticBenchmark::Draw(const EngineContext& engineContext)
+{
+    engineContext.renderManager->ClearBackground(0, 0, engineContext.windowManager->GetWidth(), engineContext.windowManager->GetHeight(), { 0.1,0.1,0.1,1 });
+
+    auto start = std::chrono::steady_clock::now();
+    objectManager.DrawAll(engineContext, cameraManager.GetActiveCamera());
+    auto end = std::chrono::steady_clock::now();
+
+    drawAllMsSum += std::chrono::duration<double, std::milli>(end - start).count();
+    if (++measuredFrames >= FRAMES_PER_REPORT)
+    {
+        UpdateStatsText();
+        SNAKE_LOG("[StaticBenchmark] static " << (isStatic ? "on" : "off") << ", sprite batching " << (isSpriteBatching ? "on" : "off") << ", DrawAll " << drawAllMsSum / measuredFrames << " ms");
+        drawAllMsSum = 0.0;
+        measuredFrames = 0;
+    }
+}
+
+void StaticBenchmark::Free(const EngineContext& engineContext)
+{
+    SNAKE_LOG("[StaticBenchmark] free called");
+    tiles.clear();
+}
+
+void StaticBenchmark::Unload(const EngineContext& engineContext)
+{
+    SNAKE_LOG("[StaticBenchmark] unload called");
+}
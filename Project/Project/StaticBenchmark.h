@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+
+#include "GameState.h"
+
+class GameObject;
+class TextObject;
+
+// 200k static sprites over a large world. Compares baked static chunks against the regular per-object path.
+// S toggles static baking, D toggles sprite batching of the regular path, K kills 1000 random sprites to force chunk rebuilds.
+class StaticBenchmark : public GameState
+{
+public:
+    void Load(const EngineContext& engineContext) override;
+    void Init(const EngineContext& engineContext) override;
+    void Update(float dt, const EngineContext& engineContext) override;
+    void Draw(const EngineContext& engineContext) override;
+    void Free(const EngineContext& engineContext) override;
+    void Unload(const EngineContext& engineContext) override;
+
+private:
+    void SetTilesStatic(bool shouldBeStatic);
+    void KillRandomTiles(size_t count);
+    void UpdateStatsText();
+
+    std::vector<GameObject*> tiles;
+    TextObject* statsText = nullptr;
+    bool isStatic = true;
+    bool isSpriteBatching = true;
+    size_t drawCallCount = 0;
+    float time = 0.0f;
+
+    double drawAllMsSum = 0.0;
+    int measuredFrames = 0;
+};
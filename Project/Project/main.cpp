@@ -1,3 +1,5 @@
+#include <chrono>
+#include <filesystem>
 #include <iostream>
 
 #include "Debug.h"
@@ -8,22 +10,53 @@
 #endif
 int main(int argc, char* argv[])
 {
+    const auto startupBegin = std::chrono::steady_clock::now();
     SNAKE_Engine snakeEngine;
 
     float multiplier = 1.5f;
-    int width = 800* multiplier;
-    int height = 480* multiplier;
+    EngineConfig config;
+    config.windowWidth = 800* multiplier;
+    config.windowHeight = 480* multiplier;
+    config.tickRate = 60.0;
+    config.shaderCacheDirectory = (std::filesystem::absolute(argv[0]).parent_path() / "ShaderCache").string();
+    DynamicResolutionSettings dynamicResolution;
+
+    for (; argc > 1; --argc)
+    {
+        const std::string flag = argv[argc - 1];
+        if (flag == "--render-thread")
+        {
+            config.useRenderThread = true;
+        }
+        else if (flag == "--null-backend")
+        {
+            config.backend = RenderBackend::Null;
+            config.frameLimit = 1000;
+        }
+        else if (flag == "--dynamic-resolution")
+        {
+            dynamicResolution.isEnabled = true;
+        }
+        else if (flag == "--no-shader-cache")
+        {
+            config.shaderCacheDirectory.clear();
+        }
+        else
+        {
+            break;
+        }
+    }
 
     try
     {
         if (argc == 3)
         {
-            width = std::stoi(argv[1]);
-            height = std::stoi(argv[2]);
+            config.windowWidth = std::stoi(argv[1]);
+            config.windowHeight = std::stoi(argv[2]);
         }
         else if (argc != 1)
         {
-            SNAKE_ERR("Usage: ./MyGame [width height]");
+            SNAKE_ERR("Usage: ./MyGame [width height] [--render-thread] [--null-backend] [--dynamic-resolution] [--no-shader-cache]");
             return -1;
         }
     }
@@ -33,12 +66,13 @@ int main(int argc, char* argv[])
         return -1;
     }
 
-    if (!snakeEngine.Init(width, height))
+    if (!snakeEngine.Init(config))
     {
         SNAKE_ERR("Engine initialization failed.");
         return -1;
     }
     snakeEngine.RenderDebugDraws(false);
+    snakeEngine.GetEngineContext().renderManager->SetDynamicResolution(dynamicResolution);
 
     snakeEngine.GetEngineContext().renderManager->RegisterMesh("default", std::vector<Vertex>{
         {{-0.5f, -0.5f, 0.f}, { 0.f, 0.f }}, // vertex 0
@@ -47,15 +81,23 @@ int main(int argc, char* argv[])
         { { -0.5f, 0.5f, 0.f }, { 0.f, 1.f } }  // vertex 3
     }, std::vector<unsigned int>{0, 1, 2, 2, 3, 0});
 
+    // Shaders compile in the background while the textures load; materials below wait for them.
+    snakeEngine.GetEngineContext().renderManager->RegisterShader("s_default", { {ShaderStage::Vertex,"Shaders/Default.vert"},{ShaderStage::Fragment,"Shaders/Default.frag"} });
+    snakeEngine.GetEngineContext().renderManager->RegisterShader("s_instancing", { {ShaderStage::Vertex,"Shaders/instancing.vert"},{ShaderStage::Fragment,"Shaders/instancing.frag"} });
+    snakeEngine.GetEngineContext().renderManager->RegisterShader("s_instancing_compact", { {ShaderStage::Vertex,"Shaders/InstancingCompact.vert"},{ShaderStage::Fragment,"Shaders/instancing.frag"} });
+    snakeEngine.GetEngineContext().renderManager->RegisterShader("s_instancing_resident", { {ShaderStage::Vertex,"Shaders/InstancingResident.vert"},{ShaderStage::Fragment,"Shaders/instancing.frag"} });
+    snakeEngine.GetEngineContext().renderManager->RegisterShader("s_instancing_resident_array", { {ShaderStage::Vertex,"Shaders/InstancingResidentArray.vert"},{ShaderStage::Fragment,"Shaders/InstancingArray.frag"} });
+    snakeEngine.GetEngineContext().renderManager->RegisterShader("s_animation", { {ShaderStage::Vertex,"Shaders/Animation.vert"},{ShaderStage::Fragment,"Shaders/Animation.frag"} });
+
     snakeEngine.GetEngineContext().renderManager->RegisterTexture("default", "Textures/Default.jpg");
     snakeEngine.GetEngineContext().renderManager->RegisterTexture("blueMButton", "Textures/blueMButton.png");
 	snakeEngine.GetEngineContext().renderManager->RegisterTexture("penguinSpritesheet", "Textures/penguin.png");
 
-    snakeEngine.GetEngineContext().renderManager->RegisterShader("s_default", { {ShaderStage::Vertex,"Shaders/Default.vert"},{ShaderStage::Fragment,"Shaders/Default.frag"} });
-    snakeEngine.GetEngineContext().renderManager->RegisterShader("s_instancing", { {ShaderStage::Vertex,"Shaders/instancing.vert"},{ShaderStage::Fragment,"Shaders/instancing.frag"} });
-    snakeEngine.GetEngineContext().renderManager->RegisterShader("s_animation", { {ShaderStage::Vertex,"Shaders/Animation.vert"},{ShaderStage::Fragment,"Shaders/Animation.frag"} });
+    snakeEngine.GetEngineContext().renderManager->SetSpriteBatchShader("s_default");
+    snakeEngine.GetEngineContext().renderManager->SetSpriteBatchShader("s_animation");
     snakeEngine.GetEngineContext().renderManager->RegisterMaterial("m_animation", "s_animation", { });
     snakeEngine.GetEngineContext().renderManager->RegisterMaterial("m_instancing", "s_instancing", { std::pair<std::string, std::string>("u_Texture","default") });
+    snakeEngine.GetEngineContext().renderManager->RegisterMaterial("m_instancing_compact", "s_instancing_compact", { std::pair<std::string, std::string>("u_Texture","default") });
     snakeEngine.GetEngineContext().renderManager->RegisterMaterial("m_blueMButton", "s_default", { std::pair<std::string, std::string>("u_Texture","blueMButton") });
 
     snakeEngine.GetEngineContext().renderManager->RegisterSpriteSheet("animTest", "penguinSpritesheet", 128, 128);
@@ -68,6 +110,7 @@ int main(int argc, char* argv[])
     snakeEngine.GetEngineContext().renderManager->RegisterRenderLayer("Bullet");
     snakeEngine.GetEngineContext().renderManager->RegisterRenderLayer("Penguin");
     snakeEngine.GetEngineContext().renderManager->RegisterRenderLayer("UI.Penguin");
+    snakeEngine.GetEngineContext().renderManager->GetRenderLayerManager().SetCached("Game.Background", true);
 
     snakeEngine.GetEngineContext().soundManager->LoadSound("bgm", "Sounds/test.mp3");
     snakeEngine.GetEngineContext().soundManager->LoadSound("click", "Sounds/mouse.mp3");
@@ -80,7 +123,19 @@ int main(int argc, char* argv[])
 
     snakeEngine.GetEngineContext().stateManager->ChangeState(std::make_unique<MainMenu>());
 
+    const ProgramCacheStats& shaderStats = ProgramCache::GetStats();
+    std::cout << "Startup: " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin).count() << " ms, shader programs: "
+        << shaderStats.loadedCount << " loaded from cache (" << shaderStats.loadMs << " ms), "
+        << shaderStats.compiledCount << " compiled (" << shaderStats.compileMs << " ms)" << std::endl;
+
     snakeEngine.Run();
 
+    if (config.backend == RenderBackend::Null)
+    {
+        const NullBackendStats& stats = NullBackend::GetStats();
+        std::cout << "GL calls: " << stats.callCount << ", draws: " << stats.drawCount << ", instances: " << stats.instanceCount
+            << ", uploaded: " << stats.bufferUploadBytes + stats.textureUploadBytes << " bytes" << std::endl;
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -40,12 +40,31 @@ float Camera2D::GetZoom() const
 
 glm::mat4 Camera2D::GetProjectionMatrix() const
 {
-    float halfW = static_cast<float>(screenWidth) * 0.5f / zoom;
-    float halfH = static_cast<float>(screenHeight) * 0.5f / zoom;
+    return BuildProjectionMatrix(position, zoom);
+}
+
+void Camera2D::StorePreviousPose()
+{
+    previousPosition = position;
+    previousZoom = zoom;
+    hasPreviousPose = true;
+}
+
+glm::mat4 Camera2D::GetInterpolatedProjectionMatrix(float alpha) const
+{
+    if (alpha >= 1.0f || !hasPreviousPose)
+        return GetProjectionMatrix();
+    return BuildProjectionMatrix(glm::mix(previousPosition, position, alpha), previousZoom + (zoom - previousZoom) * alpha);
+}
+
+glm::mat4 Camera2D::BuildProjectionMatrix(const glm::vec2& center, float scale) const
+{
+    float halfW = static_cast<float>(screenWidth) * 0.5f / scale;
+    float halfH = static_cast<float>(screenHeight) * 0.5f / scale;
 
     return glm::ortho(
-        -halfW + position.x, halfW + position.x,
-        -halfH + position.y, halfH + position.y,
+        -halfW + center.x, halfW + center.x,
+        -halfH + center.y, halfH + center.y,
         -1.0f, 1.0f
     );
 }
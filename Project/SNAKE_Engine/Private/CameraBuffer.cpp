@@ -0,0 +1,89 @@
+#include "CameraBuffer.h"
+#include "ext/matrix_clip_space.hpp"
+#include "gl.h"
+
+#include "Camera2D.h"
+#include "Debug.h"
+#include "GLState.h"
+
+CameraBuffer::~CameraBuffer()
+{
+    Free();
+}
+
+void CameraBuffer::Init()
+{
+    glCreateBuffers(1, &buffer);
+    glNamedBufferData(buffer, static_cast<GLsizeiptr>(MAX_VIEWS * sizeof(glm::mat4)), nullptr, GL_DYNAMIC_DRAW);
+    views.reserve(MAX_VIEWS);
+    matrices.reserve(MAX_VIEWS);
+}
+
+void CameraBuffer::BeginFrame(float interpolationAlpha)
+{
+    views.clear();
+    matrices.clear();
+    alpha = interpolationAlpha;
+}
+
+uint32_t CameraBuffer::GetViewIndex(const Camera2D* camera, bool screenSpace, const Camera2D* referenceCamera)
+{
+    View view{ nullptr, 0, 0 };
+    if (screenSpace || !camera)
+    {
+        view.screenWidth = referenceCamera->GetScreenWidth();
+        view.screenHeight = referenceCamera->GetScreenHeight();
+    }
+    else
+    {
+        view.camera = camera;
+    }
+
+    // Only a handful of views exist per frame, so a linear search beats hashing.
+    for (uint32_t i = 0; i < views.size(); ++i)
+    {
+        const View& existing = views[i];
+        if (existing.camera == view.camera && existing.screenWidth == view.screenWidth && existing.screenHeight == view.screenHeight)
+            return i;
+    }
+
+    if (views.size() == MAX_VIEWS)
+    {
+        if (!hasOverflowed)
+            SNAKE_ERR("More than " << MAX_VIEWS << " cameras drawn in one frame; the extra ones reuse the first view.");
+        hasOverflowed = true;
+        return 0;
+    }
+
+    views.push_back(view);
+    if (view.camera)
+    {
+        matrices.push_back(camera->GetInterpolatedProjectionMatrix(alpha));
+    }
+    else
+    {
+        const float halfWidth = static_cast<float>(view.screenWidth) / 2;
+        const float halfHeight = static_cast<float>(view.screenHeight) / 2;
+        matrices.push_back(glm::ortho(-halfWidth, halfWidth, -halfHeight, halfHeight));
+    }
+    return static_cast<uint32_t>(views.size() - 1);
+}
+
+void CameraBuffer::Upload()
+{
+    if (matrices.empty())
+        return;
+    glNamedBufferSubData(buffer, 0, static_cast<GLsizeiptr>(matrices.size() * sizeof(glm::mat4)), matrices.data());
+    GLState::BindBufferBase(GL_UNIFORM_BUFFER, BINDING, buffer);
+}
+
+void CameraBuffer::Free()
+{
+    if (buffer)
+    {
+        GLState::DeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+    views.clear();
+    matrices.clear();
+}
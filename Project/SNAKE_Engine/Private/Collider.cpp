@@ -67,21 +67,7 @@ bool CircleCollider::CheckPointCollision(const glm::vec2& point) const
 
 void CircleCollider::DrawDebug(RenderManager* rm, Camera2D* cam, const glm::vec4& color) const
 {
-    glm::vec2 center = owner->GetWorldPosition();
-    float r = GetRadius();
-    const int segments = 20;
-    const float angleStep = glm::two_pi<float>() / segments;
-
-    for (int i = 0; i < segments; ++i)
-    {
-        float angleA = i * angleStep;
-        float angleB = (i + 1) * angleStep;
-
-        glm::vec2 a = center + r * glm::vec2(std::cos(angleA), std::sin(angleA));
-        glm::vec2 b = center + r * glm::vec2(std::cos(angleB), std::sin(angleB));
-
-        rm->DrawDebugLine(a, b, cam, color);
-    }
+    rm->DrawDebugCircle(owner->GetWorldPosition(), GetRadius(), cam, color);
 }
 
 
@@ -147,16 +133,7 @@ void AABBCollider::SyncWithTransformScale()
 
 void AABBCollider::DrawDebug(RenderManager* rm, Camera2D* cam, const glm::vec4& color) const
 {
-    glm::vec2 center = owner->GetWorldPosition();
-    glm::vec2 half = GetHalfSize();
-
-    glm::vec2 min = center - half;
-    glm::vec2 max = center + half;
-
-    rm->DrawDebugLine({ min.x, min.y }, { max.x, min.y }, cam, color);
-    rm->DrawDebugLine({ max.x, min.y }, { max.x, max.y }, cam, color);
-    rm->DrawDebugLine({ max.x, max.y }, { min.x, max.y }, cam, color);
-    rm->DrawDebugLine({ min.x, max.y }, { min.x, min.y }, cam, color);
+    rm->DrawDebugRect(owner->GetWorldPosition(), GetHalfSize(), cam, color);
 }
 
 bool AABBCollider::DispatchAgainst(const CircleCollider& other) const
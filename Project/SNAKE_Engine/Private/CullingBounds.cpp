@@ -0,0 +1,52 @@
+#include "CullingBounds.h"
+
+#include "Object.h"
+
+void CullingBounds::Sync(const std::vector<Object*>& objects)
+{
+    const size_t count = objects.size();
+    x.resize(count);
+    y.resize(count);
+    radius.resize(count);
+    flags.resize(count);
+    syncStates.resize(count);
+
+    size_t refreshCount = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Object* obj = objects[i];
+        uint32_t objectFlags = 0;
+        if (obj->IsAlive() && obj->IsVisible())
+            objectFlags |= CullFlag::ACTIVE;
+        if (obj->ShouldIgnoreCamera())
+            objectFlags |= CullFlag::IGNORE_CAMERA;
+        flags[i] = objectFlags;
+
+        const Transform2D& transform = obj->GetTransform2D();
+        SyncState& state = syncStates[i];
+        // Versions are unique across all transforms, so a new object that lands on a dead one's slot
+        // and address never passes as unchanged.
+        if (state.object == obj && state.mesh == obj->GetMesh() && state.transformVersion == transform.GetVersion())
+            continue;
+
+        state.object = obj;
+        state.mesh = obj->GetMesh();
+        state.transformVersion = transform.GetVersion();
+
+        x[i] = transform.GetPosition().x;
+        y[i] = transform.GetPosition().y;
+        radius[i] = obj->GetBoundingRadius();
+        ++refreshCount;
+    }
+    lastRefreshCount = refreshCount;
+}
+
+void CullingBounds::Clear()
+{
+    x.clear();
+    y.clear();
+    radius.clear();
+    flags.clear();
+    syncStates.clear();
+    lastRefreshCount = 0;
+}
@@ -0,0 +1,138 @@
+#include "DebugRenderer.h"
+#include <cstring>
+#include "ext/matrix_clip_space.hpp"
+#include "gl.h"
+
+#include "Camera2D.h"
+#include "GLState.h"
+#include "Shader.h"
+
+namespace
+{
+    constexpr size_t INITIAL_STREAM_BYTES = 1 << 20;
+}
+
+DebugRenderer::~DebugRenderer()
+{
+    Free();
+}
+
+void DebugRenderer::Init()
+{
+    ringBuffer.Init(INITIAL_STREAM_BYTES);
+
+    glCreateVertexArrays(1, &vao);
+    glVertexArrayBindingDivisor(vao, 0, 1);
+
+    glEnableVertexArrayAttrib(vao, 0); // a, b
+    glVertexArrayAttribFormat(vao, 0, 4, GL_FLOAT, GL_FALSE, offsetof(DebugShapeInstance, a));
+    glVertexArrayAttribBinding(vao, 0, 0);
+
+    glEnableVertexArrayAttrib(vao, 1); // color
+    glVertexArrayAttribFormat(vao, 1, 4, GL_FLOAT, GL_FALSE, offsetof(DebugShapeInstance, color));
+    glVertexArrayAttribBinding(vao, 1, 0);
+
+    glEnableVertexArrayAttrib(vao, 2); // line width
+    glVertexArrayAttribFormat(vao, 2, 1, GL_FLOAT, GL_FALSE, offsetof(DebugShapeInstance, lineWidth));
+    glVertexArrayAttribBinding(vao, 2, 0);
+
+    glEnableVertexArrayAttrib(vao, 3); // shape
+    glVertexArrayAttribIFormat(vao, 3, 1, GL_UNSIGNED_INT, offsetof(DebugShapeInstance, shape));
+    glVertexArrayAttribBinding(vao, 3, 0);
+}
+
+void DebugRenderer::Add(Camera2D* camera, const DebugShapeInstance& shape)
+{
+    // Debug draws come in long runs from the same camera, so the last view is checked first.
+    if (lastViewIndex >= views.size() || views[lastViewIndex].camera != camera)
+    {
+        lastViewIndex = 0;
+        while (lastViewIndex < views.size() && views[lastViewIndex].camera != camera)
+            ++lastViewIndex;
+        if (lastViewIndex == views.size())
+            views.push_back({ camera, {} });
+    }
+    views[lastViewIndex].shapes.push_back(shape);
+}
+
+void DebugRenderer::Prepare(int screenWidth, int screenHeight, float interpolationAlpha)
+{
+    lastShapeCount = 0;
+    for (const View& view : views)
+        lastShapeCount += view.shapes.size();
+    if (lastShapeCount == 0)
+        return;
+
+    ringBuffer.BeginFrame();
+    for (View& view : views)
+    {
+        if (view.shapes.empty())
+            continue;
+
+        ViewDraw draw;
+        if (view.camera)
+        {
+            draw.projection = view.camera->GetInterpolatedProjectionMatrix(interpolationAlpha);
+            draw.pixelSize = 1.0f / view.camera->GetZoom();
+        }
+        else
+        {
+            const float halfWidth = static_cast<float>(screenWidth) / 2;
+            const float halfHeight = static_cast<float>(screenHeight) / 2;
+            draw.projection = glm::ortho(-halfWidth, halfWidth, -halfHeight, halfHeight);
+            draw.pixelSize = 1.0f;
+        }
+
+        const size_t bytes = view.shapes.size() * sizeof(DebugShapeInstance);
+        const RingAllocation data = ringBuffer.Allocate(bytes);
+        std::memcpy(data.data, view.shapes.data(), bytes);
+        draw.buffer = data.buffer;
+        draw.offset = data.offset;
+        draw.shapeCount = static_cast<uint32_t>(view.shapes.size());
+        viewDraws.push_back(draw);
+        view.shapes.clear();
+    }
+}
+
+void DebugRenderer::Draw(Shader* shader)
+{
+    if (viewDraws.empty())
+        return;
+
+    shader->Use();
+    GLState::BindVertexArray(vao);
+    for (const ViewDraw& draw : viewDraws)
+    {
+        shader->SendUniform("u_Projection", draw.projection);
+        shader->SendUniform("u_PixelSize", draw.pixelSize);
+        glVertexArrayVertexBuffer(vao, 0, draw.buffer, static_cast<GLintptr>(draw.offset), sizeof(DebugShapeInstance));
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(draw.shapeCount));
+    }
+    ringBuffer.SubmitFence();
+}
+
+void DebugRenderer::EndFrame()
+{
+    if (viewDraws.empty())
+        return;
+    viewDraws.clear();
+    ringBuffer.EndFrame();
+}
+
+void DebugRenderer::Clear()
+{
+    for (View& view : views)
+        view.shapes.clear();
+    lastShapeCount = 0;
+}
+
+void DebugRenderer::Free()
+{
+    if (vao)
+    {
+        GLState::DeleteVertexArray(vao);
+        vao = 0;
+    }
+    views.clear();
+    viewDraws.clear();
+}
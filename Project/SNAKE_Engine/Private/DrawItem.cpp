@@ -0,0 +1,53 @@
+#include "DrawItem.h"
+#include <array>
+
+void RadixSortDrawItems(std::vector<DrawItem>& items, std::vector<DrawItem>& scratch)
+{
+    constexpr int PASSES = 8;
+    constexpr int RADIX = 256;
+
+    const size_t count = items.size();
+    if (count < 2)
+        return;
+
+    std::array<std::array<uint32_t, RADIX>, PASSES> histograms{};
+    for (const DrawItem& item : items)
+    {
+        uint64_t key = item.key;
+        for (int pass = 0; pass < PASSES; ++pass)
+        {
+            ++histograms[pass][key & 0xFF];
+            key >>= 8;
+        }
+    }
+
+    scratch.resize(count);
+    DrawItem* src = items.data();
+    DrawItem* dst = scratch.data();
+
+    for (int pass = 0; pass < PASSES; ++pass)
+    {
+        auto& histogram = histograms[pass];
+        const int shift = pass * 8;
+
+        // Every key shares this byte: the pass would be an identity permutation.
+        if (histogram[(src[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (uint32_t& bucket : histogram)
+        {
+            uint32_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+            dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+        std::swap(src, dst);
+    }
+
+    if (src != items.data())
+        items.swap(scratch);
+}
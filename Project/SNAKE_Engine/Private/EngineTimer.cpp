@@ -3,16 +3,16 @@
 
 void EngineTimer::Start()
 {
-    lastTime = static_cast<float>(glfwGetTime());
-    fpsTimer = 0.0f;
+    lastCounter = glfwGetTimerValue();
+    fpsTimer = 0.0;
     frameCount = 0;
 }
 
-float EngineTimer::Tick()
+double EngineTimer::Tick()
 {
-    float now = static_cast<float>(glfwGetTime());
-    float dt = now - lastTime;
-    lastTime = now;
+    const uint64_t now = glfwGetTimerValue();
+    const double dt = static_cast<double>(now - lastCounter) / static_cast<double>(glfwGetTimerFrequency());
+    lastCounter = now;
 
     fpsTimer += dt;
     frameCount++;
@@ -21,10 +21,10 @@ float EngineTimer::Tick()
 
 bool EngineTimer::ShouldUpdateFPS(float& outFPS)
 {
-    if (fpsTimer >= 0.3f)
+    if (fpsTimer >= 0.3)
     {
-        outFPS = frameCount / fpsTimer;
-        fpsTimer = 0.0f;
+        outFPS = static_cast<float>(frameCount / fpsTimer);
+        fpsTimer = 0.0;
         frameCount = 0;
         return true;
     }
@@ -5,6 +5,7 @@
 #include "Debug.h"
 #include "EngineContext.h"
 #include "RenderManager.h"
+#include "RenderThread.h"
 #include "gl.h"
 
 static std::vector<char32_t> UTF8ToCodepoints(const std::string& text)
@@ -82,6 +83,7 @@ void Font::LoadFont(const std::string& path, uint32_t fontSize)
 
 void Font::BakeAtlas(RenderManager& renderManager)
 {
+    RenderThread::Sync();
     int texWidth = 512;
     int texHeight = 512;
     std::vector<unsigned char> pixels(texWidth * texHeight, 0);
@@ -233,6 +235,7 @@ glm::vec2 Font::GetTextSize(const std::string& text) const
 
 Mesh* Font::GenerateTextMesh(const std::string& text, TextAlignH alignH, TextAlignV alignV)
 {
+    RenderThread::Sync();
     std::vector<Vertex> vertices;
     std::vector<uint32_t> indices;
     uint32_t indexOffset = 0;
@@ -0,0 +1,263 @@
+#include "FrustumCuller.h"
+
+#include "Camera2D.h"
+#include "CullingBounds.h"
+#include "Object.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SNAKE_CULL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SNAKE_TARGET_SSE2
+#define SNAKE_TARGET_AVX2
+#else
+#define SNAKE_TARGET_SSE2 __attribute__((target("sse2")))
+#define SNAKE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define SNAKE_CULL_X86 0
+#endif
+
+namespace
+{
+    struct CullRect
+    {
+        float minX, maxX, minY, maxY;
+    };
+
+    struct CullInput
+    {
+        const float* x;
+        const float* y;
+        const float* radius;
+        const uint32_t* flags;
+    };
+
+    CullRect MakeCullRect(const Camera2D& camera, glm::vec2 viewportSize)
+    {
+        const glm::vec2 camPos = camera.GetPosition();
+        const glm::vec2 halfSize = viewportSize / camera.GetZoom() * 0.5f;
+        return { camPos.x - halfSize.x, camPos.x + halfSize.x, camPos.y - halfSize.y, camPos.y + halfSize.y };
+    }
+
+    size_t CullScalar(const CullRect& rect, const CullInput& in, size_t begin, size_t end, uint32_t* out)
+    {
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const float r = in.radius[i];
+            const bool inside = in.x[i] + r >= rect.minX && in.x[i] - r <= rect.maxX &&
+                in.y[i] + r >= rect.minY && in.y[i] - r <= rect.maxY;
+            const uint32_t flags = in.flags[i];
+            const bool visible = (flags & CullFlag::ACTIVE) && ((flags & CullFlag::IGNORE_CAMERA) || inside);
+
+            // Branchless compaction: always write, only advance when visible.
+            out[count] = static_cast<uint32_t>(i);
+            count += visible;
+        }
+        return count;
+    }
+
+#if SNAKE_CULL_X86
+    /// For every 8-bit lane mask: the indices of its set lanes packed to the front, and how many there are.
+    struct CompactTable
+    {
+        uint8_t lanes[256][8];
+        uint8_t counts[256];
+
+        constexpr CompactTable() : lanes{}, counts{}
+        {
+            for (int mask = 0; mask < 256; ++mask)
+            {
+                int count = 0;
+                for (int lane = 0; lane < 8; ++lane)
+                {
+                    if (mask & (1 << lane))
+                        lanes[mask][count++] = static_cast<uint8_t>(lane);
+                }
+                counts[mask] = static_cast<uint8_t>(count);
+            }
+        }
+    };
+    constexpr CompactTable COMPACT_TABLE{};
+
+    SNAKE_TARGET_SSE2 size_t CullSSE2(const CullRect& rect, const CullInput& in, size_t begin, size_t end, uint32_t* out)
+    {
+        const __m128 minX = _mm_set1_ps(rect.minX);
+        const __m128 maxX = _mm_set1_ps(rect.maxX);
+        const __m128 minY = _mm_set1_ps(rect.minY);
+        const __m128 maxY = _mm_set1_ps(rect.maxY);
+        const __m128i active = _mm_set1_epi32(static_cast<int>(CullFlag::ACTIVE));
+        const __m128i ignoreCamera = _mm_set1_epi32(static_cast<int>(CullFlag::IGNORE_CAMERA));
+
+        size_t count = 0;
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(in.x + i);
+            const __m128 y = _mm_loadu_ps(in.y + i);
+            const __m128 r = _mm_loadu_ps(in.radius + i);
+            const __m128 insideX = _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(x, r), minX), _mm_cmple_ps(_mm_sub_ps(x, r), maxX));
+            const __m128 insideY = _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(y, r), minY), _mm_cmple_ps(_mm_sub_ps(y, r), maxY));
+
+            const __m128i flags = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in.flags + i));
+            const __m128i isActive = _mm_cmpeq_epi32(_mm_and_si128(flags, active), active);
+            const __m128i isIgnored = _mm_cmpeq_epi32(_mm_and_si128(flags, ignoreCamera), ignoreCamera);
+            const __m128i visible = _mm_and_si128(isActive, _mm_or_si128(isIgnored, _mm_castps_si128(_mm_and_ps(insideX, insideY))));
+
+            const int mask = _mm_movemask_ps(_mm_castsi128_ps(visible));
+            const uint8_t* lanes = COMPACT_TABLE.lanes[mask];
+            out[count + 0] = static_cast<uint32_t>(i + lanes[0]);
+            out[count + 1] = static_cast<uint32_t>(i + lanes[1]);
+            out[count + 2] = static_cast<uint32_t>(i + lanes[2]);
+            out[count + 3] = static_cast<uint32_t>(i + lanes[3]);
+            count += COMPACT_TABLE.counts[mask];
+        }
+        return count + CullScalar(rect, in, i, end, out + count);
+    }
+
+    SNAKE_TARGET_AVX2 size_t CullAVX2(const CullRect& rect, const CullInput& in, size_t begin, size_t end, uint32_t* out)
+    {
+        const __m256 minX = _mm256_set1_ps(rect.minX);
+        const __m256 maxX = _mm256_set1_ps(rect.maxX);
+        const __m256 minY = _mm256_set1_ps(rect.minY);
+        const __m256 maxY = _mm256_set1_ps(rect.maxY);
+        const __m256i active = _mm256_set1_epi32(static_cast<int>(CullFlag::ACTIVE));
+        const __m256i ignoreCamera = _mm256_set1_epi32(static_cast<int>(CullFlag::IGNORE_CAMERA));
+
+        size_t count = 0;
+        size_t i = begin;
+        for (; i + 8 <= end; i += 8)
+        {
+            const __m256 x = _mm256_loadu_ps(in.x + i);
+            const __m256 y = _mm256_loadu_ps(in.y + i);
+            const __m256 r = _mm256_loadu_ps(in.radius + i);
+            const __m256 insideX = _mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(x, r), minX, _CMP_GE_OQ), _mm256_cmp_ps(_mm256_sub_ps(x, r), maxX, _CMP_LE_OQ));
+            const __m256 insideY = _mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(y, r), minY, _CMP_GE_OQ), _mm256_cmp_ps(_mm256_sub_ps(y, r), maxY, _CMP_LE_OQ));
+
+            const __m256i flags = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in.flags + i));
+            const __m256i isActive = _mm256_cmpeq_epi32(_mm256_and_si256(flags, active), active);
+            const __m256i isIgnored = _mm256_cmpeq_epi32(_mm256_and_si256(flags, ignoreCamera), ignoreCamera);
+            const __m256i visible = _mm256_and_si256(isActive, _mm256_or_si256(isIgnored, _mm256_castps_si256(_mm256_and_ps(insideX, insideY))));
+
+            // Widen the packed lane numbers of this mask and offset them by i: the 8 stored values start
+            // with the visible indices, and the rest is overwritten by the next iteration.
+            const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(visible));
+            const __m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(COMPACT_TABLE.lanes[mask])));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + count), _mm256_add_epi32(lanes, _mm256_set1_epi32(static_cast<int>(i))));
+            count += COMPACT_TABLE.counts[mask];
+        }
+        return count + CullScalar(rect, in, i, end, out + count);
+    }
+
+    CullPath DetectCullPath()
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        const bool hasSSE2 = (info[3] & (1 << 26)) != 0;
+        const bool hasOSXSave = (info[2] & (1 << 27)) != 0;
+        const bool hasAVX = (info[2] & (1 << 28)) != 0;
+
+        bool hasAVX2 = false;
+        // AVX2 also needs the OS to save YMM registers (XCR0 bits 1 and 2).
+        if (maxLeaf >= 7 && hasOSXSave && hasAVX && (_xgetbv(0) & 0x6) == 0x6)
+        {
+            __cpuidex(info, 7, 0);
+            hasAVX2 = (info[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        const bool hasSSE2 = __builtin_cpu_supports("sse2");
+        const bool hasAVX2 = __builtin_cpu_supports("avx2");
+#endif
+        if (hasAVX2)
+            return CullPath::AVX2;
+        if (hasSSE2)
+            return CullPath::SSE2;
+        return CullPath::Scalar;
+    }
+#else
+    CullPath DetectCullPath()
+    {
+        return CullPath::Scalar;
+    }
+#endif
+}
+
+bool FrustumCuller::IsVisible(const Camera2D& camera, Object* obj, glm::vec2 viewSize)
+{
+    if (!obj->IsAlive() || !obj->IsVisible())
+        return false;
+    if (obj->ShouldIgnoreCamera())
+        return true;
+
+    const glm::vec2& pos = obj->GetTransform2D().GetPosition();
+    return camera.IsInView(pos, obj->GetBoundingRadius(), viewSize);
+}
+
+void FrustumCuller::CullVisible(const Camera2D& camera, const std::vector<Object*>& allObjects,
+    std::vector<Object*>& outVisibleList, glm::vec2 viewportSize)
+{
+    outVisibleList.clear();
+    const glm::vec2 viewSize = viewportSize / camera.GetZoom();
+    for (Object* obj : allObjects)
+    {
+        if (IsVisible(camera, obj, viewSize))
+            outVisibleList.push_back(obj);
+    }
+}
+
+size_t FrustumCuller::CullBounds(const Camera2D& camera, const CullingBounds& bounds, glm::vec2 viewportSize,
+    size_t begin, size_t end, uint32_t* outIndices)
+{
+    return CullBounds(camera, bounds, viewportSize, begin, end, outIndices, GetBestCullPath());
+}
+
+size_t FrustumCuller::CullBounds(const Camera2D& camera, const CullingBounds& bounds, glm::vec2 viewportSize,
+    size_t begin, size_t end, uint32_t* outIndices, CullPath path)
+{
+    if (begin >= end)
+        return 0;
+
+    const CullRect rect = MakeCullRect(camera, viewportSize);
+    const CullInput input{ bounds.GetX(), bounds.GetY(), bounds.GetRadius(), bounds.GetFlags() };
+
+    if (path > GetBestCullPath())
+        path = GetBestCullPath();
+
+    switch (path)
+    {
+#if SNAKE_CULL_X86
+    case CullPath::AVX2:
+        return CullAVX2(rect, input, begin, end, outIndices);
+    case CullPath::SSE2:
+        return CullSSE2(rect, input, begin, end, outIndices);
+#endif
+    default:
+        return CullScalar(rect, input, begin, end, outIndices);
+    }
+}
+
+CullPath FrustumCuller::GetBestCullPath()
+{
+    static const CullPath bestPath = DetectCullPath();
+    return bestPath;
+}
+
+const char* FrustumCuller::GetCullPathName(CullPath path)
+{
+    switch (path)
+    {
+    case CullPath::AVX2:
+        return "AVX2";
+    case CullPath::SSE2:
+        return "SSE2";
+    default:
+        return "Scalar";
+    }
+}
@@ -0,0 +1,158 @@
+#include "GLState.h"
+#include <algorithm>
+#include <iterator>
+#include "gl.h"
+
+namespace
+{
+    // A binding that may hold anything, so the next bind is always issued.
+    constexpr GLuint UNKNOWN = ~0u;
+
+    struct TrackedState
+    {
+        GLuint program = UNKNOWN;
+        GLuint vertexArray = UNKNOWN;
+        GLuint arrayBuffer = UNKNOWN;
+        GLuint drawIndirectBuffer = UNKNOWN;
+        GLuint textureUnits[GLState::MAX_TEXTURE_UNITS];
+        GLuint storageBuffers[GLState::MAX_STORAGE_BINDINGS];
+
+        TrackedState()
+        {
+            std::fill(std::begin(textureUnits), std::end(textureUnits), UNKNOWN);
+            std::fill(std::begin(storageBuffers), std::end(storageBuffers), UNKNOWN);
+        }
+    };
+
+    TrackedState state;
+    GLStateStats stats;
+
+    // Updates one tracked binding; returns whether the call has to reach GL.
+    bool Change(GLuint& tracked, GLuint value)
+    {
+        if (tracked == value)
+        {
+            ++stats.suppressedCount;
+            return false;
+        }
+        tracked = value;
+        ++stats.issuedCount;
+        return true;
+    }
+
+    GLuint* FindBufferTarget(GLenum target)
+    {
+        switch (target)
+        {
+        case GL_ARRAY_BUFFER:         return &state.arrayBuffer;
+        case GL_DRAW_INDIRECT_BUFFER: return &state.drawIndirectBuffer;
+        }
+        return nullptr;
+    }
+
+    // GL unbinds a deleted name from every binding point of the current context.
+    void ForgetName(GLuint& tracked, GLuint name)
+    {
+        if (tracked == name)
+            tracked = 0;
+    }
+}
+
+void GLState::UseProgram(GLuint program)
+{
+    if (Change(state.program, program))
+        glUseProgram(program);
+}
+
+void GLState::BindVertexArray(GLuint vao)
+{
+    if (Change(state.vertexArray, vao))
+        glBindVertexArray(vao);
+}
+
+void GLState::BindTextureUnit(GLuint unit, GLuint texture)
+{
+    if (unit >= MAX_TEXTURE_UNITS)
+    {
+        ++stats.issuedCount;
+        ++stats.textureBindCount;
+        glBindTextureUnit(unit, texture);
+        return;
+    }
+    if (Change(state.textureUnits[unit], texture))
+    {
+        ++stats.textureBindCount;
+        glBindTextureUnit(unit, texture);
+    }
+}
+
+void GLState::BindBuffer(GLenum target, GLuint buffer)
+{
+    GLuint* tracked = FindBufferTarget(target);
+    if (!tracked)
+    {
+        ++stats.issuedCount;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (Change(*tracked, buffer))
+        glBindBuffer(target, buffer);
+}
+
+void GLState::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    if (target != GL_SHADER_STORAGE_BUFFER || index >= MAX_STORAGE_BINDINGS)
+    {
+        ++stats.issuedCount;
+        glBindBufferBase(target, index, buffer);
+        return;
+    }
+    if (Change(state.storageBuffers[index], buffer))
+        glBindBufferBase(target, index, buffer);
+}
+
+void GLState::DeleteProgram(GLuint program)
+{
+    // A current program is only flagged for deletion and stays in use, so its state is left as is.
+    glDeleteProgram(program);
+}
+
+void GLState::DeleteVertexArray(GLuint vao)
+{
+    glDeleteVertexArrays(1, &vao);
+    ForgetName(state.vertexArray, vao);
+}
+
+void GLState::DeleteTexture(GLuint texture)
+{
+    glDeleteTextures(1, &texture);
+    for (GLuint& unit : state.textureUnits)
+        ForgetName(unit, texture);
+}
+
+void GLState::DeleteBuffers(GLsizei count, const GLuint* buffers)
+{
+    glDeleteBuffers(count, buffers);
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        ForgetName(state.arrayBuffer, buffers[i]);
+        ForgetName(state.drawIndirectBuffer, buffers[i]);
+        for (GLuint& binding : state.storageBuffers)
+            ForgetName(binding, buffers[i]);
+    }
+}
+
+void GLState::Invalidate()
+{
+    state = TrackedState();
+}
+
+void GLState::ResetStats()
+{
+    stats = {};
+}
+
+const GLStateStats& GLState::GetStats()
+{
+    return stats;
+}
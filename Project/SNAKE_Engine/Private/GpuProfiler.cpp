@@ -0,0 +1,83 @@
+#include "GpuProfiler.h"
+#include <algorithm>
+#include "gl.h"
+
+GpuProfiler::~GpuProfiler()
+{
+    Free();
+}
+
+void GpuProfiler::Init()
+{
+    glCreateQueries(GL_TIME_ELAPSED, FRAME_COUNT * SCOPE_COUNT, &queries[0][0]);
+}
+
+void GpuProfiler::BeginFrame()
+{
+    currentFrame = (currentFrame + 1) % FRAME_COUNT;
+    Collect(currentFrame);
+}
+
+void GpuProfiler::BeginScope(int scope)
+{
+    if (!queries[0][0] || scope < 0 || scope >= SCOPE_COUNT || isPending[currentFrame][scope])
+        return;
+    glBeginQuery(GL_TIME_ELAPSED, queries[currentFrame][scope]);
+    isPending[currentFrame][scope] = true;
+    openScope = scope;
+}
+
+void GpuProfiler::EndScope()
+{
+    if (openScope < 0)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    openScope = -1;
+}
+
+void GpuProfiler::Collect(int frame)
+{
+    bool* pending = isPending[frame];
+    bool hasAny = false;
+    for (int scope = 0; scope < SCOPE_COUNT; ++scope)
+    {
+        if (!pending[scope])
+            continue;
+        hasAny = true;
+        GLint isAvailable = GL_FALSE;
+        glGetQueryObjectiv(queries[frame][scope], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        if (!isAvailable)
+        {
+            std::fill(pending, pending + SCOPE_COUNT, false);
+            return;
+        }
+    }
+    if (!hasAny)
+        return;
+
+    GpuTimings result;
+    for (int scope = 0; scope < SCOPE_COUNT; ++scope)
+    {
+        if (!pending[scope])
+            continue;
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries[frame][scope], GL_QUERY_RESULT, &nanoseconds);
+        const double ms = static_cast<double>(nanoseconds) / 1'000'000.0;
+        if (scope == DEBUG_SCOPE)
+            result.debugMs = ms;
+        else
+            result.layerMs[scope] = ms;
+        result.totalMs += ms;
+        pending[scope] = false;
+    }
+    timings = result;
+}
+
+void GpuProfiler::Free()
+{
+    if (queries[0][0])
+    {
+        glDeleteQueries(FRAME_COUNT * SCOPE_COUNT, &queries[0][0]);
+        std::fill(&queries[0][0], &queries[0][0] + FRAME_COUNT * SCOPE_COUNT, 0u);
+    }
+}
@@ -0,0 +1,178 @@
+#include "InstanceStore.h"
+#include <algorithm>
+#include "ext/matrix_transform.hpp"
+#include "gl.h"
+
+#include "GLState.h"
+#include "Object.h"
+
+InstanceStore::~InstanceStore()
+{
+    Free();
+}
+
+void InstanceStore::Init(uint32_t initialSlotCount)
+{
+    gpuSlotCount = std::max<uint32_t>(initialSlotCount, 1);
+    glCreateBuffers(1, &buffer);
+    glNamedBufferData(buffer, static_cast<GLsizeiptr>(gpuSlotCount * sizeof(ResidentInstance)), nullptr, GL_DYNAMIC_DRAW);
+
+    instances.reserve(gpuSlotCount);
+    slotStates.reserve(gpuSlotCount);
+}
+
+uint32_t InstanceStore::Update(Object* obj, float alpha)
+{
+    uint32_t slot = obj->instanceSlot;
+    bool isNew = false;
+    if (slot >= slotStates.size() || slotStates[slot].object != obj)
+    {
+        slot = AllocateSlot(obj);
+        obj->instanceSlot = slot;
+        isNew = true;
+    }
+
+    SlotState& state = slotStates[slot];
+    // An object drawn by several cameras only needs checking once per frame.
+    if (state.lastUsedFrame == frameIndex)
+        return slot;
+    state.lastUsedFrame = frameIndex;
+
+    const glm::vec4 uvRect = obj->GetUVRect();
+    const bool isInterpolating = alpha < 1.0f && obj->GetTransform2D().IsInterpolating();
+
+    if (isNew || isInterpolating || state.isInterpolated ||
+        state.transformVersion != obj->GetTransform2D().GetVersion() ||
+        state.color != obj->GetColor() ||
+        state.uvRect != uvRect ||
+        state.flip != obj->GetUVFlipVector())
+    {
+        state.uvRect = uvRect;
+        state.isInterpolated = isInterpolating;
+        WriteSlot(slot, obj, alpha);
+    }
+    return slot;
+}
+
+uint32_t InstanceStore::AllocateSlot(Object* obj)
+{
+    uint32_t slot;
+    if (!freeSlots.empty())
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32_t>(slotStates.size());
+        slotStates.emplace_back();
+        instances.emplace_back();
+    }
+
+    slotStates[slot] = {};
+    slotStates[slot].object = obj;
+    return slot;
+}
+
+void InstanceStore::WriteSlot(uint32_t slot, Object* obj, float alpha)
+{
+    SlotState& state = slotStates[slot];
+    state.transformVersion = obj->GetTransform2D().GetVersion();
+    state.color = obj->GetColor();
+    state.flip = obj->GetUVFlipVector();
+
+    const glm::mat4 model = obj->GetInterpolatedTransform2DMatrix(alpha) * glm::scale(glm::mat4(1.0f), glm::vec3(state.flip, 1.0f));
+    ResidentInstance& instance = instances[slot];
+    instance.affineRow0 = { model[0][0], model[1][0], model[3][0], 0.0f };
+    instance.affineRow1 = { model[0][1], model[1][1], model[3][1], 0.0f };
+    instance.color = state.color;
+    instance.uvRect = state.uvRect;
+
+    if (!state.isDirty)
+    {
+        state.isDirty = true;
+        dirtySlots.push_back(slot);
+    }
+}
+
+void InstanceStore::Upload()
+{
+    frameStats.dirtyCount = static_cast<uint32_t>(dirtySlots.size());
+
+    const uint32_t slotCount = static_cast<uint32_t>(slotStates.size());
+    if (slotCount > gpuSlotCount)
+    {
+        // Respecifying the storage orphans the old one, so every slot is sent again.
+        gpuSlotCount = std::max(slotCount, gpuSlotCount * 2);
+        glNamedBufferData(buffer, static_cast<GLsizeiptr>(gpuSlotCount * sizeof(ResidentInstance)), nullptr, GL_DYNAMIC_DRAW);
+        glNamedBufferSubData(buffer, 0, static_cast<GLsizeiptr>(slotCount * sizeof(ResidentInstance)), instances.data());
+        frameStats.uploadRanges = 1;
+        frameStats.uploadedBytes = slotCount * sizeof(ResidentInstance);
+    }
+    else if (!dirtySlots.empty())
+    {
+        std::sort(dirtySlots.begin(), dirtySlots.end());
+
+        // Slots in the gap of a merged range are resent unchanged from the CPU copy.
+        size_t rangeBegin = 0;
+        while (rangeBegin < dirtySlots.size())
+        {
+            size_t rangeEnd = rangeBegin + 1;
+            while (rangeEnd < dirtySlots.size() && dirtySlots[rangeEnd] - dirtySlots[rangeEnd - 1] <= MAX_MERGE_GAP)
+                ++rangeEnd;
+
+            const uint32_t first = dirtySlots[rangeBegin];
+            const size_t bytes = (dirtySlots[rangeEnd - 1] - first + 1) * sizeof(ResidentInstance);
+            glNamedBufferSubData(buffer, static_cast<GLintptr>(first * sizeof(ResidentInstance)), static_cast<GLsizeiptr>(bytes), &instances[first]);
+            ++frameStats.uploadRanges;
+            frameStats.uploadedBytes += bytes;
+
+            rangeBegin = rangeEnd;
+        }
+    }
+
+    for (uint32_t slot : dirtySlots)
+        slotStates[slot].isDirty = false;
+    dirtySlots.clear();
+
+    if (frameIndex % STALE_FRAME_COUNT == 0)
+        RecycleStaleSlots();
+
+    frameStats.residentCount = static_cast<uint32_t>(slotStates.size() - freeSlots.size());
+    lastFrameStats = frameStats;
+    frameStats = {};
+    ++frameIndex;
+}
+
+void InstanceStore::RecycleStaleSlots()
+{
+    // The owner is not told; it finds out on its next draw because the slot no longer points back at it.
+    for (uint32_t slot = 0; slot < slotStates.size(); ++slot)
+    {
+        SlotState& state = slotStates[slot];
+        if (state.object && frameIndex - state.lastUsedFrame >= STALE_FRAME_COUNT)
+        {
+            state.object = nullptr;
+            freeSlots.push_back(slot);
+        }
+    }
+}
+
+void InstanceStore::Bind() const
+{
+    GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING, buffer);
+}
+
+void InstanceStore::Free()
+{
+    if (buffer)
+    {
+        GLState::DeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+    gpuSlotCount = 0;
+    instances.clear();
+    slotStates.clear();
+    freeSlots.clear();
+    dirtySlots.clear();
+}
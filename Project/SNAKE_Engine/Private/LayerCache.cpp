@@ -0,0 +1,111 @@
+#include "LayerCache.h"
+#include "gl.h"
+
+#include "Debug.h"
+#include "GLState.h"
+#include "Shader.h"
+
+LayerCache::~LayerCache()
+{
+    Free();
+}
+
+void LayerCache::Init(Shader* compositeShader_)
+{
+    compositeShader = compositeShader_;
+    // The composite triangle is generated from gl_VertexID, but core profiles still need a VAO bound.
+    glCreateVertexArrays(1, &vertexArray);
+}
+
+bool LayerCache::Lookup(uint8_t layer, uint64_t signature, int width, int height)
+{
+    Target& target = targets[layer];
+    if (target.isValid && target.signature == signature && target.width == width && target.height == height)
+        return true;
+
+    if (target.width != width || target.height != height)
+    {
+        DeleteTarget(target);
+        CreateTarget(target, width, height);
+    }
+    target.signature = signature;
+    target.isValid = target.framebuffer != 0;
+    return false;
+}
+
+void LayerCache::Invalidate(uint8_t layer)
+{
+    if (layer < RenderLayerManager::MAX_LAYERS)
+        targets[layer].isValid = false;
+}
+
+void LayerCache::BindTarget(int layer, GLuint frameFramebuffer) const
+{
+    if (layer < 0)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, frameFramebuffer);
+        return;
+    }
+
+    const GLuint framebuffer = targets[layer].framebuffer;
+    const GLfloat transparent[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glClearNamedFramebufferfv(framebuffer, GL_COLOR, 0, transparent);
+}
+
+void LayerCache::Composite(uint8_t layer) const
+{
+    const Target& target = targets[layer];
+    if (!target.texture)
+        return;
+
+    compositeShader->Use();
+    GLState::BindTextureUnit(0, target.texture);
+    GLState::BindVertexArray(vertexArray);
+    glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void LayerCache::CreateTarget(Target& target, int width, int height)
+{
+    target.width = width;
+    target.height = height;
+    if (width <= 0 || height <= 0)
+        return;
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &target.texture);
+    glTextureStorage2D(target.texture, 1, GL_RGBA8, width, height);
+    glTextureParameteri(target.texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(target.texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glCreateFramebuffers(1, &target.framebuffer);
+    glNamedFramebufferTexture(target.framebuffer, GL_COLOR_ATTACHMENT0, target.texture, 0);
+    if (glCheckNamedFramebufferStatus(target.framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        SNAKE_ERR("Layer cache framebuffer (" << width << "x" << height << ") is incomplete; the layer is drawn uncached.");
+        DeleteTarget(target);
+        target.width = width;
+        target.height = height;
+    }
+}
+
+void LayerCache::DeleteTarget(Target& target)
+{
+    if (target.framebuffer)
+        glDeleteFramebuffers(1, &target.framebuffer);
+    if (target.texture)
+        GLState::DeleteTexture(target.texture);
+    target = Target();
+}
+
+void LayerCache::Free()
+{
+    for (Target& target : targets)
+        DeleteTarget(target);
+    if (vertexArray)
+    {
+        GLState::DeleteVertexArray(vertexArray);
+        vertexArray = 0;
+    }
+}
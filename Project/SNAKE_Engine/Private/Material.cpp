@@ -1,25 +1,37 @@
 #include "gl.h"
 #include "Material.h"
+#include <algorithm>
 #include "Mesh.h"
 #include "Shader.h"
 #include "Texture.h"
 #include "Debug.h"
 
-void Material::Bind() const
+namespace
 {
-    shader->Use();
-}
+    uint32_t nextMaterialSortID = 0;
 
-void Material::UnBind() const
-{
-    int unit = 0;
-    for (const auto& [uniformName, tex] : textures)
+    void UploadUniform(GLint location, const UniformValue& value)
     {
-        if (!tex) continue;
-        tex->UnBind(unit);
-        unit++;
+        std::visit([location](auto&& val)
+            {
+                using T = std::decay_t<decltype(val)>;
+                if constexpr (std::is_same_v<T, int>)            glUniform1i(location, val);
+                else if constexpr (std::is_same_v<T, float>)     glUniform1f(location, val);
+                else if constexpr (std::is_same_v<T, glm::vec2>) glUniform2fv(location, 1, &val[0]);
+                else if constexpr (std::is_same_v<T, glm::vec3>) glUniform3fv(location, 1, &val[0]);
+                else if constexpr (std::is_same_v<T, glm::vec4>) glUniform4fv(location, 1, &val[0]);
+                else if constexpr (std::is_same_v<T, glm::mat4>) glUniformMatrix4fv(location, 1, GL_FALSE, &val[0][0]);
+            }, value);
     }
-    shader->Unuse();
+}
+
+Material::Material(Shader* _shader) : shader(_shader), sortID(nextMaterialSortID++), isInstancingEnabled(false)
+{
+}
+
+void Material::Bind() const
+{
+    shader->Use();
 }
 
 bool Material::IsInstancingSupported() const
@@ -30,54 +42,73 @@ void Material::EnableInstancing(bool enable, Mesh* mesh)
 {
     if (shader && !shader->SupportsInstancing())
     {
-        SNAKE_WRN("Enable Instancing skipped: Tried enable instancing, but shader does not support 'i_Model'.");
+        SNAKE_WRN("Enable Instancing skipped: Tried enable instancing, but shader has none of 'i_Model', 'i_AffineRow0' or 'i_Slot'.");
         return;
     }
     if (!isInstancingEnabled)
     {
         isInstancingEnabled = enable;
-        if (mesh)
-        {
-            if (!instanceVBO[0])
-                glGenBuffers(4, instanceVBO);
-            mesh->SetupInstanceAttributes(instanceVBO);
-        }
+        if (mesh && shader)
+            mesh->SetupInstanceAttributes(shader->GetInstanceLayout());
     }
 }
 
-void Material::SendUniforms()
+void Material::SetTexture(std::string_view uniformName, Texture* texture)
 {
-    int unit = 0;
-    for (const auto& [uniformName, tex] : textures)
-    {
-        if (!tex) continue;
-        tex->BindToUnit(unit);
-        shader->SendUniform(uniformName, unit);
-        unit++;
-    }
+    const UniformID id = MakeUniformID(uniformName);
+    if (shader && shader->GetUniformLocation(id) == -1)
+        SNAKE_ERR("[Material] Texture uniform not found: " << uniformName);
+    SetTexture(id, texture);
+}
 
-    for (const auto& [name, value] : uniforms)
+void Material::SetTexture(UniformID uniformID, Texture* texture)
+{
+    for (TextureBinding& binding : textures)
     {
-        std::visit([&](auto&& val)
-            {
-                shader->SendUniform(name, val);
-            }, value);
+        if (binding.id == uniformID)
+        {
+            binding.texture = texture;
+            return;
+        }
     }
+    textures.push_back({ uniformID, shader ? shader->GetUniformLocation(uniformID) : -1, texture });
 }
 
-void Material::UpdateInstanceBuffer(const std::vector<glm::mat4>& transforms, const std::vector<glm::vec4>& colors, const std::vector<glm::vec2>& uvOffsets, const std::vector<glm::vec2>& uvScales) const
+void Material::SetUniform(std::string_view name, const UniformValue& value)
 {
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, transforms.size() * sizeof(glm::mat4), transforms.data(), GL_DYNAMIC_DRAW);
-
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO[1]);
-    glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(glm::vec4), colors.data(), GL_DYNAMIC_DRAW);
+    const UniformID id = MakeUniformID(name);
+    if (shader && shader->GetUniformLocation(id) == -1)
+        SNAKE_WRN("[Material] Uniform not found: " << name);
+    SetUniform(id, value);
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO[2]);
-    glBufferData(GL_ARRAY_BUFFER, uvOffsets.size() * sizeof(glm::vec2), uvOffsets.data(), GL_DYNAMIC_DRAW);
+void Material::SetUniform(UniformID id, const UniformValue& value)
+{
+    auto it = std::lower_bound(uniforms.begin(), uniforms.end(), id,
+        [](const UniformEntry& entry, UniformID key) { return entry.id < key; });
+    if (it != uniforms.end() && it->id == id)
+        it->value = value;
+    else
+        uniforms.insert(it, { id, shader ? shader->GetUniformLocation(id) : -1, value });
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO[3]);
-    glBufferData(GL_ARRAY_BUFFER, uvScales.size() * sizeof(glm::vec2), uvScales.data(), GL_DYNAMIC_DRAW);
+void Material::SendUniforms(const TextureBinding* textureBindings, size_t textureCount, const UniformEntry* uniformEntries, size_t uniformCount)
+{
+    int unit = 0;
+    for (size_t i = 0; i < textureCount; ++i)
+    {
+        const TextureBinding& binding = textureBindings[i];
+        if (!binding.texture) continue;
+        binding.texture->BindToUnit(unit);
+        if (binding.location != -1)
+            glUniform1i(binding.location, unit);
+        unit++;
+    }
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    for (size_t i = 0; i < uniformCount; ++i)
+    {
+        const UniformEntry& uniform = uniformEntries[i];
+        if (uniform.location != -1)
+            UploadUniform(uniform.location, uniform.value);
+    }
 }
@@ -1,8 +1,15 @@
 #include "Mesh.h"
 #include "gl.h"
 #include "glm.hpp"
+#include "GLState.h"
+#include "RenderThread.h"
 
 
+namespace
+{
+    uint32_t nextMeshSortID = 0;
+}
+
 GLenum ToGL(PrimitiveType type)
 {
     switch (type)
@@ -17,19 +24,30 @@ GLenum ToGL(PrimitiveType type)
     return GL_TRIANGLES;
 }
 
-Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, PrimitiveType primitiveType_) :vao(0), vbo(0), ebo(0), indexCount(0), useIndex(false), primitiveType(primitiveType_)
+Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, PrimitiveType primitiveType_) :sortID(nextMeshSortID++), vao(0), vbo(0), ebo(0), indexCount(0), useIndex(false), primitiveType(primitiveType_)
 {
+    RenderThread::Sync();
     SetupMesh(vertices, indices);
     ComputeLocalBounds(vertices);
+
+    if (primitiveType == PrimitiveType::Triangles && !vertices.empty())
+    {
+        bakeVertices = vertices;
+        bakeIndices = indices;
+        if (bakeIndices.empty())
+        {
+            bakeIndices.resize(vertices.size());
+            for (unsigned int i = 0; i < bakeIndices.size(); ++i)
+                bakeIndices[i] = i;
+        }
+    }
 }
 
 void Mesh::Draw() const
 {
-    glBindVertexArray(vao);
+    GLState::BindVertexArray(vao);
     GLenum mode = ToGL(primitiveType);
 
-    glBindVertexArray(vao);
-
     if (useIndex)
     {
         glDrawElements(mode, indexCount, GL_UNSIGNED_INT, 0);
@@ -42,7 +60,7 @@ void Mesh::Draw() const
 
 void Mesh::DrawInstanced(GLsizei instanceCount) const
 {
-    glBindVertexArray(vao);
+    GLState::BindVertexArray(vao);
     GLenum mode = ToGL(primitiveType);
 
     if (useIndex)
@@ -53,50 +71,135 @@ void Mesh::DrawInstanced(GLsizei instanceCount) const
 
 void Mesh::BindVAO() const
 {
-    glBindVertexArray(vao);
+    GLState::BindVertexArray(vao);
 }
 
 Mesh::~Mesh()
 {
-    if (ebo) glDeleteBuffers(1, &ebo);
-    if (vbo) glDeleteBuffers(1, &vbo);
-    if (vao) glDeleteVertexArrays(1, &vao);
+    RenderThread::Sync();
+    if (ebo) GLState::DeleteBuffers(1, &ebo);
+    if (vbo) GLState::DeleteBuffers(1, &vbo);
+    if (vao) GLState::DeleteVertexArray(vao);
 }
 
-void Mesh::SetupInstanceAttributes(GLuint* instanceVBO) const
+void Mesh::SetupInstanceAttributes(InstanceLayout layout) const
 {
-    GLuint loc;
-    glVertexArrayVertexBuffer(vao, 1, instanceVBO[0], 0, sizeof(glm::mat4));
+    RenderThread::Sync();
+    SetupInstanceAttributes(vao, layout, activeInstanceLayout, configuredInstanceLayouts);
+}
+
+void Mesh::SetupInstanceAttributes(GLuint vao, InstanceLayout layout, InstanceLayout& activeLayout, uint8_t& configuredLayouts)
+{
+    if (layout == InstanceLayout::None || layout == activeLayout)
+        return;
+
+    const uint8_t layoutBit = static_cast<uint8_t>(1u << static_cast<uint8_t>(layout));
+    if (!(configuredLayouts & layoutBit))
+    {
+        if (layout == InstanceLayout::Full)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                glVertexArrayAttribFormat(vao, FULL_MODEL_LOCATION + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4) * i);
+                glVertexArrayAttribBinding(vao, FULL_MODEL_LOCATION + i, 1);
+            }
+            glVertexArrayBindingDivisor(vao, 1, 1);
+
+            glVertexArrayAttribFormat(vao, 6, 4, GL_FLOAT, GL_FALSE, 0);
+            glVertexArrayAttribBinding(vao, 6, 2);
+            glVertexArrayBindingDivisor(vao, 2, 1);
+
+            glVertexArrayAttribFormat(vao, 7, 2, GL_FLOAT, GL_FALSE, 0);
+            glVertexArrayAttribBinding(vao, 7, 3);
+            glVertexArrayBindingDivisor(vao, 3, 1);
+
+            glVertexArrayAttribFormat(vao, 8, 2, GL_FLOAT, GL_FALSE, 0);
+            glVertexArrayAttribBinding(vao, 8, 4);
+            glVertexArrayBindingDivisor(vao, 4, 1);
+        }
+        else if (layout == InstanceLayout::Compact)
+        {
+            glVertexArrayAttribFormat(vao, 9, 3, GL_FLOAT, GL_FALSE, offsetof(CompactInstance, affineRow0));
+            glVertexArrayAttribFormat(vao, 10, 3, GL_FLOAT, GL_FALSE, offsetof(CompactInstance, affineRow1));
+            glVertexArrayAttribFormat(vao, 11, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(CompactInstance, color));
+            glVertexArrayAttribFormat(vao, 12, 4, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(CompactInstance, uvRect));
+            for (GLuint loc = COMPACT_FIRST_LOCATION; loc <= COMPACT_LAST_LOCATION; ++loc)
+                glVertexArrayAttribBinding(vao, loc, COMPACT_BINDING);
+            glVertexArrayBindingDivisor(vao, COMPACT_BINDING, 1);
+        }
+        else
+        {
+            glVertexArrayAttribIFormat(vao, RESIDENT_SLOT_LOCATION, 1, GL_UNSIGNED_INT, 0);
+            glVertexArrayAttribBinding(vao, RESIDENT_SLOT_LOCATION, RESIDENT_BINDING);
+            glVertexArrayBindingDivisor(vao, RESIDENT_BINDING, 1);
+        }
+
+        if (!configuredLayouts)
+        {
+            glVertexArrayAttribIFormat(vao, TEXTURE_LAYER_LOCATION, 1, GL_UNSIGNED_INT, 0);
+            glVertexArrayAttribBinding(vao, TEXTURE_LAYER_LOCATION, TEXTURE_LAYER_BINDING);
+            glVertexArrayBindingDivisor(vao, TEXTURE_LAYER_BINDING, 1);
+        }
+        configuredLayouts |= layoutBit;
+    }
+
+    // Materials with different layouts can share this mesh, so only the current layout's attributes stay enabled.
+    const auto setAttribsEnabled = [vao](GLuint first, GLuint last, bool enabled) {
+        for (GLuint loc = first; loc <= last; ++loc)
+            enabled ? glEnableVertexArrayAttrib(vao, loc) : glDisableVertexArrayAttrib(vao, loc);
+        };
+    setAttribsEnabled(FULL_MODEL_LOCATION, FULL_LAST_LOCATION, layout == InstanceLayout::Full);
+    setAttribsEnabled(COMPACT_FIRST_LOCATION, COMPACT_LAST_LOCATION, layout == InstanceLayout::Compact);
+    setAttribsEnabled(RESIDENT_SLOT_LOCATION, RESIDENT_SLOT_LOCATION, layout == InstanceLayout::Resident);
+
+    activeLayout = layout;
+}
+
+// Full instance data is laid out as four consecutive streams (mat4 model, vec4 color, vec2 uv offset, vec2 uv scale)
+// inside one ring buffer allocation, so each binding only needs its own offset into the same buffer.
+// Compact instance data is a single interleaved stream of CompactInstance.
+// Resident instance data is a stream of InstanceStore slot indices; the instances themselves live in the store.
+// Texture layers, when the shader reads them, follow the layout's streams as one uint per instance.
+void Mesh::BindInstanceStreams(InstanceLayout layout, GLuint buffer, size_t offset, GLsizei instanceCount, bool hasTextureLayers) const
+{
+    SetupInstanceAttributes(layout);
+    BindInstanceStreams(vao, layout, buffer, offset, instanceCount, hasTextureLayers);
+}
+
+void Mesh::BindInstanceStreams(GLuint vao, InstanceLayout layout, GLuint buffer, size_t offset, GLsizei instanceCount, bool hasTextureLayers)
+{
+    if (hasTextureLayers)
+    {
+        const size_t layerOffset = offset + static_cast<size_t>(instanceCount) * GetInstanceBytes(layout);
+        glVertexArrayVertexBuffer(vao, TEXTURE_LAYER_BINDING, buffer, static_cast<GLintptr>(layerOffset), TEXTURE_LAYER_BYTES);
+        glEnableVertexArrayAttrib(vao, TEXTURE_LAYER_LOCATION);
+    }
+    else
+    {
+        glDisableVertexArrayAttrib(vao, TEXTURE_LAYER_LOCATION);
+    }
+
+    if (layout == InstanceLayout::Resident)
+    {
+        glVertexArrayVertexBuffer(vao, RESIDENT_BINDING, buffer, static_cast<GLintptr>(offset), sizeof(uint32_t));
+        return;
+    }
 
-    for (int i = 0; i < 4; i++)
+    if (layout == InstanceLayout::Compact)
     {
-        loc = 2 + i;
-        glEnableVertexArrayAttrib(vao, loc);
-        glVertexArrayAttribFormat(vao, loc, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4) * i);
-        glVertexArrayAttribBinding(vao, loc, 1);
+        glVertexArrayVertexBuffer(vao, COMPACT_BINDING, buffer, static_cast<GLintptr>(offset), sizeof(CompactInstance));
+        return;
     }
-    glVertexArrayBindingDivisor(vao, 1, 1);
-
-    loc = 6;
-    glVertexArrayVertexBuffer(vao, 2, instanceVBO[1], 0, sizeof(glm::vec4));
-    glEnableVertexArrayAttrib(vao, loc);
-    glVertexArrayAttribFormat(vao, loc, 4, GL_FLOAT, GL_FALSE, 0);
-    glVertexArrayAttribBinding(vao, loc, 2);
-    glVertexArrayBindingDivisor(vao, 2, 1);
-
-    loc = 7;
-    glVertexArrayVertexBuffer(vao, 3, instanceVBO[2], 0, sizeof(glm::vec2));
-    glEnableVertexArrayAttrib(vao, loc);
-    glVertexArrayAttribFormat(vao, loc, 2, GL_FLOAT, GL_FALSE, 0);
-    glVertexArrayAttribBinding(vao, loc, 3);
-    glVertexArrayBindingDivisor(vao, 3, 1);
-
-    loc = 8;
-    glVertexArrayVertexBuffer(vao, 4, instanceVBO[3], 0, sizeof(glm::vec2));
-    glEnableVertexArrayAttrib(vao, loc);
-    glVertexArrayAttribFormat(vao, loc, 2, GL_FLOAT, GL_FALSE, 0);
-    glVertexArrayAttribBinding(vao, loc, 4);
-    glVertexArrayBindingDivisor(vao, 4, 1);
+
+    const size_t count = static_cast<size_t>(instanceCount);
+    const size_t colorOffset = offset + count * sizeof(glm::mat4);
+    const size_t uvOffsetOffset = colorOffset + count * sizeof(glm::vec4);
+    const size_t uvScaleOffset = uvOffsetOffset + count * sizeof(glm::vec2);
+
+    glVertexArrayVertexBuffer(vao, 1, buffer, static_cast<GLintptr>(offset), sizeof(glm::mat4));
+    glVertexArrayVertexBuffer(vao, 2, buffer, static_cast<GLintptr>(colorOffset), sizeof(glm::vec4));
+    glVertexArrayVertexBuffer(vao, 3, buffer, static_cast<GLintptr>(uvOffsetOffset), sizeof(glm::vec2));
+    glVertexArrayVertexBuffer(vao, 4, buffer, static_cast<GLintptr>(uvScaleOffset), sizeof(glm::vec2));
 }
 
 
@@ -113,15 +216,7 @@ void Mesh::SetupMesh(const std::vector<Vertex>& vertices, const std::vector<unsi
     glNamedBufferData(vbo, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
 
     // Bind VBO to VAO
-    glVertexArrayVertexBuffer(vao, 0, vbo, 0,  sizeof(Vertex));
-
-    glEnableVertexArrayAttrib(vao, 0); // position
-    glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, position));
-    glVertexArrayAttribBinding(vao, 0, 0);
-
-    glEnableVertexArrayAttrib(vao, 1); // uv
-    glVertexArrayAttribFormat(vao, 1, 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, uv));
-    glVertexArrayAttribBinding(vao, 1, 0);
+    SetupVertexFormat(vao, vbo);
 
     // EBO (Element Buffer)
     if (useIndex)
@@ -131,3 +226,16 @@ void Mesh::SetupMesh(const std::vector<Vertex>& vertices, const std::vector<unsi
         glVertexArrayElementBuffer(vao, ebo);
     }
 }
+
+void Mesh::SetupVertexFormat(GLuint vao, GLuint vbo)
+{
+    glVertexArrayVertexBuffer(vao, 0, vbo, 0, sizeof(Vertex));
+
+    glEnableVertexArrayAttrib(vao, 0); // position
+    glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, position));
+    glVertexArrayAttribBinding(vao, 0, 0);
+
+    glEnableVertexArrayAttrib(vao, 1); // uv
+    glVertexArrayAttribFormat(vao, 1, 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, uv));
+    glVertexArrayAttribBinding(vao, 1, 0);
+}
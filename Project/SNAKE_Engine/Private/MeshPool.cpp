@@ -0,0 +1,102 @@
+#include "MeshPool.h"
+#include <algorithm>
+#include "gl.h"
+
+#include "GLState.h"
+#include "Mesh.h"
+
+MeshPool::~MeshPool()
+{
+    Free();
+}
+
+void MeshPool::Init(size_t initialVertexCount, size_t initialIndexCount)
+{
+    vertexCapacity = std::max<size_t>(initialVertexCount, 1);
+    indexCapacity = std::max<size_t>(initialIndexCount, 1);
+
+    glCreateVertexArrays(1, &vao);
+    glCreateBuffers(1, &vbo);
+    glCreateBuffers(1, &ebo);
+    glNamedBufferData(vbo, static_cast<GLsizeiptr>(vertexCapacity * sizeof(Vertex)), nullptr, GL_STATIC_DRAW);
+    glNamedBufferData(ebo, static_cast<GLsizeiptr>(indexCapacity * sizeof(unsigned int)), nullptr, GL_STATIC_DRAW);
+
+    Mesh::SetupVertexFormat(vao, vbo);
+    glVertexArrayElementBuffer(vao, ebo);
+}
+
+void MeshPool::Reserve(size_t requiredVertexCount, size_t requiredIndexCount)
+{
+    if (requiredVertexCount > vertexCapacity)
+    {
+        const size_t newCapacity = std::max(requiredVertexCount, vertexCapacity * 2);
+        GLuint newVbo = 0;
+        glCreateBuffers(1, &newVbo);
+        glNamedBufferData(newVbo, static_cast<GLsizeiptr>(newCapacity * sizeof(Vertex)), nullptr, GL_STATIC_DRAW);
+        glCopyNamedBufferSubData(vbo, newVbo, 0, 0, static_cast<GLsizeiptr>(vertexCount * sizeof(Vertex)));
+        GLState::DeleteBuffers(1, &vbo);
+        vbo = newVbo;
+        vertexCapacity = newCapacity;
+        glVertexArrayVertexBuffer(vao, 0, vbo, 0, sizeof(Vertex));
+    }
+
+    if (requiredIndexCount > indexCapacity)
+    {
+        const size_t newCapacity = std::max(requiredIndexCount, indexCapacity * 2);
+        GLuint newEbo = 0;
+        glCreateBuffers(1, &newEbo);
+        glNamedBufferData(newEbo, static_cast<GLsizeiptr>(newCapacity * sizeof(unsigned int)), nullptr, GL_STATIC_DRAW);
+        glCopyNamedBufferSubData(ebo, newEbo, 0, 0, static_cast<GLsizeiptr>(indexCount * sizeof(unsigned int)));
+        GLState::DeleteBuffers(1, &ebo);
+        ebo = newEbo;
+        indexCapacity = newCapacity;
+        glVertexArrayElementBuffer(vao, ebo);
+    }
+}
+
+void MeshPool::Add(Mesh* mesh)
+{
+    if (!vao || !mesh || mesh->isPooled || !mesh->CanBeBaked())
+        return;
+
+    const std::vector<Vertex>& vertices = mesh->bakeVertices;
+    const std::vector<unsigned int>& indices = mesh->bakeIndices;
+    Reserve(vertexCount + vertices.size(), indexCount + indices.size());
+
+    glNamedBufferSubData(vbo, static_cast<GLintptr>(vertexCount * sizeof(Vertex)),
+        static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex)), vertices.data());
+    glNamedBufferSubData(ebo, static_cast<GLintptr>(indexCount * sizeof(unsigned int)),
+        static_cast<GLsizeiptr>(indices.size() * sizeof(unsigned int)), indices.data());
+
+    mesh->poolBaseVertex = static_cast<int32_t>(vertexCount);
+    mesh->poolFirstIndex = static_cast<uint32_t>(indexCount);
+    mesh->isPooled = true;
+    vertexCount += vertices.size();
+    indexCount += indices.size();
+}
+
+void MeshPool::BindVAO() const
+{
+    GLState::BindVertexArray(vao);
+}
+
+void MeshPool::BindInstanceStreams(InstanceLayout layout, GLuint buffer, size_t offset, GLsizei instanceCount, bool hasTextureLayers) const
+{
+    Mesh::SetupInstanceAttributes(vao, layout, activeInstanceLayout, configuredInstanceLayouts);
+    Mesh::BindInstanceStreams(vao, layout, buffer, offset, instanceCount, hasTextureLayers);
+}
+
+DrawElementsIndirectCommand MeshPool::MakeCommand(const Mesh* mesh, uint32_t instanceCount, uint32_t baseInstance)
+{
+    return { static_cast<uint32_t>(mesh->bakeIndices.size()), instanceCount, mesh->poolFirstIndex, mesh->poolBaseVertex, baseInstance };
+}
+
+void MeshPool::Free()
+{
+    if (ebo) GLState::DeleteBuffers(1, &ebo);
+    if (vbo) GLState::DeleteBuffers(1, &vbo);
+    if (vao) GLState::DeleteVertexArray(vao);
+    vao = vbo = ebo = 0;
+    vertexCapacity = vertexCount = 0;
+    indexCapacity = indexCount = 0;
+}
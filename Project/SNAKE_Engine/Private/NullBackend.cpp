@@ -0,0 +1,774 @@
+#include "NullBackend.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include "gl.h"
+
+namespace
+{
+    struct ProgramInfo
+    {
+        std::vector<GLuint> shaders;
+        std::vector<std::string> attributes;
+        std::vector<std::string> uniforms;
+        std::vector<std::string> uniformBlocks;
+        bool isLinked = false;
+    };
+
+    struct ShaderInfo
+    {
+        GLenum stage = 0;
+        std::string source;
+    };
+
+    bool isActive = false;
+    bool isRecording = false;
+    NullBackendStats stats;
+    std::vector<NullCommand> commands;
+
+    GLuint nextName = 1;
+    uintptr_t nextFence = 1;
+    std::unordered_map<GLuint, ShaderInfo> shaders;
+    std::unordered_map<GLuint, ProgramInfo> programs;
+    std::unordered_map<GLuint, std::vector<unsigned char>> mappedStorage;
+    std::unordered_map<GLuint, std::unordered_map<GLenum, GLint>> textureParameters;
+
+    void Record(const char* function, GLuint object = 0, size_t count = 0, size_t bytes = 0)
+    {
+        ++stats.callCount;
+        if (isRecording)
+            commands.push_back({ function, object, count, bytes });
+    }
+
+    void CreateNames(const char* function, GLsizei n, GLuint* names)
+    {
+        for (GLsizei i = 0; i < n; ++i)
+            names[i] = nextName++;
+        stats.createdCount += static_cast<size_t>(n);
+        Record(function, n > 0 ? names[0] : 0, static_cast<size_t>(n));
+    }
+
+    void DeleteNames(const char* function, GLsizei n, const GLuint* names)
+    {
+        for (GLsizei i = 0; i < n; ++i)
+        {
+            mappedStorage.erase(names[i]);
+            textureParameters.erase(names[i]);
+        }
+        stats.deletedCount += static_cast<size_t>(n);
+        Record(function, n > 0 ? names[0] : 0, static_cast<size_t>(n));
+    }
+
+    void RecordDraw(const char* function, size_t draws, size_t instances)
+    {
+        stats.drawCount += draws;
+        stats.instanceCount += instances;
+        Record(function, 0, instances);
+    }
+
+    void RecordBufferUpload(const char* function, GLuint buffer, GLsizeiptr size)
+    {
+        ++stats.bufferUploadCount;
+        stats.bufferUploadBytes += static_cast<size_t>(size);
+        Record(function, buffer, 1, static_cast<size_t>(size));
+    }
+
+    void RecordUniform(const char* function, GLsizei count)
+    {
+        ++stats.uniformCount;
+        Record(function, 0, static_cast<size_t>(count));
+    }
+
+    size_t BytesPerPixel(GLenum format)
+    {
+        switch (format)
+        {
+        case GL_RED:  return 1;
+        case GL_RG:   return 2;
+        case GL_RGB:  return 3;
+        }
+        return 4;
+    }
+
+    GLint DefaultTextureParameter(GLenum pname)
+    {
+        switch (pname)
+        {
+        case GL_TEXTURE_WRAP_S:
+        case GL_TEXTURE_WRAP_T:     return GL_REPEAT;
+        case GL_TEXTURE_MIN_FILTER: return GL_NEAREST_MIPMAP_LINEAR;
+        case GL_TEXTURE_MAG_FILTER: return GL_LINEAR;
+        }
+        return 0;
+    }
+
+    std::string StripCommentsAndDirectives(const std::string& source)
+    {
+        std::string result;
+        result.reserve(source.size());
+        for (size_t i = 0; i < source.size(); ++i)
+        {
+            if (source.compare(i, 2, "//") == 0 || source[i] == '#')
+            {
+                while (i < source.size() && source[i] != '\n')
+                    ++i;
+            }
+            else if (source.compare(i, 2, "/*") == 0)
+            {
+                const size_t end = source.find("*/", i + 2);
+                i = end == std::string::npos ? source.size() : end + 1;
+            }
+            else
+            {
+                result += source[i];
+            }
+        }
+        return result;
+    }
+
+    // Reflects the declarations a driver would report: vertex inputs, default-block uniforms and
+    // uniform block names. Each statement ends at ';' or '{'; its last identifier is the declared name.
+    void Reflect(const ShaderInfo& shader, ProgramInfo& program)
+    {
+        const std::string source = StripCommentsAndDirectives(shader.source);
+        std::vector<std::string> identifiers;
+        std::string identifier;
+        bool isArray = false;
+        int parenthesisDepth = 0;
+
+        auto addUnique = [](std::vector<std::string>& names, const std::string& name)
+            {
+                if (std::find(names.begin(), names.end(), name) == names.end())
+                    names.push_back(name);
+            };
+
+        for (char c : source)
+        {
+            if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+            {
+                identifier += c;
+                continue;
+            }
+            if (!identifier.empty() && parenthesisDepth == 0 && !std::isdigit(static_cast<unsigned char>(identifier[0])))
+                identifiers.push_back(identifier);
+            identifier.clear();
+
+            if (c == '(')
+                ++parenthesisDepth;
+            else if (c == ')')
+                parenthesisDepth = std::max(parenthesisDepth - 1, 0);
+            else if (c == '[')
+                isArray = true;
+            else if (c == ';' || c == '{' || c == '}')
+            {
+                const bool isUniform = std::find(identifiers.begin(), identifiers.end(), "uniform") != identifiers.end();
+                const bool isInput = std::find(identifiers.begin(), identifiers.end(), "in") != identifiers.end();
+                if (identifiers.size() >= 2)
+                {
+                    const std::string& name = identifiers.back();
+                    if (isUniform && c == '{')
+                        addUnique(program.uniformBlocks, name);
+                    else if (isUniform && c == ';')
+                        addUnique(program.uniforms, isArray ? name + "[0]" : name);
+                    else if (isInput && c == ';' && shader.stage == GL_VERTEX_SHADER)
+                        addUnique(program.attributes, name);
+                }
+                identifiers.clear();
+                isArray = false;
+            }
+        }
+    }
+
+    GLint IndexOf(const std::vector<std::string>& names, const GLchar* name)
+    {
+        const auto it = std::find(names.begin(), names.end(), name);
+        return it == names.end() ? -1 : static_cast<GLint>(it - names.begin());
+    }
+
+    const GLubyte* GLAD_API_PTR NullGetString(GLenum name)
+    {
+        Record("glGetString");
+        switch (name)
+        {
+        case GL_VERSION:                  return reinterpret_cast<const GLubyte*>("4.6.0 SNAKE Null");
+        case GL_SHADING_LANGUAGE_VERSION: return reinterpret_cast<const GLubyte*>("4.60");
+        case GL_VENDOR:                   return reinterpret_cast<const GLubyte*>("SNAKE_Engine");
+        case GL_RENDERER:                 return reinterpret_cast<const GLubyte*>("Null backend");
+        }
+        return reinterpret_cast<const GLubyte*>("");
+    }
+
+    const GLubyte* GLAD_API_PTR NullGetStringi(GLenum, GLuint)
+    {
+        Record("glGetStringi");
+        return reinterpret_cast<const GLubyte*>("");
+    }
+
+    // Reports 0 for every integer state, which also means no extensions.
+    void GLAD_API_PTR NullGetIntegerv(GLenum, GLint* data)
+    {
+        Record("glGetIntegerv");
+        *data = 0;
+    }
+
+    GLenum GLAD_API_PTR NullGetError() { return GL_NO_ERROR; }
+    void GLAD_API_PTR NullFlush() { Record("glFlush"); }
+    void GLAD_API_PTR NullFinish() { Record("glFinish"); }
+
+    void GLAD_API_PTR NullEnable(GLenum cap) { Record("glEnable", cap); }
+    void GLAD_API_PTR NullDisable(GLenum cap) { Record("glDisable", cap); }
+    void GLAD_API_PTR NullBlendFuncSeparate(GLenum, GLenum, GLenum, GLenum) { Record("glBlendFuncSeparate"); }
+    void GLAD_API_PTR NullClear(GLbitfield) { Record("glClear"); }
+    void GLAD_API_PTR NullClearColor(GLfloat, GLfloat, GLfloat, GLfloat) { Record("glClearColor"); }
+    void GLAD_API_PTR NullViewport(GLint, GLint, GLsizei, GLsizei) { Record("glViewport"); }
+    void GLAD_API_PTR NullScissor(GLint, GLint, GLsizei, GLsizei) { Record("glScissor"); }
+    void GLAD_API_PTR NullPixelStorei(GLenum, GLint) { Record("glPixelStorei"); }
+
+    void GLAD_API_PTR NullCreateBuffers(GLsizei n, GLuint* buffers) { CreateNames("glCreateBuffers", n, buffers); }
+    void GLAD_API_PTR NullCreateVertexArrays(GLsizei n, GLuint* arrays) { CreateNames("glCreateVertexArrays", n, arrays); }
+    void GLAD_API_PTR NullCreateTextures(GLenum, GLsizei n, GLuint* textures) { CreateNames("glCreateTextures", n, textures); }
+    void GLAD_API_PTR NullCreateQueries(GLenum, GLsizei n, GLuint* ids) { CreateNames("glCreateQueries", n, ids); }
+    void GLAD_API_PTR NullCreateFramebuffers(GLsizei n, GLuint* framebuffers) { CreateNames("glCreateFramebuffers", n, framebuffers); }
+    void GLAD_API_PTR NullDeleteBuffers(GLsizei n, const GLuint* buffers) { DeleteNames("glDeleteBuffers", n, buffers); }
+    void GLAD_API_PTR NullDeleteVertexArrays(GLsizei n, const GLuint* arrays) { DeleteNames("glDeleteVertexArrays", n, arrays); }
+    void GLAD_API_PTR NullDeleteTextures(GLsizei n, const GLuint* textures) { DeleteNames("glDeleteTextures", n, textures); }
+    void GLAD_API_PTR NullDeleteQueries(GLsizei n, const GLuint* ids) { DeleteNames("glDeleteQueries", n, ids); }
+    void GLAD_API_PTR NullDeleteFramebuffers(GLsizei n, const GLuint* framebuffers) { DeleteNames("glDeleteFramebuffers", n, framebuffers); }
+
+    void GLAD_API_PTR NullNamedFramebufferTexture(GLuint framebuffer, GLenum, GLuint, GLint) { Record("glNamedFramebufferTexture", framebuffer); }
+
+    GLenum GLAD_API_PTR NullCheckNamedFramebufferStatus(GLuint framebuffer, GLenum)
+    {
+        Record("glCheckNamedFramebufferStatus", framebuffer);
+        return GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    void GLAD_API_PTR NullBindFramebuffer(GLenum, GLuint framebuffer) { Record("glBindFramebuffer", framebuffer); }
+    void GLAD_API_PTR NullClearNamedFramebufferfv(GLuint framebuffer, GLenum, GLint, const GLfloat*) { Record("glClearNamedFramebufferfv", framebuffer); }
+
+    void GLAD_API_PTR NullNamedBufferData(GLuint buffer, GLsizeiptr size, const void* data, GLenum)
+    {
+        if (data)
+            RecordBufferUpload("glNamedBufferData", buffer, size);
+        else
+            Record("glNamedBufferData", buffer, 0, static_cast<size_t>(size));
+    }
+
+    void GLAD_API_PTR NullNamedBufferStorage(GLuint buffer, GLsizeiptr size, const void* data, GLbitfield)
+    {
+        if (data)
+            RecordBufferUpload("glNamedBufferStorage", buffer, size);
+        else
+            Record("glNamedBufferStorage", buffer, 0, static_cast<size_t>(size));
+    }
+
+    void GLAD_API_PTR NullNamedBufferSubData(GLuint buffer, GLintptr, GLsizeiptr size, const void*)
+    {
+        RecordBufferUpload("glNamedBufferSubData", buffer, size);
+    }
+
+    void GLAD_API_PTR NullCopyNamedBufferSubData(GLuint, GLuint writeBuffer, GLintptr, GLintptr, GLsizeiptr size)
+    {
+        RecordBufferUpload("glCopyNamedBufferSubData", writeBuffer, size);
+    }
+
+    void* GLAD_API_PTR NullMapNamedBufferRange(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield)
+    {
+        std::vector<unsigned char>& storage = mappedStorage[buffer];
+        storage.resize(std::max(storage.size(), static_cast<size_t>(offset + length)));
+        stats.mappedBytes += static_cast<size_t>(length);
+        Record("glMapNamedBufferRange", buffer, 1, static_cast<size_t>(length));
+        return storage.data() + offset;
+    }
+
+    GLboolean GLAD_API_PTR NullUnmapNamedBuffer(GLuint buffer)
+    {
+        mappedStorage.erase(buffer);
+        Record("glUnmapNamedBuffer", buffer);
+        return GL_TRUE;
+    }
+
+    void GLAD_API_PTR NullBindBuffer(GLenum, GLuint buffer)
+    {
+        ++stats.bufferBindCount;
+        Record("glBindBuffer", buffer);
+    }
+
+    void GLAD_API_PTR NullBindBufferBase(GLenum, GLuint, GLuint buffer)
+    {
+        ++stats.bufferBindCount;
+        Record("glBindBufferBase", buffer);
+    }
+
+    void GLAD_API_PTR NullBindVertexArray(GLuint array)
+    {
+        ++stats.vertexArrayBindCount;
+        Record("glBindVertexArray", array);
+    }
+
+    void GLAD_API_PTR NullVertexArrayVertexBuffer(GLuint vao, GLuint, GLuint, GLintptr, GLsizei) { Record("glVertexArrayVertexBuffer", vao); }
+    void GLAD_API_PTR NullVertexArrayElementBuffer(GLuint vao, GLuint) { Record("glVertexArrayElementBuffer", vao); }
+    void GLAD_API_PTR NullEnableVertexArrayAttrib(GLuint vao, GLuint) { Record("glEnableVertexArrayAttrib", vao); }
+    void GLAD_API_PTR NullDisableVertexArrayAttrib(GLuint vao, GLuint) { Record("glDisableVertexArrayAttrib", vao); }
+    void GLAD_API_PTR NullVertexArrayAttribFormat(GLuint vao, GLuint, GLint, GLenum, GLboolean, GLuint) { Record("glVertexArrayAttribFormat", vao); }
+    void GLAD_API_PTR NullVertexArrayAttribIFormat(GLuint vao, GLuint, GLint, GLenum, GLuint) { Record("glVertexArrayAttribIFormat", vao); }
+    void GLAD_API_PTR NullVertexArrayAttribBinding(GLuint vao, GLuint, GLuint) { Record("glVertexArrayAttribBinding", vao); }
+    void GLAD_API_PTR NullVertexArrayBindingDivisor(GLuint vao, GLuint, GLuint) { Record("glVertexArrayBindingDivisor", vao); }
+
+    void GLAD_API_PTR NullTextureStorage2D(GLuint texture, GLsizei, GLenum, GLsizei, GLsizei) { Record("glTextureStorage2D", texture); }
+    void GLAD_API_PTR NullTextureStorage3D(GLuint texture, GLsizei, GLenum, GLsizei, GLsizei, GLsizei) { Record("glTextureStorage3D", texture); }
+    void GLAD_API_PTR NullGenerateTextureMipmap(GLuint texture) { Record("glGenerateTextureMipmap", texture); }
+
+    void GLAD_API_PTR NullTextureSubImage2D(GLuint texture, GLint, GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum, const void*)
+    {
+        const size_t bytes = static_cast<size_t>(width) * static_cast<size_t>(height) * BytesPerPixel(format);
+        ++stats.textureUploadCount;
+        stats.textureUploadBytes += bytes;
+        Record("glTextureSubImage2D", texture, 1, bytes);
+    }
+
+    void GLAD_API_PTR NullCopyImageSubData(GLuint, GLenum, GLint, GLint, GLint, GLint, GLuint dstName, GLenum, GLint, GLint, GLint, GLint,
+        GLsizei width, GLsizei height, GLsizei depth)
+    {
+        const size_t bytes = static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth) * 4;
+        ++stats.textureUploadCount;
+        stats.textureUploadBytes += bytes;
+        Record("glCopyImageSubData", dstName, 1, bytes);
+    }
+
+    void GLAD_API_PTR NullGetTextureImage(GLuint texture, GLint, GLenum, GLenum, GLsizei bufSize, void* pixels)
+    {
+        std::memset(pixels, 0, static_cast<size_t>(bufSize));
+        Record("glGetTextureImage", texture, 1, static_cast<size_t>(bufSize));
+    }
+
+    void GLAD_API_PTR NullTextureParameteri(GLuint texture, GLenum pname, GLint param)
+    {
+        textureParameters[texture][pname] = param;
+        Record("glTextureParameteri", texture);
+    }
+
+    void GLAD_API_PTR NullGetTextureParameteriv(GLuint texture, GLenum pname, GLint* params)
+    {
+        const auto& parameters = textureParameters[texture];
+        const auto it = parameters.find(pname);
+        *params = it != parameters.end() ? it->second : DefaultTextureParameter(pname);
+        Record("glGetTextureParameteriv", texture);
+    }
+
+    void GLAD_API_PTR NullBindTextureUnit(GLuint, GLuint texture)
+    {
+        ++stats.textureBindCount;
+        Record("glBindTextureUnit", texture);
+    }
+
+    GLuint GLAD_API_PTR NullCreateShader(GLenum type)
+    {
+        const GLuint shader = nextName++;
+        shaders[shader].stage = type;
+        ++stats.createdCount;
+        Record("glCreateShader", shader, 1);
+        return shader;
+    }
+
+    void GLAD_API_PTR NullDeleteShader(GLuint shader)
+    {
+        shaders.erase(shader);
+        ++stats.deletedCount;
+        Record("glDeleteShader", shader, 1);
+    }
+
+    void GLAD_API_PTR NullShaderSource(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths)
+    {
+        std::string& source = shaders[shader].source;
+        source.clear();
+        for (GLsizei i = 0; i < count; ++i)
+        {
+            if (lengths && lengths[i] >= 0)
+                source.append(strings[i], static_cast<size_t>(lengths[i]));
+            else
+                source.append(strings[i]);
+        }
+        Record("glShaderSource", shader, 1, source.size());
+    }
+
+    void GLAD_API_PTR NullCompileShader(GLuint shader) { Record("glCompileShader", shader); }
+
+    void GLAD_API_PTR NullGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+    {
+        *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+        Record("glGetShaderiv", shader);
+    }
+
+    void GLAD_API_PTR NullGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        if (bufSize > 0)
+            infoLog[0] = '\0';
+        if (length)
+            *length = 0;
+        Record("glGetShaderInfoLog", shader);
+    }
+
+    GLuint GLAD_API_PTR NullCreateProgram()
+    {
+        const GLuint program = nextName++;
+        programs[program];
+        ++stats.createdCount;
+        Record("glCreateProgram", program, 1);
+        return program;
+    }
+
+    void GLAD_API_PTR NullDeleteProgram(GLuint program)
+    {
+        programs.erase(program);
+        ++stats.deletedCount;
+        Record("glDeleteProgram", program, 1);
+    }
+
+    void GLAD_API_PTR NullAttachShader(GLuint program, GLuint shader)
+    {
+        programs[program].shaders.push_back(shader);
+        Record("glAttachShader", program);
+    }
+
+    void GLAD_API_PTR NullDetachShader(GLuint program, GLuint shader)
+    {
+        std::vector<GLuint>& attached = programs[program].shaders;
+        attached.erase(std::remove(attached.begin(), attached.end(), shader), attached.end());
+        Record("glDetachShader", program);
+    }
+
+    void GLAD_API_PTR NullLinkProgram(GLuint program)
+    {
+        ProgramInfo& info = programs[program];
+        info.attributes.clear();
+        info.uniforms.clear();
+        info.uniformBlocks.clear();
+        for (GLuint shader : info.shaders)
+        {
+            const auto it = shaders.find(shader);
+            if (it != shaders.end())
+                Reflect(it->second, info);
+        }
+        info.isLinked = true;
+        Record("glLinkProgram", program);
+    }
+
+    void GLAD_API_PTR NullGetProgramiv(GLuint program, GLenum pname, GLint* params)
+    {
+        *params = pname == GL_LINK_STATUS && programs[program].isLinked ? GL_TRUE : 0;
+        Record("glGetProgramiv", program);
+    }
+
+    void GLAD_API_PTR NullProgramParameteri(GLuint program, GLenum, GLint)
+    {
+        Record("glProgramParameteri", program);
+    }
+
+    // No binary formats are reported, so binaries come out empty and every binary is rejected like a driver would.
+    void GLAD_API_PTR NullGetProgramBinary(GLuint program, GLsizei, GLsizei* length, GLenum* binaryFormat, void*)
+    {
+        if (length)
+            *length = 0;
+        *binaryFormat = 0;
+        Record("glGetProgramBinary", program);
+    }
+
+    void GLAD_API_PTR NullProgramBinary(GLuint program, GLenum, const void*, GLsizei length)
+    {
+        ProgramInfo& info = programs[program];
+        info.attributes.clear();
+        info.uniforms.clear();
+        info.uniformBlocks.clear();
+        info.isLinked = false;
+        Record("glProgramBinary", program, 0, static_cast<size_t>(length));
+    }
+
+    void GLAD_API_PTR NullGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        if (bufSize > 0)
+            infoLog[0] = '\0';
+        if (length)
+            *length = 0;
+        Record("glGetProgramInfoLog", program);
+    }
+
+    void GLAD_API_PTR NullUseProgram(GLuint program)
+    {
+        ++stats.programBindCount;
+        Record("glUseProgram", program);
+    }
+
+    GLint GLAD_API_PTR NullGetAttribLocation(GLuint program, const GLchar* name)
+    {
+        Record("glGetAttribLocation", program);
+        return IndexOf(programs[program].attributes, name);
+    }
+
+    GLuint GLAD_API_PTR NullGetUniformBlockIndex(GLuint program, const GLchar* name)
+    {
+        Record("glGetUniformBlockIndex", program);
+        const GLint index = IndexOf(programs[program].uniformBlocks, name);
+        return index == -1 ? GL_INVALID_INDEX : static_cast<GLuint>(index);
+    }
+
+    void GLAD_API_PTR NullUniformBlockBinding(GLuint program, GLuint, GLuint) { Record("glUniformBlockBinding", program); }
+
+    void GLAD_API_PTR NullGetProgramInterfaceiv(GLuint program, GLenum, GLenum pname, GLint* params)
+    {
+        const std::vector<std::string>& uniforms = programs[program].uniforms;
+        *params = 0;
+        if (pname == GL_ACTIVE_RESOURCES)
+            *params = static_cast<GLint>(uniforms.size());
+        else if (pname == GL_MAX_NAME_LENGTH)
+            for (const std::string& uniform : uniforms)
+                *params = std::max(*params, static_cast<GLint>(uniform.size() + 1));
+        Record("glGetProgramInterfaceiv", program);
+    }
+
+    // Uniform locations are the declaration order; only GL_LOCATION is queried.
+    void GLAD_API_PTR NullGetProgramResourceiv(GLuint program, GLenum, GLuint index, GLsizei propCount, const GLenum*, GLsizei count,
+        GLsizei* length, GLint* params)
+    {
+        const GLsizei written = std::min(propCount, count);
+        for (GLsizei i = 0; i < written; ++i)
+            params[i] = static_cast<GLint>(index);
+        if (length)
+            *length = written;
+        Record("glGetProgramResourceiv", program);
+    }
+
+    void GLAD_API_PTR NullGetProgramResourceName(GLuint program, GLenum, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name)
+    {
+        const std::vector<std::string>& uniforms = programs[program].uniforms;
+        const std::string uniform = index < uniforms.size() ? uniforms[index] : std::string();
+        const size_t copied = bufSize > 0 ? std::min(uniform.size(), static_cast<size_t>(bufSize - 1)) : 0;
+        if (bufSize > 0)
+        {
+            std::memcpy(name, uniform.data(), copied);
+            name[copied] = '\0';
+        }
+        if (length)
+            *length = static_cast<GLsizei>(copied);
+        Record("glGetProgramResourceName", program);
+    }
+
+    void GLAD_API_PTR NullUniform1i(GLint, GLint) { RecordUniform("glUniform1i", 1); }
+    void GLAD_API_PTR NullUniform1f(GLint, GLfloat) { RecordUniform("glUniform1f", 1); }
+    void GLAD_API_PTR NullUniform2fv(GLint, GLsizei count, const GLfloat*) { RecordUniform("glUniform2fv", count); }
+    void GLAD_API_PTR NullUniform3fv(GLint, GLsizei count, const GLfloat*) { RecordUniform("glUniform3fv", count); }
+    void GLAD_API_PTR NullUniform4fv(GLint, GLsizei count, const GLfloat*) { RecordUniform("glUniform4fv", count); }
+    void GLAD_API_PTR NullUniformMatrix4fv(GLint, GLsizei count, GLboolean, const GLfloat*) { RecordUniform("glUniformMatrix4fv", count); }
+
+    void GLAD_API_PTR NullDrawArrays(GLenum, GLint, GLsizei) { RecordDraw("glDrawArrays", 1, 1); }
+    void GLAD_API_PTR NullDrawElements(GLenum, GLsizei, GLenum, const void*) { RecordDraw("glDrawElements", 1, 1); }
+
+    void GLAD_API_PTR NullDrawArraysInstanced(GLenum, GLint, GLsizei, GLsizei instanceCount)
+    {
+        RecordDraw("glDrawArraysInstanced", 1, static_cast<size_t>(instanceCount));
+    }
+
+    void GLAD_API_PTR NullDrawElementsInstanced(GLenum, GLsizei, GLenum, const void*, GLsizei instanceCount)
+    {
+        RecordDraw("glDrawElementsInstanced", 1, static_cast<size_t>(instanceCount));
+    }
+
+    // The instance counts live in the indirect buffer, so each indirect draw counts as one instance.
+    void GLAD_API_PTR NullMultiDrawElementsIndirect(GLenum, GLenum, const void*, GLsizei drawCount, GLsizei)
+    {
+        RecordDraw("glMultiDrawElementsIndirect", static_cast<size_t>(drawCount), static_cast<size_t>(drawCount));
+    }
+
+    GLsync GLAD_API_PTR NullFenceSync(GLenum, GLbitfield)
+    {
+        ++stats.createdCount;
+        Record("glFenceSync", 0, 1);
+        return reinterpret_cast<GLsync>(nextFence++);
+    }
+
+    GLenum GLAD_API_PTR NullClientWaitSync(GLsync, GLbitfield, GLuint64)
+    {
+        Record("glClientWaitSync");
+        return GL_ALREADY_SIGNALED;
+    }
+
+    void GLAD_API_PTR NullDeleteSync(GLsync)
+    {
+        ++stats.deletedCount;
+        Record("glDeleteSync", 0, 1);
+    }
+
+    void GLAD_API_PTR NullBeginQuery(GLenum, GLuint id) { Record("glBeginQuery", id); }
+    void GLAD_API_PTR NullEndQuery(GLenum) { Record("glEndQuery"); }
+
+    void GLAD_API_PTR NullGetQueryObjectiv(GLuint id, GLenum pname, GLint* params)
+    {
+        *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+        Record("glGetQueryObjectiv", id);
+    }
+
+    void GLAD_API_PTR NullGetQueryObjectui64v(GLuint id, GLenum, GLuint64* params)
+    {
+        *params = 0;
+        Record("glGetQueryObjectui64v", id);
+    }
+
+    struct Stub
+    {
+        const char* name;
+        GLADapiproc proc;
+    };
+
+    template <typename Function>
+    GLADapiproc Proc(Function* function)
+    {
+        return reinterpret_cast<GLADapiproc>(function);
+    }
+
+    const Stub STUBS[] = {
+        { "glGetString", Proc(&NullGetString) },
+        { "glGetStringi", Proc(&NullGetStringi) },
+        { "glGetIntegerv", Proc(&NullGetIntegerv) },
+        { "glGetError", Proc(&NullGetError) },
+        { "glFlush", Proc(&NullFlush) },
+        { "glFinish", Proc(&NullFinish) },
+        { "glEnable", Proc(&NullEnable) },
+        { "glDisable", Proc(&NullDisable) },
+        { "glBlendFuncSeparate", Proc(&NullBlendFuncSeparate) },
+        { "glClear", Proc(&NullClear) },
+        { "glClearColor", Proc(&NullClearColor) },
+        { "glViewport", Proc(&NullViewport) },
+        { "glScissor", Proc(&NullScissor) },
+        { "glPixelStorei", Proc(&NullPixelStorei) },
+        { "glCreateBuffers", Proc(&NullCreateBuffers) },
+        { "glCreateVertexArrays", Proc(&NullCreateVertexArrays) },
+        { "glCreateTextures", Proc(&NullCreateTextures) },
+        { "glCreateQueries", Proc(&NullCreateQueries) },
+        { "glDeleteBuffers", Proc(&NullDeleteBuffers) },
+        { "glDeleteVertexArrays", Proc(&NullDeleteVertexArrays) },
+        { "glDeleteTextures", Proc(&NullDeleteTextures) },
+        { "glDeleteQueries", Proc(&NullDeleteQueries) },
+        { "glCreateFramebuffers", Proc(&NullCreateFramebuffers) },
+        { "glDeleteFramebuffers", Proc(&NullDeleteFramebuffers) },
+        { "glNamedFramebufferTexture", Proc(&NullNamedFramebufferTexture) },
+        { "glCheckNamedFramebufferStatus", Proc(&NullCheckNamedFramebufferStatus) },
+        { "glBindFramebuffer", Proc(&NullBindFramebuffer) },
+        { "glClearNamedFramebufferfv", Proc(&NullClearNamedFramebufferfv) },
+        { "glNamedBufferData", Proc(&NullNamedBufferData) },
+        { "glNamedBufferStorage", Proc(&NullNamedBufferStorage) },
+        { "glNamedBufferSubData", Proc(&NullNamedBufferSubData) },
+        { "glCopyNamedBufferSubData", Proc(&NullCopyNamedBufferSubData) },
+        { "glMapNamedBufferRange", Proc(&NullMapNamedBufferRange) },
+        { "glUnmapNamedBuffer", Proc(&NullUnmapNamedBuffer) },
+        { "glBindBuffer", Proc(&NullBindBuffer) },
+        { "glBindBufferBase", Proc(&NullBindBufferBase) },
+        { "glBindVertexArray", Proc(&NullBindVertexArray) },
+        { "glVertexArrayVertexBuffer", Proc(&NullVertexArrayVertexBuffer) },
+        { "glVertexArrayElementBuffer", Proc(&NullVertexArrayElementBuffer) },
+        { "glEnableVertexArrayAttrib", Proc(&NullEnableVertexArrayAttrib) },
+        { "glDisableVertexArrayAttrib", Proc(&NullDisableVertexArrayAttrib) },
+        { "glVertexArrayAttribFormat", Proc(&NullVertexArrayAttribFormat) },
+        { "glVertexArrayAttribIFormat", Proc(&NullVertexArrayAttribIFormat) },
+        { "glVertexArrayAttribBinding", Proc(&NullVertexArrayAttribBinding) },
+        { "glVertexArrayBindingDivisor", Proc(&NullVertexArrayBindingDivisor) },
+        { "glTextureStorage2D", Proc(&NullTextureStorage2D) },
+        { "glTextureStorage3D", Proc(&NullTextureStorage3D) },
+        { "glGenerateTextureMipmap", Proc(&NullGenerateTextureMipmap) },
+        { "glTextureSubImage2D", Proc(&NullTextureSubImage2D) },
+        { "glCopyImageSubData", Proc(&NullCopyImageSubData) },
+        { "glGetTextureImage", Proc(&NullGetTextureImage) },
+        { "glTextureParameteri", Proc(&NullTextureParameteri) },
+        { "glGetTextureParameteriv", Proc(&NullGetTextureParameteriv) },
+        { "glBindTextureUnit", Proc(&NullBindTextureUnit) },
+        { "glCreateShader", Proc(&NullCreateShader) },
+        { "glDeleteShader", Proc(&NullDeleteShader) },
+        { "glShaderSource", Proc(&NullShaderSource) },
+        { "glCompileShader", Proc(&NullCompileShader) },
+        { "glGetShaderiv", Proc(&NullGetShaderiv) },
+        { "glGetShaderInfoLog", Proc(&NullGetShaderInfoLog) },
+        { "glCreateProgram", Proc(&NullCreateProgram) },
+        { "glDeleteProgram", Proc(&NullDeleteProgram) },
+        { "glAttachShader", Proc(&NullAttachShader) },
+        { "glDetachShader", Proc(&NullDetachShader) },
+        { "glLinkProgram", Proc(&NullLinkProgram) },
+        { "glGetProgramiv", Proc(&NullGetProgramiv) },
+        { "glGetProgramInfoLog", Proc(&NullGetProgramInfoLog) },
+        { "glProgramParameteri", Proc(&NullProgramParameteri) },
+        { "glGetProgramBinary", Proc(&NullGetProgramBinary) },
+        { "glProgramBinary", Proc(&NullProgramBinary) },
+        { "glUseProgram", Proc(&NullUseProgram) },
+        { "glGetAttribLocation", Proc(&NullGetAttribLocation) },
+        { "glGetUniformBlockIndex", Proc(&NullGetUniformBlockIndex) },
+        { "glUniformBlockBinding", Proc(&NullUniformBlockBinding) },
+        { "glGetProgramInterfaceiv", Proc(&NullGetProgramInterfaceiv) },
+        { "glGetProgramResourceiv", Proc(&NullGetProgramResourceiv) },
+        { "glGetProgramResourceName", Proc(&NullGetProgramResourceName) },
+        { "glUniform1i", Proc(&NullUniform1i) },
+        { "glUniform1f", Proc(&NullUniform1f) },
+        { "glUniform2fv", Proc(&NullUniform2fv) },
+        { "glUniform3fv", Proc(&NullUniform3fv) },
+        { "glUniform4fv", Proc(&NullUniform4fv) },
+        { "glUniformMatrix4fv", Proc(&NullUniformMatrix4fv) },
+        { "glDrawArrays", Proc(&NullDrawArrays) },
+        { "glDrawElements", Proc(&NullDrawElements) },
+        { "glDrawArraysInstanced", Proc(&NullDrawArraysInstanced) },
+        { "glDrawElementsInstanced", Proc(&NullDrawElementsInstanced) },
+        { "glMultiDrawElementsIndirect", Proc(&NullMultiDrawElementsIndirect) },
+        { "glFenceSync", Proc(&NullFenceSync) },
+        { "glClientWaitSync", Proc(&NullClientWaitSync) },
+        { "glDeleteSync", Proc(&NullDeleteSync) },
+        { "glBeginQuery", Proc(&NullBeginQuery) },
+        { "glEndQuery", Proc(&NullEndQuery) },
+        { "glGetQueryObjectiv", Proc(&NullGetQueryObjectiv) },
+        { "glGetQueryObjectui64v", Proc(&NullGetQueryObjectui64v) },
+    };
+
+    GLADapiproc LoadStub(const char* name)
+    {
+        for (const Stub& stub : STUBS)
+        {
+            if (std::strcmp(stub.name, name) == 0)
+                return stub.proc;
+        }
+        return nullptr;
+    }
+}
+
+bool NullBackend::Load()
+{
+    isActive = gladLoadGL(LoadStub) != 0;
+    ResetStats();
+    return isActive;
+}
+
+bool NullBackend::IsActive()
+{
+    return isActive;
+}
+
+const NullBackendStats& NullBackend::GetStats()
+{
+    return stats;
+}
+
+void NullBackend::ResetStats()
+{
+    stats = NullBackendStats();
+}
+
+void NullBackend::SetRecording(bool shouldRecord)
+{
+    isRecording = shouldRecord;
+}
+
+const std::vector<NullCommand>& NullBackend::GetCommands()
+{
+    return commands;
+}
+
+void NullBackend::ClearCommands()
+{
+    commands.clear();
+}
@@ -75,6 +75,11 @@ glm::mat4 Object::GetTransform2DMatrix()
     return transform2D.GetMatrix();
 }
 
+glm::mat4 Object::GetInterpolatedTransform2DMatrix(float alpha)
+{
+    return transform2D.GetInterpolatedMatrix(alpha);
+}
+
 Transform2D& Object::GetTransform2D()
 {
     return transform2D;
@@ -150,6 +155,16 @@ glm::vec2 Object::GetUVFlipVector() const
     return { flipUV_X ? -1.0f : 1.0f, flipUV_Y ? -1.0f : 1.0f };
 }
 
+glm::vec4 Object::GetUVRect()
+{
+    // Animated objects draw from their sprite sheet's own texture, never from an atlas page.
+    if (HasAnimation())
+        return glm::vec4(GetAnimator()->GetUVOffset(), GetAnimator()->GetUVScale());
+    if (material)
+        return material->GetTextureUVRect();
+    return glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+}
+
 
 float Object::GetBoundingRadius() const
 {
@@ -33,7 +33,10 @@ void ObjectManager::InitAll(const EngineContext& engineContext)
         obj->Init(engineContext);
 
     for (const auto& obj : objects)
+    {
         obj->LateInit(engineContext);
+        obj->GetTransform2D().StorePreviousPose();
+    }
 }
 
 void ObjectManager::UpdateAll(float dt, const EngineContext& engineContext)
@@ -64,11 +67,19 @@ void ObjectManager::AddAllPendingObjects(const EngineContext& engineContext)
 
     for (auto& obj : tmp)
     {
+        // New objects appear where they were placed instead of sliding in from the origin.
         obj->LateInit(engineContext);
+        obj->GetTransform2D().StorePreviousPose();
         objects.push_back(std::move(obj));
     }
 }
 
+void ObjectManager::StorePreviousPoses()
+{
+    for (const auto& obj : objects)
+        obj->GetTransform2D().StorePreviousPose();
+}
+
 void ObjectManager::EraseDeadObjects(const EngineContext& engineContext)
 {
     std::vector<Object*> deadObjects;
@@ -99,7 +110,23 @@ void ObjectManager::EraseDeadObjects(const EngineContext& engineContext)
 
 void ObjectManager::DrawAll(const EngineContext& engineContext, Camera2D* camera)
 {
-    engineContext.renderManager->Submit(engineContext, rawPtrObjects, camera);
+    if (!camera)
+    {
+        engineContext.renderManager->Submit(engineContext, rawPtrObjects, camera);
+        return;
+    }
+
+    staticBatcher.Sync(rawPtrObjects, engineContext.renderManager->GetRenderLayerManager(), dynamicObjects);
+    engineContext.renderManager->Submit(engineContext, staticBatcher, camera);
+
+    if (useSpatialIndex)
+    {
+        visibilityGrid.Sync(dynamicObjects);
+        engineContext.renderManager->Submit(engineContext, dynamicObjects, visibilityGrid, camera);
+        return;
+    }
+    cullingBounds.Sync(dynamicObjects);
+    engineContext.renderManager->Submit(engineContext, dynamicObjects, cullingBounds, camera);
 }
 
 void ObjectManager::DrawObjects(const EngineContext& engineContext, Camera2D* camera, const std::vector<Object*>& objects)
@@ -125,6 +152,20 @@ void ObjectManager::FreeAll(const EngineContext& engineContext)
     objects.clear();
     objectMap.clear();
     rawPtrObjects.clear();
+    dynamicObjects.clear();
+    cullingBounds.Clear();
+    visibilityGrid.Clear();
+    staticBatcher.Clear();
+}
+
+void ObjectManager::SetUseSpatialIndex(bool shouldUse, float cellSize)
+{
+    useSpatialIndex = shouldUse;
+    visibilityGrid.SetCellSize(cellSize);
+    if (shouldUse)
+        cullingBounds.Clear();
+    else
+        visibilityGrid.Clear();
 }
 
 Object* ObjectManager::FindByTag(const std::string& tag) const
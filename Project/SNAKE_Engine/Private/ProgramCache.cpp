@@ -0,0 +1,180 @@
+#include "ProgramCache.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include "gl.h"
+
+#include "Debug.h"
+#include "Shader.h"
+
+namespace
+{
+    constexpr uint32_t BINARY_MAGIC = 0x42504E53; // "SNPB"
+    constexpr uint32_t BINARY_VERSION = 1;
+    constexpr uint32_t MAX_BINARY_BYTES = 64 * 1024 * 1024; // Far above any real program; anything larger is corrupt.
+
+    struct BinaryHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;     ///< Repeated in the file, so a renamed or colliding file is rejected.
+        uint32_t format;  ///< Driver-specific format reported by glGetProgramBinary.
+        uint32_t length;
+    };
+
+    std::string cacheDirectory;
+    int binaryFormatCount = -1; // Queried on first use.
+    ProgramCacheStats stats;
+
+    uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t HashString(uint64_t hash, const char* text)
+    {
+        // The terminator separates consecutive strings, so "ab"+"c" and "a"+"bc" differ.
+        return HashBytes(hash, text ? text : "", (text ? std::char_traits<char>::length(text) : 0) + 1);
+    }
+
+    std::filesystem::path GetBinaryPath(uint64_t key)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+        return std::filesystem::path(cacheDirectory) / name;
+    }
+}
+
+void ProgramCache::SetDirectory(const std::string& directory)
+{
+    cacheDirectory = directory;
+}
+
+const std::string& ProgramCache::GetDirectory()
+{
+    return cacheDirectory;
+}
+
+const ProgramCacheStats& ProgramCache::GetStats()
+{
+    return stats;
+}
+
+bool ProgramCache::IsEnabled()
+{
+    if (cacheDirectory.empty())
+        return false;
+    if (binaryFormatCount < 0)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count);
+        binaryFormatCount = count;
+        if (count == 0)
+            SNAKE_LOG("Driver supports no program binary formats; shaders are always compiled.");
+    }
+    return binaryFormatCount > 0;
+}
+
+uint64_t ProgramCache::MakeKey(const std::vector<ShaderStage>& stages, const std::vector<std::string>& sources)
+{
+    uint64_t hash = 14695981039346656037ull;
+    hash = HashString(hash, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+    hash = HashString(hash, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    hash = HashString(hash, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    for (size_t i = 0; i < stages.size(); ++i)
+    {
+        const int stage = static_cast<int>(stages[i]);
+        hash = HashBytes(hash, &stage, sizeof(stage));
+        hash = HashString(hash, sources[i].c_str());
+    }
+    return hash;
+}
+
+bool ProgramCache::Load(GLuint program, uint64_t key)
+{
+    const std::filesystem::path path = GetBinaryPath(key);
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::file_size(path, error);
+    if (error)
+        return false;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    // The length comes from disk, so it is checked against the file before anything is allocated.
+    BinaryHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != BINARY_MAGIC || header.version != BINARY_VERSION || header.key != key ||
+        header.length == 0 || header.length > MAX_BINARY_BYTES || header.length != fileSize - sizeof(header))
+    {
+        file.close();
+        SNAKE_WRN("Discarding corrupt program binary " << path.string());
+        std::filesystem::remove(path, error);
+        return false;
+    }
+
+    std::vector<char> binary(header.length);
+    file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+    if (!file)
+        return false;
+
+    glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+        SNAKE_LOG("Cached program binary " << path.string() << " was rejected by the driver; compiling.");
+    return success == GL_TRUE;
+}
+
+void ProgramCache::PrepareForStore(GLuint program)
+{
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ProgramCache::Store(GLuint program, uint64_t key)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    BinaryHeader header{ BINARY_MAGIC, BINARY_VERSION, key, 0, 0 };
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &header.format, binary.data());
+    header.length = static_cast<uint32_t>(written);
+
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+    std::ofstream file(GetBinaryPath(key), std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        SNAKE_WRN("Failed to write program binary to " << GetBinaryPath(key).string());
+        return;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), written);
+    if (file)
+        ++stats.storedCount;
+}
+
+void ProgramCache::RecordLink(bool wasLoaded, double ms)
+{
+    if (wasLoaded)
+    {
+        ++stats.loadedCount;
+        stats.loadMs += ms;
+    }
+    else
+    {
+        ++stats.compiledCount;
+        stats.compileMs += ms;
+    }
+}
@@ -1,5 +1,7 @@
 #include "RenderManager.h"
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include "ext/matrix_clip_space.hpp"
 #include "ext/matrix_transform.hpp"
 
@@ -11,149 +13,687 @@
 #include "Material.h"
 #include "InstanceBatchKey.h"
 #include "EngineContext.h"
+#include "GLState.h"
+#include "RenderThread.h"
+#include "SNAKE_Engine.h"
 #include "TextObject.h"
 #include "WindowManager.h"
 
 
+namespace
+{
+    constexpr UniformID U_PROJECTION = MakeUniformID("u_Projection");
+    constexpr UniformID U_CAMERA_INDEX = MakeUniformID("u_CameraIndex");
+    constexpr UniformID U_MODEL = MakeUniformID("u_Model");
+    constexpr UniformID U_COLOR = MakeUniformID("u_Color");
+    constexpr UniformID U_UV_OFFSET = MakeUniformID("u_UVOffset");
+    constexpr UniformID U_UV_SCALE = MakeUniformID("u_UVScale");
+    constexpr UniformID U_TEXTURE = MakeUniformID("u_Texture");
+
+    glm::mat4 ComputeInstanceModel(Object* obj, float alpha)
+    {
+        glm::vec2 flip = obj->GetUVFlipVector();
+        return obj->GetInterpolatedTransform2DMatrix(alpha) * glm::scale(glm::mat4(1.0f), glm::vec3(flip, 1.0f));
+    }
+
+    // Four consecutive streams: mat4 model, vec4 color, vec2 uv offset, vec2 uv scale.
+    void WriteFullInstances(const DrawItem* items, size_t count, float alpha, void* dst)
+    {
+        glm::mat4* transforms = static_cast<glm::mat4*>(dst);
+        glm::vec4* colors = reinterpret_cast<glm::vec4*>(transforms + count);
+        glm::vec2* uvOffsets = reinterpret_cast<glm::vec2*>(colors + count);
+        glm::vec2* uvScales = uvOffsets + count;
+        for (size_t i = 0; i < count; ++i)
+        {
+            Object* obj = items[i].object;
+            transforms[i] = ComputeInstanceModel(obj, alpha);
+
+            colors[i] = obj->GetColor();
+            const glm::vec4 uvRect = obj->GetUVRect();
+            uvOffsets[i] = { uvRect.x, uvRect.y };
+            uvScales[i] = { uvRect.z, uvRect.w };
+        }
+    }
+
+    // Per-run uniforms are taken from the run's first object, so only batches that agree on them are merged.
+    bool SharesRunUniforms(Object* a, Object* b)
+    {
+        if (a->ShouldIgnoreCamera() != b->ShouldIgnoreCamera())
+            return false;
+        if (a->ShouldIgnoreCamera() && a->GetReferenceCamera() != b->GetReferenceCamera())
+            return false;
+        const Texture* textureA = a->HasAnimation() ? a->GetAnimator()->GetTexture() : nullptr;
+        const Texture* textureB = b->HasAnimation() ? b->GetAnimator()->GetTexture() : nullptr;
+        return textureA == textureB;
+    }
+
+    uint8_t PackUnorm8(float value)
+    {
+        return static_cast<uint8_t>(glm::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    uint16_t PackUnorm16(float value)
+    {
+        return static_cast<uint16_t>(glm::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+    }
+
+    uint64_t HashCombine(uint64_t hash, uint64_t value)
+    {
+        return hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2));
+    }
+
+    uint64_t HashFloats(uint64_t hash, const float* values, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &values[i], sizeof(bits));
+            hash = HashCombine(hash, bits);
+        }
+        return hash;
+    }
+
+    uint64_t HashPointer(uint64_t hash, const void* pointer)
+    {
+        return HashCombine(hash, reinterpret_cast<uintptr_t>(pointer));
+    }
+
+    void WriteCompactInstances(const DrawItem* items, size_t count, float alpha, CompactInstance* dst)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Object* obj = items[i].object;
+            const glm::mat4 model = ComputeInstanceModel(obj, alpha);
+
+            // Build the whole instance locally: dst is write-combined mapped memory.
+            CompactInstance instance;
+            instance.affineRow0[0] = model[0][0];
+            instance.affineRow0[1] = model[1][0];
+            instance.affineRow0[2] = model[3][0];
+            instance.affineRow1[0] = model[0][1];
+            instance.affineRow1[1] = model[1][1];
+            instance.affineRow1[2] = model[3][1];
+
+            const glm::vec4& color = obj->GetColor();
+            instance.color[0] = PackUnorm8(color.r);
+            instance.color[1] = PackUnorm8(color.g);
+            instance.color[2] = PackUnorm8(color.b);
+            instance.color[3] = PackUnorm8(color.a);
+
+            const glm::vec4 uvRect = obj->GetUVRect();
+            instance.uvRect[0] = PackUnorm16(uvRect.x);
+            instance.uvRect[1] = PackUnorm16(uvRect.y);
+            instance.uvRect[2] = PackUnorm16(uvRect.z);
+            instance.uvRect[3] = PackUnorm16(uvRect.w);
+
+            dst[i] = instance;
+        }
+    }
+}
+
 void RenderManager::Submit(std::function<void()>&& drawFunc)
 {
-    renderQueue.push_back({ std::move(drawFunc) });
+    RenderCommand& cmd = commandBuffer.emplace_back();
+    cmd.type = RenderCommandType::UserCallback;
+    cmd.userCallback.callbackIndex = static_cast<uint32_t>(userCallbacks.size());
+    userCallbacks.push_back(std::move(drawFunc));
 }
 
 void RenderManager::Submit(const EngineContext& engineContext, const std::vector<Object*>& objects, Camera2D* camera)
 {
-    std::vector<Object*> visibleObjects;
-    if (camera)
+    const glm::vec2 viewportSize(engineContext.windowManager->GetWidth(), engineContext.windowManager->GetHeight());
+    const size_t objectCount = objects.size();
+
+    const size_t chunkCount = GetBuildChunkCount(objectCount);
+    if (chunkCount <= 1)
     {
-        FrustumCuller::CullVisible(*camera, objects, visibleObjects, glm::vec2(engineContext.windowManager->GetWidth(), engineContext.windowManager->GetHeight()));
-        BuildRenderMap(visibleObjects, camera);
+        BuildDrawItems(objects.data(), objectCount, camera, viewportSize, drawItems);
+        return;
     }
-    else
+
+    threadPool.ParallelFor(chunkCount, [&](size_t chunk) {
+        const size_t begin = objectCount * chunk / chunkCount;
+        const size_t end = objectCount * (chunk + 1) / chunkCount;
+        std::vector<DrawItem>& out = buildChunks[chunk].drawItems;
+        out.clear();
+        BuildDrawItems(objects.data() + begin, end - begin, camera, viewportSize, out);
+        });
+    MergeBuildChunks(chunkCount);
+}
+
+void RenderManager::Submit(const EngineContext& engineContext, const std::vector<Object*>& objects, const CullingBounds& bounds, Camera2D* camera)
+{
+    if (!camera || bounds.GetCount() != objects.size())
     {
-        BuildRenderMap(objects, camera);
+        Submit(engineContext, objects, camera);
+        return;
     }
+
+    const glm::vec2 viewportSize(engineContext.windowManager->GetWidth(), engineContext.windowManager->GetHeight());
+    const size_t objectCount = objects.size();
+
+    const size_t chunkCount = GetBuildChunkCount(objectCount);
+    if (chunkCount <= 1)
+    {
+        visibleIndices.resize(objectCount);
+        const size_t visibleCount = FrustumCuller::CullBounds(*camera, bounds, viewportSize, 0, objectCount, visibleIndices.data());
+        BuildDrawItems(objects.data(), visibleIndices.data(), visibleCount, camera, drawItems);
+        return;
+    }
+
+    threadPool.ParallelFor(chunkCount, [&](size_t chunk) {
+        const size_t begin = objectCount * chunk / chunkCount;
+        const size_t end = objectCount * (chunk + 1) / chunkCount;
+        BuildChunk& buildChunk = buildChunks[chunk];
+        buildChunk.visibleIndices.resize(end - begin);
+        buildChunk.drawItems.clear();
+        const size_t visibleCount = FrustumCuller::CullBounds(*camera, bounds, viewportSize, begin, end, buildChunk.visibleIndices.data());
+        BuildDrawItems(objects.data(), buildChunk.visibleIndices.data(), visibleCount, camera, buildChunk.drawItems);
+        });
+    MergeBuildChunks(chunkCount);
 }
 
-void FrustumCuller::CullVisible(const Camera2D& camera, const std::vector<Object*>& allObjects,
-    std::vector<Object*>& outVisibleList, glm::vec2 viewportSize)
+void RenderManager::Submit(const EngineContext& engineContext, const std::vector<Object*>& objects, const VisibilityGrid& grid, Camera2D* camera)
 {
-    outVisibleList.clear();
-    for (Object* obj : allObjects)
+    if (!camera)
     {
-        if (!obj->IsAlive() || !obj->IsVisible())
+        Submit(engineContext, objects, camera);
+        return;
+    }
+
+    const glm::vec2 viewportSize(engineContext.windowManager->GetWidth(), engineContext.windowManager->GetHeight());
+    grid.Query(*camera, viewportSize, visibleIndices);
+    BuildDrawItems(objects.data(), visibleIndices.data(), visibleIndices.size(), camera, drawItems);
+}
+
+void RenderManager::Submit(const EngineContext& engineContext, const StaticBatcher& batcher, Camera2D* camera)
+{
+    const glm::vec2 viewportSize(engineContext.windowManager->GetWidth(), engineContext.windowManager->GetHeight());
+    glm::vec2 viewMin(0.0f), viewMax(0.0f);
+    if (camera)
+    {
+        const glm::vec2 halfSize = viewportSize / camera->GetZoom() * 0.5f;
+        viewMin = camera->GetPosition() - halfSize;
+        viewMax = camera->GetPosition() + halfSize;
+    }
+
+    for (uint32_t chunkIndex = 0; chunkIndex < batcher.chunks.size(); ++chunkIndex)
+    {
+        const StaticBatcher::Chunk& chunk = batcher.chunks[chunkIndex];
+        if (chunk.indexCount == 0)
             continue;
-        if (obj->ShouldIgnoreCamera())
-        {
-            outVisibleList.push_back(obj);
+        if (!chunk.key.ignoreCamera && camera &&
+            (chunk.boundsMax.x < viewMin.x || chunk.boundsMin.x > viewMax.x ||
+             chunk.boundsMax.y < viewMin.y || chunk.boundsMin.y > viewMax.y))
+            continue;
+        if (chunk.key.layer >= RenderLayerManager::MAX_LAYERS)
             continue;
-        }
-        const glm::vec2& pos = obj->GetTransform2D().GetPosition();
-        float radius = obj->GetBoundingRadius();
 
-        if (camera.IsInView(pos, radius, viewportSize / camera.GetZoom()))
-            outVisibleList.push_back(obj);
+        const Material* material = chunk.key.material;
+        const uint64_t key = DrawKey::Make(chunk.key.layer, material->GetShader()->GetSortID(), material->GetSortID(), 0);
+        staticDrawItems.push_back({ key, &batcher, chunkIndex, camera });
     }
 }
 
+size_t RenderManager::GetBuildChunkCount(size_t objectCount)
+{
+    if (objectCount < PARALLEL_BUILD_THRESHOLD || threadPool.GetThreadCount() == 1)
+        return 1;
+
+    const size_t chunkCount = std::min<size_t>(threadPool.GetThreadCount() * CHUNKS_PER_THREAD,
+        (objectCount + MIN_OBJECTS_PER_CHUNK - 1) / MIN_OBJECTS_PER_CHUNK);
+    if (buildChunks.size() < chunkCount)
+        buildChunks.resize(chunkCount);
+    return chunkCount;
+}
+
+void RenderManager::MergeBuildChunks(size_t chunkCount)
+{
+    // Chunks are appended in order, so items keep their submission order for the stable sort.
+    size_t totalCount = drawItems.size();
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        totalCount += buildChunks[chunk].drawItems.size();
+    drawItems.reserve(totalCount);
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        drawItems.insert(drawItems.end(), buildChunks[chunk].drawItems.begin(), buildChunks[chunk].drawItems.end());
+}
+
+RenderManager::~RenderManager() = default;
+
 void RenderManager::FlushDrawCommands(const EngineContext& engineContext)
 {
-    SubmitRenderMap(engineContext);
-    for (const auto& cmd : renderQueue)
+    // Recording uploads instance and camera data, so the previous frame has to be done with them.
+    RenderThread::Sync();
+    // Shaders are normally all finished after loading, so the common frame skips the call entirely.
+    if (!pendingShaders.empty())
+        WaitForShaders();
+    interpolationAlpha = engineContext.engine->GetInterpolationAlpha();
+    instanceRingBuffer.BeginFrame();
+    if (statsOverlay)
+        SubmitStatsOverlay(engineContext);
+    SubmitDrawItems(engineContext);
+    instanceStore.Upload();
+    cameraBuffer.Upload();
+    PrepareDebugDraws(engineContext);
+    drawItems.clear();
+    staticDrawItems.clear();
+
+    // The buffers of the previous frame were emptied by FinishFrame and keep their capacity.
+    std::swap(commandBuffer, frameCommands);
+    std::swap(userCallbacks, frameCallbacks);
+    hasRecordedFrame = true;
+
+    isFrameResolved = RenderThread::IsRunning();
+    if (isFrameResolved)
     {
-        cmd();
+        ResolveCommands(engineContext);
+        return;
     }
-    for (auto& shdrMap : renderMap)
+    ExecuteFrame(engineContext);
+    FinishFrame();
+}
+
+void RenderManager::ExecuteFrame(const EngineContext& engineContext)
+{
+    if (!hasRecordedFrame)
+        return;
+
+    gpuProfiler.BeginFrame();
+    GLState::ResetStats();
+    ExecuteCommands(engineContext);
+    gpuProfiler.EndScope();
+    executedGLStats = GLState::GetStats();
+    instanceRingBuffer.SubmitFence();
+
+    if (debugShapeShader)
     {
-        shdrMap.clear();
+        gpuProfiler.BeginScope(GpuProfiler::DEBUG_SCOPE);
+        debugRenderer.Draw(debugShapeShader);
+        gpuProfiler.EndScope();
     }
-    renderQueue.clear();
+}
+
+void RenderManager::FinishFrame()
+{
+    if (!hasRecordedFrame)
+        return;
+    hasRecordedFrame = false;
+
+    instanceRingBuffer.EndFrame();
+    debugRenderer.EndFrame();
+
+    renderStats = recordedStats;
+    renderStats.stateChangeCount = executedGLStats.issuedCount;
+    renderStats.suppressedStateChangeCount = executedGLStats.suppressedCount;
+    renderStats.textureBindCount = executedGLStats.textureBindCount;
+    renderStats.uploadedBytes = instanceRingBuffer.GetLastFrameStats().bytesStreamed +
+        instanceStore.GetLastFrameStats().uploadedBytes + cameraBuffer.GetViewCount() * sizeof(glm::mat4);
+    gpuTimings = gpuProfiler.GetTimings();
+
+    frameCommands.clear();
+    frameCallbacks.clear();
 }
 
 void RenderManager::SetViewport(int x, int y, int width, int height)
 {
-    Submit([=]() {
-        glViewport(x, y, width, height);
-        });
+    RenderCommand& cmd = commandBuffer.emplace_back();
+    cmd.type = RenderCommandType::SetViewport;
+    cmd.setViewport = { x, y, width, height };
 }
 
 void RenderManager::ClearBackground(int x, int y, int width, int height, glm::vec4 color)
 {
-    Submit([=]() {
-        glEnable(GL_SCISSOR_TEST);
-        glScissor(x, y, width, height);
-        glClearColor(color.r, color.g, color.b, color.a);
-        glClear(GL_COLOR_BUFFER_BIT);
-        glDisable(GL_SCISSOR_TEST);
-        });
+    RenderCommand& cmd = commandBuffer.emplace_back();
+    cmd.type = RenderCommandType::Clear;
+    cmd.clear = { x, y, width, height, { color.r, color.g, color.b, color.a } };
 }
 
 void RenderManager::DrawDebugLine(const glm::vec2& from, const glm::vec2& to, Camera2D* camera, const glm::vec4& color, float lineWidth)
 {
-    debugLineMap[{camera, lineWidth}].push_back({ from, to, color, lineWidth });
+    debugRenderer.Add(camera, { from, to, color, lineWidth, DebugShape::Line });
 }
-void RenderManager::FlushDebugLineDrawCommands(const EngineContext& engineContext)
+
+void RenderManager::DrawDebugRect(const glm::vec2& center, const glm::vec2& halfSize, Camera2D* camera, const glm::vec4& color, float lineWidth)
 {
-    if (debugLineMap.empty())
-        return;
+    debugRenderer.Add(camera, { center, halfSize, color, lineWidth, DebugShape::Rect });
+}
 
-    if (!debugLineShader)
+void RenderManager::DrawDebugCircle(const glm::vec2& center, float radius, Camera2D* camera, const glm::vec4& color, float lineWidth)
+{
+    debugRenderer.Add(camera, { center, { radius, 0.0f }, color, lineWidth, DebugShape::Circle });
+}
+
+const DebugRenderer& RenderManager::GetDebugRenderer() const
+{
+    return debugRenderer;
+}
+
+void RenderManager::PrepareDebugDraws(const EngineContext& engineContext)
+{
+    if (!debugShapeShader)
     {
-        debugLineShader = GetShaderByTag("internal_debug_line");
-        if (!debugLineShader)
+        debugShapeShader = GetShaderByTag("internal_debug_shape");
+        if (!debugShapeShader)
         {
-            SNAKE_ERR("Missing internal_debug_line shader");
+            SNAKE_ERR("Missing internal_debug_shape shader");
             return;
         }
     }
 
-    debugLineShader->Use();
+    if (!engineContext.engine->ShouldRenderDebugDraws())
+    {
+        debugRenderer.Clear();
+        return;
+    }
+    debugRenderer.Prepare(engineContext.windowManager->GetWidth(), engineContext.windowManager->GetHeight(), interpolationAlpha);
+}
+
+
+RenderLayerManager& RenderManager::GetRenderLayerManager()
+{
+    return renderLayerManager;
+}
+
+const RingBufferStats& RenderManager::GetInstanceStreamStats() const
+{
+    return instanceRingBuffer.GetLastFrameStats();
+}
+
+const InstanceStoreStats& RenderManager::GetInstanceStoreStats() const
+{
+    return instanceStore.GetLastFrameStats();
+}
 
-    for (const auto& [camWidth, lines] : debugLineMap)
+void RenderManager::SetSubmissionMode(SubmissionMode mode)
+{
+    submissionMode = mode;
+}
+
+SubmissionMode RenderManager::GetSubmissionMode() const
+{
+    return submissionMode;
+}
+
+const MeshPool& RenderManager::GetMeshPool() const
+{
+    return meshPool;
+}
+
+const RenderStats& RenderManager::GetRenderStats() const
+{
+    return renderStats;
+}
+
+const GpuTimings& RenderManager::GetGpuTimings() const
+{
+    return gpuTimings;
+}
+
+void RenderManager::SetStatsOverlay(bool enable, const std::string& fontTag)
+{
+    if (!enable)
+    {
+        statsOverlay.reset();
+        return;
+    }
+    Font* font = GetFontByTag(fontTag);
+    if (!font)
     {
-        Camera2D* camera = camWidth.first;
-        float lineWidth = camWidth.second;
+        SNAKE_WRN("Stats overlay needs a font; \"" << fontTag << "\" is not registered.");
+        return;
+    }
+    statsOverlay = std::make_unique<TextObject>(font, "", TextAlignH::Left, TextAlignV::Top);
+    statsOverlay->GetTransform2D().SetScale({ 0.4f, 0.4f });
+    statsOverlay->SetIgnoreCamera(true, &statsOverlayCamera);
+    statsOverlayFrame = 0;
+}
 
-        glLineWidth(lineWidth);
+bool RenderManager::IsStatsOverlayEnabled() const
+{
+    return statsOverlay != nullptr;
+}
 
-        glm::mat4 proj = camera
-            ? camera->GetProjectionMatrix()
-            : glm::ortho(
-                -static_cast<float>(engineContext.windowManager->GetWidth()) / 2,
-                static_cast<float>(engineContext.windowManager->GetWidth()) / 2,
-                -static_cast<float>(engineContext.windowManager->GetHeight()) / 2,
-                static_cast<float>(engineContext.windowManager->GetHeight()) / 2
-            );
+void RenderManager::SetDynamicResolution(const DynamicResolutionSettings& settings)
+{
+    dynamicResolution = settings;
+}
 
-        debugLineShader->SendUniform("u_Projection", proj);
+const DynamicResolutionSettings& RenderManager::GetDynamicResolution() const
+{
+    return dynamicResolution;
+}
 
-        std::vector<float> vertexData;
-        vertexData.reserve(lines.size() * 12);
+float RenderManager::GetResolutionScale() const
+{
+    return dynamicResolution.isEnabled ? resolutionScaler.GetScale() : 1.0f;
+}
 
-        for (const auto& line : lines)
+void RenderManager::SubmitStatsOverlay(const EngineContext& engineContext)
+{
+    const int width = engineContext.windowManager->GetWidth();
+    const int height = engineContext.windowManager->GetHeight();
+    statsOverlayCamera.SetScreenSize(width, height);
+    statsOverlay->GetTransform2D().SetPosition({ -width / 2.0f + 10.0f, height / 2.0f - 10.0f });
+
+    // Every new text builds a mesh, so the numbers are only refreshed a few times per second.
+    if (statsOverlayFrame++ % STATS_OVERLAY_INTERVAL == 0)
+        statsOverlay->SetText(FormatStatsOverlay());
+
+    const size_t previousCount = drawItems.size();
+    AppendDrawItem(statsOverlay.get(), nullptr, drawItems);
+    if (drawItems.size() != previousCount)
+        drawItems.back().key |= DrawKey::Field(RenderLayerManager::MAX_LAYERS - 1, DrawKey::LAYER_BITS, DrawKey::LAYER_SHIFT);
+}
+
+std::string RenderManager::FormatStatsOverlay() const
+{
+    const GpuTimings& timings = gpuTimings;
+    char line[128];
+    std::string text;
+
+    std::snprintf(line, sizeof(line), "GPU %.2f ms (debug %.2f ms)\n", timings.totalMs, timings.debugMs);
+    text += line;
+    std::snprintf(line, sizeof(line), "draws %zu  batches %zu  instances %zu  (%s)\n",
+        renderStats.drawCallCount, renderStats.batchCount, renderStats.instanceCount,
+        submissionMode == SubmissionMode::MultiDrawIndirect ? "multi-draw indirect" : "direct");
+    text += line;
+    std::snprintf(line, sizeof(line), "binds %zu (%zu skipped)  textures %zu  uploaded %.1f KB",
+        renderStats.stateChangeCount, renderStats.suppressedStateChangeCount, renderStats.textureBindCount,
+        static_cast<double>(renderStats.uploadedBytes) / 1024.0);
+    text += line;
+    if (dynamicResolution.isEnabled)
+    {
+        std::snprintf(line, sizeof(line), "\nresolution %.0f%% (budget %.1f ms)", GetResolutionScale() * 100.0f, dynamicResolution.budgetMs);
+        text += line;
+    }
+
+    for (uint8_t layer = 0; layer < RenderLayerManager::MAX_LAYERS; ++layer)
+    {
+        if (timings.layerMs[layer] <= 0.0)
+            continue;
+        const std::string& name = renderLayerManager.idToName[layer];
+        std::snprintf(line, sizeof(line), "\n%s %.2f ms", name.empty() ? "overlay" : name.c_str(), timings.layerMs[layer]);
+        text += line;
+        if (renderLayerManager.IsCached(layer))
+        {
+            const LayerCacheStats& cache = renderLayerManager.GetCacheStats(layer);
+            std::snprintf(line, sizeof(line), "  cached %zu hit / %zu miss", cache.hitCount, cache.missCount);
+            text += line;
+        }
+    }
+    return text;
+}
+
+void RenderManager::SetSpriteBatchShader(const std::string& shaderTag, const std::string& batchShaderTag)
+{
+    RenderThread::Sync();
+    Shader* shader = GetShaderByTag(shaderTag);
+    Shader* batchShader = GetShaderByTag(batchShaderTag);
+    if (!shader || !batchShader)
+        return;
+    if (glGetAttribLocation(batchShader->GetProgramID(), "aColor") == -1)
+        SNAKE_WRN("Sprite batch shader \"" << batchShaderTag << "\" has no aColor attribute; batched objects lose their color.");
+    shader->spriteBatchShader = batchShader;
+}
+
+void RenderManager::SetSpriteBatching(bool enable)
+{
+    isSpriteBatchingEnabled = enable;
+}
+
+bool RenderManager::IsSpriteBatchingEnabled() const
+{
+    return isSpriteBatchingEnabled;
+}
+
+void RenderManager::MergeTextureArrays()
+{
+    std::vector<Material*> candidates;
+    for (const auto& [tag, material] : materialMap)
+    {
+        if (material->batchMaterial || !material->IsInstancingSupported() || !material->GetShader()->UsesTextureLayer())
+            continue;
+        if (material->textures.size() != 1 || !material->textures.front().texture)
         {
-            vertexData.insert(vertexData.end(), {
-                line.from.x, line.from.y, line.color.r, line.color.g, line.color.b, line.color.a,
-                line.to.x,   line.to.y,   line.color.r, line.color.g, line.color.b, line.color.a
-                });
+            SNAKE_WRN("Material \"" << tag << "\" not merged into a texture array: it needs exactly one texture.");
+            continue;
         }
+        candidates.push_back(material.get());
+    }
+    // materialMap is unordered; registration order keeps the layer assignment stable between runs.
+    std::sort(candidates.begin(), candidates.end(),
+        [](const Material* a, const Material* b) { return a->GetSortID() < b->GetSortID(); });
+
+    std::vector<bool> isMerged(candidates.size(), false);
+    std::vector<Material*> group;
+    std::vector<const Texture*> layers;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        if (isMerged[i])
+            continue;
 
-        glBindBuffer(GL_ARRAY_BUFFER, debugLineVBO);
-        glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_DYNAMIC_DRAW);
+        const Material* first = candidates[i];
+        const UniformID uniformID = first->textures.front().id;
+        const Texture* firstTexture = first->textures.front().texture;
+        group.clear();
+        layers.clear();
+        for (size_t j = i; j < candidates.size(); ++j)
+        {
+            Material* material = candidates[j];
+            const Texture* texture = material->textures.front().texture;
+            if (isMerged[j] || material->shader != first->shader || material->textures.front().id != uniformID || material->uniforms != first->uniforms ||
+                texture->GetWidth() != firstTexture->GetWidth() || texture->GetHeight() != firstTexture->GetHeight() ||
+                texture->GetChannels() != firstTexture->GetChannels())
+                continue;
+
+            // Materials sharing a texture also share its layer.
+            auto layer = std::find(layers.begin(), layers.end(), texture);
+            material->textureLayer = static_cast<uint32_t>(layer - layers.begin());
+            if (layer == layers.end())
+                layers.push_back(texture);
+            group.push_back(material);
+            isMerged[j] = true;
+        }
+
+        std::unique_ptr<Texture> array = Texture::CreateArray(layers);
+        if (!array)
+            continue;
 
-        glBindVertexArray(debugLineVAO);
-        glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(lines.size() * 2));
-        glBindVertexArray(0);
+        auto merged = std::make_unique<Material>(first->shader);
+        merged->SetTexture(uniformID, array.get());
+        merged->uniforms = first->uniforms;
+        merged->isInstancingEnabled = true;
+        for (Material* material : group)
+            material->batchMaterial = merged.get();
+
+        SNAKE_LOG("Merged " << group.size() << " materials into a " << array->GetWidth() << "x" << array->GetHeight()
+            << " texture array with " << layers.size() << " layers.");
+        textureArrays.push_back(std::move(array));
+        mergedMaterials.push_back(std::move(merged));
     }
+}
+
+void RenderManager::AddTextureToAtlas(const std::string& textureTag, const std::string& atlasGroup)
+{
+    Texture* texture = GetTextureByTag(textureTag);
+    if (!texture)
+        return;
 
-    glLineWidth(1.0f);
-    debugLineShader->Unuse();
-    debugLineMap.clear();
+    std::unique_ptr<TextureAtlas>& atlas = textureAtlases[atlasGroup];
+    if (!atlas)
+        atlas = std::make_unique<TextureAtlas>();
+    atlas->Add(texture);
 }
 
+void RenderManager::BuildTextureAtlases()
+{
+    RenderThread::Sync();
+    for (auto& [group, atlas] : textureAtlases)
+        atlas->Build();
 
-RenderLayerManager& RenderManager::GetRenderLayerManager()
+    const auto findRegion = [this](const Texture* texture) -> const AtlasRegion* {
+        for (const auto& [group, atlas] : textureAtlases)
+        {
+            if (const AtlasRegion* region = atlas->FindRegion(texture))
+                return region;
+        }
+        return nullptr;
+        };
+
+    std::vector<Material*> candidates;
+    for (const auto& [tag, material] : materialMap)
+    {
+        const Shader* shader = material->GetShader();
+        if (material->batchMaterial || material->textures.size() != 1 || shader->UsesTextureLayer() ||
+            !findRegion(material->textures.front().texture))
+            continue;
+        if (!material->IsInstancingSupported() && !shader->SupportsUVTransform())
+        {
+            SNAKE_WRN("Material \"" << tag << "\" keeps its own texture: its shader has no u_UVOffset/u_UVScale to draw an atlas sub-rect.");
+            continue;
+        }
+        candidates.push_back(material.get());
+    }
+    // materialMap is unordered; registration order keeps the batch materials stable between runs.
+    std::sort(candidates.begin(), candidates.end(),
+        [](const Material* a, const Material* b) { return a->GetSortID() < b->GetSortID(); });
+
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        const Material* first = candidates[i];
+        if (first->batchMaterial)
+            continue;
+
+        const UniformID uniformID = first->textures.front().id;
+        Texture* page = findRegion(first->textures.front().texture)->page;
+        auto merged = std::make_unique<Material>(first->shader);
+        merged->SetTexture(uniformID, page);
+        merged->uniforms = first->uniforms;
+        merged->isInstancingEnabled = first->isInstancingEnabled;
+
+        size_t memberCount = 0;
+        for (size_t j = i; j < candidates.size(); ++j)
+        {
+            Material* material = candidates[j];
+            const AtlasRegion* region = findRegion(material->textures.front().texture);
+            if (material->batchMaterial || material->shader != first->shader || material->textures.front().id != uniformID || region->page != page ||
+                material->isInstancingEnabled != first->isInstancingEnabled || material->uniforms != first->uniforms)
+                continue;
+
+            material->batchMaterial = merged.get();
+            material->textureUVRect = region->uvRect;
+            ++memberCount;
+        }
+
+        SNAKE_LOG("Merged " << memberCount << " materials onto a texture atlas page.");
+        mergedMaterials.push_back(std::move(merged));
+    }
+}
+
+const TextureAtlas* RenderManager::GetTextureAtlas(const std::string& atlasGroup) const
 {
-    return renderLayerManager;
+    auto it = textureAtlases.find(atlasGroup);
+    return it != textureAtlases.end() ? it->second.get() : nullptr;
 }
 
 void RenderManager::Init(const EngineContext& engineContext)
@@ -166,14 +706,18 @@ void RenderManager::Init(const EngineContext& engineContext)
 		layout (location = 1) in vec2 aUV;
 
 		uniform mat4 u_Model;
-		uniform mat4 u_Projection;
+		layout (std140) uniform CameraBlock
+		{
+		    mat4 u_ViewProjections[64];
+		};
+		uniform int u_CameraIndex;
 
 		out vec2 v_TexCoord;
 
 		void main()
 		{
 		    v_TexCoord = aUV;
-		    gl_Position = u_Projection * u_Model * vec4(aPos, 0.0, 1.0);
+		    gl_Position = u_ViewProjections[u_CameraIndex] * u_Model * vec4(aPos, 0.0, 1.0);
 		}
     )");
     shader->AttachFromSource(ShaderStage::Fragment, R"(
@@ -191,231 +735,983 @@ void RenderManager::Init(const EngineContext& engineContext)
 	        }
     )");
 
-    shader->Link();
+    shader->BeginLink();
+    pendingShaders.push_back(shader.get());
     shaderMap["internal_text"] = std::move(shader);
-    RegisterMaterial("internal_text", "internal_text", {});
 
 
     shader = std::make_unique<Shader>();
     shader->AttachFromSource(ShaderStage::Vertex, R"(
                 #version 330 core
-                layout (location = 0) in vec2 aPos;
+                layout (location = 0) in vec4 aPoints;
                 layout (location = 1) in vec4 aColor;
+                layout (location = 2) in float aLineWidth;
+                layout (location = 3) in uint aShape;
 
                 uniform mat4 u_Projection;
-                out vec4 vColor;
+                uniform float u_PixelSize;
+
+                out vec2 v_Local;
+                out vec2 v_Extent;
+                out float v_HalfWidth;
+                flat out uint v_Shape;
+                out vec4 v_Color;
 
                 void main()
                 {
-                    vColor = aColor;
-                    gl_Position = u_Projection * vec4(aPos, 0.0, 1.0);
+                    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+                    float halfWidth = aLineWidth * 0.5 * u_PixelSize;
+
+                    vec2 center = aPoints.xy;
+                    vec2 extent = aPoints.zw;
+                    vec2 axis = vec2(1.0, 0.0);
+                    if (aShape == 0u)
+                    {
+                        vec2 delta = aPoints.zw - aPoints.xy;
+                        float len = length(delta);
+                        center = (aPoints.xy + aPoints.zw) * 0.5;
+                        axis = len > 0.0 ? delta / len : axis;
+                        extent = vec2(len * 0.5, 0.0);
+                    }
+                    else if (aShape == 2u)
+                    {
+                        extent = vec2(aPoints.z);
+                    }
+
+                    // One extra pixel around the stroke leaves room for the antialiased edge.
+                    vec2 local = corner * (extent + halfWidth + u_PixelSize);
+                    vec2 world = center + axis * local.x + vec2(-axis.y, axis.x) * local.y;
+
+                    v_Local = local;
+                    v_Extent = extent;
+                    v_HalfWidth = halfWidth;
+                    v_Shape = aShape;
+                    v_Color = aColor;
+                    gl_Position = u_Projection * vec4(world, 0.0, 1.0);
                 }
     )");
     shader->AttachFromSource(ShaderStage::Fragment, R"(
                 #version 330 core
-                in vec4 vColor;
+                in vec2 v_Local;
+                in vec2 v_Extent;
+                in float v_HalfWidth;
+                flat in uint v_Shape;
+                in vec4 v_Color;
                 out vec4 FragColor;
 
+                uniform float u_PixelSize;
+
+                float BoxDistance(vec2 p, vec2 halfSize)
+                {
+                    vec2 d = abs(p) - halfSize;
+                    return length(max(d, 0.0)) + min(max(d.x, d.y), 0.0);
+                }
+
+                void main()
+                {
+                    float distance;
+                    if (v_Shape == 0u)
+                        distance = BoxDistance(v_Local, v_Extent) - v_HalfWidth;
+                    else if (v_Shape == 1u)
+                        distance = abs(BoxDistance(v_Local, v_Extent)) - v_HalfWidth;
+                    else
+                        distance = abs(length(v_Local) - v_Extent.x) - v_HalfWidth;
+
+                    float coverage = clamp(0.5 - distance / u_PixelSize, 0.0, 1.0);
+                    if (coverage <= 0.0)
+                        discard;
+                    FragColor = vec4(v_Color.rgb, v_Color.a * coverage);
+                }
+    )");
+    shader->BeginLink();
+    pendingShaders.push_back(shader.get());
+
+    shaderMap["internal_debug_shape"] = std::move(shader);
+
+    shader = std::make_unique<Shader>();
+    shader->AttachFromSource(ShaderStage::Vertex, R"(
+                #version 330 core
+                layout (location = 0) in vec3 aPos;
+                layout (location = 1) in vec2 aUV;
+                layout (location = 2) in vec4 aColor;
+
+                layout (std140) uniform CameraBlock
+                {
+                    mat4 u_ViewProjections[64];
+                };
+                uniform int u_CameraIndex;
+
+                out vec2 v_UV;
+                out vec4 v_Color;
+
                 void main()
                 {
-                    FragColor = vColor;
+                    v_UV = aUV;
+                    v_Color = aColor;
+                    gl_Position = u_ViewProjections[u_CameraIndex] * vec4(aPos, 1.0);
                 }
     )");
-    shader->Link();
+    shader->AttachFromSource(ShaderStage::Fragment, R"(
+                #version 330 core
+                in vec2 v_UV;
+                in vec4 v_Color;
+                out vec4 FragColor;
 
-    shaderMap["internal_debug_line"] = std::move(shader);
+                uniform sampler2D u_Texture;
 
+                void main()
+                {
+                    FragColor = texture(u_Texture, v_UV) * v_Color;
+                }
+    )");
+    shader->BeginLink();
+    pendingShaders.push_back(shader.get());
+    shaderMap["internal_sprite_batch"] = std::move(shader);
 
+    shader = std::make_unique<Shader>();
+    shader->AttachFromSource(ShaderStage::Vertex, R"(
+                #version 330 core
 
-    glGenVertexArrays(1, &debugLineVAO);
-    glGenBuffers(1, &debugLineVBO);
+                void main()
+                {
+                    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+                    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+                }
+    )");
+    shader->AttachFromSource(ShaderStage::Fragment, R"(
+                #version 330 core
+                out vec4 FragColor;
 
-    glBindVertexArray(debugLineVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, debugLineVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 10000, nullptr, GL_DYNAMIC_DRAW);
+                uniform sampler2D u_Texture;
 
-    glEnableVertexAttribArray(0); // vec2 position
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 6, (void*)0);
+                void main()
+                {
+                    FragColor = texelFetch(u_Texture, ivec2(gl_FragCoord.xy), 0);
+                }
+    )");
+    shader->BeginLink();
+    pendingShaders.push_back(shader.get());
+    layerCache.Init(shader.get());
+    shaderMap["internal_layer_composite"] = std::move(shader);
 
-    glEnableVertexAttribArray(1); // vec4 color
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(float) * 6, (void*)(sizeof(float) * 2));
+    shader = std::make_unique<Shader>();
+    shader->AttachFromSource(ShaderStage::Vertex, R"(
+                #version 330 core
 
-    glBindVertexArray(0);
+                void main()
+                {
+                    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+                    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+                }
+    )");
+    shader->AttachFromSource(ShaderStage::Fragment, R"(
+                #version 330 core
+                out vec4 FragColor;
 
+                uniform sampler2D u_Texture;
+                uniform vec2 u_SourceSize;
+                uniform vec2 u_OutputSize;
 
+                void main()
+                {
+                    // Clamped half a texel inside the scene, so filtering never reads the unused part of the target.
+                    vec2 source = clamp(gl_FragCoord.xy * u_SourceSize / u_OutputSize, vec2(0.5), u_SourceSize - 0.5);
+                    FragColor = texture(u_Texture, source / vec2(textureSize(u_Texture, 0)));
+                }
+    )");
+    shader->BeginLink();
+    pendingShaders.push_back(shader.get());
+    resolutionScaler.Init(shader.get());
+    shaderMap["internal_upscale"] = std::move(shader);
+
+    instanceRingBuffer.Init(INITIAL_INSTANCE_STREAM_BYTES);
+    instanceStore.Init(INITIAL_RESIDENT_INSTANCE_SLOTS);
+    meshPool.Init(INITIAL_POOL_VERTICES, INITIAL_POOL_INDICES);
+    cameraBuffer.Init();
+    spriteBatcher.Init();
+    debugRenderer.Init();
+    gpuProfiler.Init();
+    threadPool.Init();
+
+    // The internal programs compile in parallel with each other and with the buffer setup above.
+    WaitForShaders();
+    RegisterMaterial("internal_text", "internal_text", {});
 
     glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // Alpha accumulates as coverage, so cached layer targets end up premultiplied (see LayerCache).
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 }
 
-void RenderManager::BuildRenderMap(const std::vector<Object*>& source, Camera2D* camera)
+void RenderManager::BuildDrawItems(Object* const* objects, size_t count, Camera2D* camera, glm::vec2 viewportSize, std::vector<DrawItem>& out) const
 {
-    for (auto* obj : source)
+    const glm::vec2 viewSize = camera ? viewportSize / camera->GetZoom() : viewportSize;
+    for (size_t i = 0; i < count; ++i)
     {
-        if (!obj || !obj->IsVisible())
+        Object* obj = objects[i];
+        if (obj && camera && !FrustumCuller::IsVisible(*camera, obj, viewSize))
             continue;
+        AppendDrawItem(obj, camera, out);
+    }
+}
 
-        Material* material = obj->GetMaterial();
-        Mesh* mesh = obj->GetMesh();
-        Shader* shader = material ? material->GetShader() : nullptr;
+void RenderManager::BuildDrawItems(Object* const* objects, const uint32_t* indices, size_t count, Camera2D* camera, std::vector<DrawItem>& out) const
+{
+    for (size_t i = 0; i < count; ++i)
+        AppendDrawItem(objects[indices[i]], camera, out);
+}
+
+void RenderManager::AppendDrawItem(Object* obj, Camera2D* camera, std::vector<DrawItem>& out) const
+{
+    if (!obj || !obj->IsVisible())
+        return;
+
+    Material* material = obj->GetMaterial() ? obj->GetMaterial()->GetBatchMaterial() : nullptr;
+    Mesh* mesh = obj->GetMesh();
+    Shader* shader = material ? material->GetShader() : nullptr;
+
+    if (!material || !mesh || !shader)
+        return;
 
-        if (!material || !mesh || !shader)
+    uint8_t layer = obj->GetRenderLayer();
+    if (layer >= RenderLayerManager::MAX_LAYERS)
+    {
+        SNAKE_WRN("render skipped - invalid layer\n");
+        return;
+    }
+
+    uint64_t key = DrawKey::Make(layer, shader->GetSortID(), material->GetSortID(), mesh->GetSortID());
+    out.push_back({ key, obj, camera });
+}
+
+void RenderManager::RecordStaticDraws(size_t& next, size_t end, uint64_t upToKey)
+{
+    for (; next < end && staticDrawItems[next].key <= upToKey; ++next)
+    {
+        const StaticDrawItem& item = staticDrawItems[next];
+        const StaticBatcher::ChunkKey& chunkKey = item.batcher->chunks[item.chunk].key;
+        RecordLayerChange(item.key);
+        RenderCommand& cmd = commandBuffer.emplace_back();
+        cmd.type = RenderCommandType::DrawStatic;
+        DrawStaticCommand& draw = cmd.drawStatic = {};
+        draw.batcher = item.batcher;
+        draw.chunk = item.chunk;
+        draw.viewIndex = cameraBuffer.GetViewIndex(item.camera, chunkKey.ignoreCamera, chunkKey.referenceCamera);
+        ++recordedStats.batchCount;
+        ++recordedStats.drawCallCount;
+        recordedStats.instanceCount += item.batcher->chunks[item.chunk].members.size();
+    }
+}
+
+size_t RenderManager::FindBatchEnd(size_t batchBegin) const
+{
+    const DrawItem& first = drawItems[batchBegin];
+    const InstanceBatchKey key{ first.object->GetMesh(), first.object->GetMaterial()->GetBatchMaterial() };
+    const uint64_t batchKey = first.key & DrawKey::BATCH_MASK;
+
+    // Sort IDs are truncated to their key fields, so resource pointers are compared as well.
+    size_t batchEnd = batchBegin + 1;
+    while (batchEnd < drawItems.size())
+    {
+        const DrawItem& item = drawItems[batchEnd];
+        if ((item.key & DrawKey::BATCH_MASK) != batchKey || item.camera != first.camera ||
+            !(InstanceBatchKey{ item.object->GetMesh(), item.object->GetMaterial()->GetBatchMaterial() } == key))
+            break;
+        ++batchEnd;
+    }
+    return batchEnd;
+}
+
+RingAllocation RenderManager::WriteInstanceData(size_t begin, size_t count, InstanceLayout layout, bool hasTextureLayers)
+{
+    const size_t instanceBytes = count * GetInstanceBytes(layout);
+    const RingAllocation instanceData = instanceRingBuffer.Allocate(instanceBytes + (hasTextureLayers ? count * TEXTURE_LAYER_BYTES : 0));
+    if (layout == InstanceLayout::Compact)
+    {
+        WriteCompactInstances(&drawItems[begin], count, interpolationAlpha, static_cast<CompactInstance*>(instanceData.data));
+    }
+    else if (layout == InstanceLayout::Resident)
+    {
+        // Only the slot indices are streamed; unchanged objects cost a version and color compare.
+        uint32_t* slots = static_cast<uint32_t*>(instanceData.data);
+        for (size_t i = 0; i < count; ++i)
+            slots[i] = instanceStore.Update(drawItems[begin + i].object, interpolationAlpha);
+    }
+    else
+    {
+        WriteFullInstances(&drawItems[begin], count, interpolationAlpha, instanceData.data);
+    }
+
+    if (hasTextureLayers)
+    {
+        uint32_t* layers = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(instanceData.data) + instanceBytes);
+        for (size_t i = 0; i < count; ++i)
+            layers[i] = drawItems[begin + i].object->GetMaterial()->GetTextureLayer();
+    }
+    return instanceData;
+}
+
+size_t RenderManager::RecordMultiDrawRun(size_t runBegin, size_t firstBatchEnd)
+{
+    const DrawItem& first = drawItems[runBegin];
+    Material* material = first.object->GetMaterial()->GetBatchMaterial();
+    const uint64_t runKey = first.key & DrawKey::MATERIAL_MASK;
+
+    // Instances of the whole run are written back to back; baseInstance selects each mesh's range.
+    indirectScratch.clear();
+    indirectScratch.push_back(MeshPool::MakeCommand(first.object->GetMesh(), static_cast<uint32_t>(firstBatchEnd - runBegin), 0));
+    size_t runEnd = firstBatchEnd;
+    while (runEnd < drawItems.size())
+    {
+        const DrawItem& next = drawItems[runEnd];
+        if ((next.key & DrawKey::MATERIAL_MASK) != runKey || next.camera != first.camera ||
+            next.object->GetMaterial()->GetBatchMaterial() != material || !next.object->GetMesh()->IsPooled() ||
+            !SharesRunUniforms(first.object, next.object))
+            break;
+
+        const size_t nextEnd = FindBatchEnd(runEnd);
+        indirectScratch.push_back(MeshPool::MakeCommand(next.object->GetMesh(),
+            static_cast<uint32_t>(nextEnd - runEnd), static_cast<uint32_t>(runEnd - runBegin)));
+        runEnd = nextEnd;
+    }
+
+    const size_t count = runEnd - runBegin;
+    const InstanceLayout layout = material->GetShader()->GetInstanceLayout();
+    const RingAllocation instanceData = WriteInstanceData(runBegin, count, layout, material->GetShader()->UsesTextureLayer());
+
+    const size_t indirectBytes = indirectScratch.size() * sizeof(DrawElementsIndirectCommand);
+    const RingAllocation indirectData = instanceRingBuffer.Allocate(indirectBytes);
+    std::memcpy(indirectData.data, indirectScratch.data(), indirectBytes);
+
+    RenderCommand& cmd = commandBuffer.emplace_back();
+    cmd.type = RenderCommandType::DrawMultiIndirect;
+    DrawMultiIndirectCommand& draw = cmd.drawMultiIndirect = {};
+    draw.material = material;
+    draw.front = first.object;
+    draw.viewIndex = GetViewIndex(first);
+    draw.instanceBuffer = instanceData.buffer;
+    draw.instanceCount = static_cast<uint32_t>(count);
+    draw.instanceOffset = instanceData.offset;
+    draw.indirectBuffer = indirectData.buffer;
+    draw.drawCount = static_cast<uint32_t>(indirectScratch.size());
+    draw.indirectOffset = indirectData.offset;
+    draw.layout = layout;
+    recordedStats.batchCount += indirectScratch.size();
+    ++recordedStats.drawCallCount;
+    return runEnd;
+}
+
+bool RenderManager::CanSpriteBatch(Object* obj) const
+{
+    if (!isSpriteBatchingEnabled || !obj->IsSpriteBatchable() || obj->CanBeInstanced() || !obj->GetMesh()->CanBeBaked())
+        return false;
+    return obj->GetMaterial()->GetBatchMaterial()->GetShader()->spriteBatchShader != nullptr;
+}
+
+size_t RenderManager::RecordSpriteBatch(size_t runBegin)
+{
+    const DrawItem& first = drawItems[runBegin];
+    Material* material = first.object->GetMaterial()->GetBatchMaterial();
+    const uint64_t runKey = first.key & DrawKey::MATERIAL_MASK;
+
+    // Vertices are already transformed, so different meshes of the same material join one run as well.
+    size_t runEnd = runBegin + 1;
+    while (runEnd < drawItems.size())
+    {
+        const DrawItem& next = drawItems[runEnd];
+        if ((next.key & DrawKey::MATERIAL_MASK) != runKey || next.camera != first.camera ||
+            next.object->GetMaterial()->GetBatchMaterial() != material || !CanSpriteBatch(next.object) ||
+            !SharesRunUniforms(first.object, next.object))
+            break;
+        ++runEnd;
+    }
+
+    const size_t count = runEnd - runBegin;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    SpriteBatcher::Measure(&drawItems[runBegin], count, vertexCount, indexCount);
+    const size_t vertexBytes = vertexCount * sizeof(SpriteVertex);
+    const RingAllocation data = instanceRingBuffer.Allocate(vertexBytes + indexCount * sizeof(uint32_t));
+    SpriteBatcher::Write(&drawItems[runBegin], count, interpolationAlpha, static_cast<SpriteVertex*>(data.data),
+        reinterpret_cast<uint32_t*>(static_cast<unsigned char*>(data.data) + vertexBytes));
+
+    RenderCommand& cmd = commandBuffer.emplace_back();
+    cmd.type = RenderCommandType::DrawSpriteBatch;
+    DrawSpriteBatchCommand& draw = cmd.drawSpriteBatch = {};
+    draw.material = GetSpriteBatchMaterial(material);
+    draw.source = material;
+    draw.front = first.object;
+    draw.viewIndex = GetViewIndex(first);
+    draw.buffer = data.buffer;
+    draw.vertexOffset = data.offset;
+    draw.indexOffset = data.offset + vertexBytes;
+    draw.indexCount = static_cast<uint32_t>(indexCount);
+    ++recordedStats.batchCount;
+    ++recordedStats.drawCallCount;
+    return runEnd;
+}
+
+Material* RenderManager::GetSpriteBatchMaterial(Material* material)
+{
+    Shader* batchShader = material->GetShader()->spriteBatchShader;
+    if (!material->spriteBatchMaterial || material->spriteBatchMaterial->GetShader() != batchShader)
+    {
+        auto batchMaterial = std::make_unique<Material>(batchShader);
+        material->spriteBatchMaterial = batchMaterial.get();
+        spriteBatchMaterials.push_back(std::move(batchMaterial));
+    }
+    return material->spriteBatchMaterial;
+}
+
+void RenderManager::SubmitDrawItems(const EngineContext& engineContext)
+{
+    recordedStats = {};
+    recordedLayer = -1;
+    cameraBuffer.BeginFrame(interpolationAlpha);
+    RadixSortDrawItems(drawItems, drawItemScratch);
+    // Few chunks survive culling, so a comparison sort is enough; both lists are then merged by key.
+    std::stable_sort(staticDrawItems.begin(), staticDrawItems.end(),
+        [](const StaticDrawItem& a, const StaticDrawItem& b) { return a.key < b.key; });
+    recordedStats.instanceCount = drawItems.size();
+
+    for (uint8_t layer = 0; layer < RenderLayerManager::MAX_LAYERS; ++layer)
+    {
+        if (!renderLayerManager.invalidatedLayers[layer])
             continue;
+        layerCache.Invalidate(layer);
+        renderLayerManager.invalidatedLayers[layer] = false;
+    }
 
-        uint8_t layer = obj->GetRenderLayer();
-        if (layer >= RenderLayerManager::MAX_LAYERS)
+    const glm::ivec2 windowSize(engineContext.windowManager->GetWidth(), engineContext.windowManager->GetHeight());
+    const size_t itemCount = drawItems.size();
+    const size_t staticCount = staticDrawItems.size();
+    std::array<bool, RenderLayerManager::MAX_LAYERS> recordedLayers{};
+    if (!dynamicResolution.isEnabled || !resolutionScaler.PrepareTarget(windowSize.x, windowSize.y))
+    {
+        RecordLayers(0, itemCount, 0, staticCount, windowSize, windowSize, recordedLayers);
+        return;
+    }
+
+    resolutionScaler.Update(dynamicResolution, gpuTimings.totalMs);
+    const glm::ivec2 sceneSize = glm::max(glm::ivec2(glm::round(glm::vec2(windowSize) * resolutionScaler.GetScale())), glm::ivec2(1));
+    const SceneTargetCommand sceneTarget{ sceneSize.x, sceneSize.y, windowSize.x, windowSize.y };
+
+    // Clears and callbacks recorded by the states so far belong to the scene as well.
+    RenderCommand beginScene;
+    beginScene.type = RenderCommandType::BeginScaledScene;
+    beginScene.sceneTarget = sceneTarget;
+    commandBuffer.insert(commandBuffer.begin(), beginScene);
+
+    size_t sceneItemEnd = itemCount;
+    size_t sceneStaticEnd = staticCount;
+    if (dynamicResolution.renderUiAtNativeResolution)
+    {
+        // Moves screen-space items behind the scene items; both parts stay sorted by key.
+        drawItemScratch.clear();
+        sceneItemEnd = 0;
+        for (const DrawItem& item : drawItems)
         {
-            SNAKE_WRN("render skipped - invalid layer\n");
-            continue;
+            if (item.object->ShouldIgnoreCamera())
+                drawItemScratch.push_back(item);
+            else
+                drawItems[sceneItemEnd++] = item;
         }
+        std::copy(drawItemScratch.begin(), drawItemScratch.end(), drawItems.begin() + sceneItemEnd);
 
-        InstanceBatchKey key{ mesh, material };
-        renderMap[layer][shader][key].emplace_back(obj, camera);
+        const auto staticUiBegin = std::stable_partition(staticDrawItems.begin(), staticDrawItems.end(),
+            [](const StaticDrawItem& item) { return !item.batcher->chunks[item.chunk].key.ignoreCamera; });
+        sceneStaticEnd = static_cast<size_t>(staticUiBegin - staticDrawItems.begin());
     }
+
+    RecordLayers(0, sceneItemEnd, 0, sceneStaticEnd, windowSize, sceneSize, recordedLayers);
+
+    RenderCommand& upscale = commandBuffer.emplace_back();
+    upscale.type = RenderCommandType::UpscaleScene;
+    upscale.sceneTarget = sceneTarget;
+    ++recordedStats.drawCallCount;
+    recordedLayer = -1;
+
+    RecordLayers(sceneItemEnd, itemCount, sceneStaticEnd, staticCount, windowSize, windowSize, recordedLayers);
 }
 
-void RenderManager::SubmitRenderMap(const EngineContext& engineContext)
+void RenderManager::RecordLayers(size_t itemBegin, size_t itemEnd, size_t staticBegin, size_t staticEnd,
+    glm::ivec2 windowSize, glm::ivec2 viewportSize, std::array<bool, RenderLayerManager::MAX_LAYERS>& recordedLayers)
 {
-    Material* lastMaterial = nullptr;
-    Shader* lastShader = nullptr;
-
-    for (uint8_t layer = 0; layer < renderMap.size(); ++layer)
+    while (itemBegin < itemEnd || staticBegin < staticEnd)
     {
-        const ShaderMap& _shaderMap = renderMap[layer];
+        // Both lists are sorted by key, so every layer is one range in each of them.
+        const uint8_t layer = std::min(
+            itemBegin < itemEnd ? DrawKey::GetLayer(drawItems[itemBegin].key) : RenderLayerManager::MAX_LAYERS,
+            staticBegin < staticEnd ? DrawKey::GetLayer(staticDrawItems[staticBegin].key) : RenderLayerManager::MAX_LAYERS);
+        size_t layerItemEnd = itemBegin;
+        while (layerItemEnd < itemEnd && DrawKey::GetLayer(drawItems[layerItemEnd].key) == layer)
+            ++layerItemEnd;
+        size_t layerStaticEnd = staticBegin;
+        while (layerStaticEnd < staticEnd && DrawKey::GetLayer(staticDrawItems[layerStaticEnd].key) == layer)
+            ++layerStaticEnd;
+
+        // A layer split between the scaled scene and native UI would alternate between two renderings, so only its first part is cached.
+        if (renderLayerManager.IsCached(layer) && !recordedLayers[layer])
+            RecordCachedLayer(layer, itemBegin, layerItemEnd, staticBegin, layerStaticEnd, windowSize, viewportSize);
+        else
+            RecordLayerDraws(itemBegin, layerItemEnd, staticBegin, layerStaticEnd);
+        recordedLayers[layer] = true;
+
+        itemBegin = layerItemEnd;
+        staticBegin = layerStaticEnd;
+    }
+}
 
-        for (const auto& [shader, batchMap] : _shaderMap)
+void RenderManager::RecordLayerDraws(size_t itemBegin, size_t itemEnd, size_t staticBegin, size_t staticEnd)
+{
+    size_t nextStatic = staticBegin;
+    size_t batchBegin = itemBegin;
+    while (batchBegin < itemEnd)
+    {
+        const DrawItem& first = drawItems[batchBegin];
+        const InstanceBatchKey key{ first.object->GetMesh(), first.object->GetMaterial()->GetBatchMaterial() };
+        RecordStaticDraws(nextStatic, staticEnd, first.key & DrawKey::BATCH_MASK);
+        RecordLayerChange(first.key);
+
+        // Batches and runs never cross a layer, since the layer is part of every key they compare.
+        size_t batchEnd = FindBatchEnd(batchBegin);
+        if (first.object->CanBeInstanced() && submissionMode == SubmissionMode::MultiDrawIndirect && key.mesh->IsPooled())
+        {
+            batchEnd = RecordMultiDrawRun(batchBegin, batchEnd);
+        }
+        else if (CanSpriteBatch(first.object))
+        {
+            batchEnd = RecordSpriteBatch(batchBegin);
+        }
+        else if (first.object->CanBeInstanced())
         {
-            for (const auto& [key, batch] : batchMap)
+            const size_t count = batchEnd - batchBegin;
+            const InstanceLayout layout = key.material->GetShader()->GetInstanceLayout();
+            const RingAllocation instanceData = WriteInstanceData(batchBegin, count, layout, key.material->GetShader()->UsesTextureLayer());
+
+            RenderCommand& cmd = commandBuffer.emplace_back();
+            cmd.type = RenderCommandType::DrawInstanced;
+            DrawInstancedCommand& draw = cmd.drawInstanced = {};
+            draw.mesh = key.mesh;
+            draw.material = key.material;
+            draw.front = first.object;
+            draw.viewIndex = GetViewIndex(first);
+            draw.instanceBuffer = instanceData.buffer;
+            draw.instanceCount = static_cast<uint32_t>(count);
+            draw.instanceOffset = instanceData.offset;
+            draw.layout = layout;
+            ++recordedStats.batchCount;
+            ++recordedStats.drawCallCount;
+        }
+        else
+        {
+            for (size_t i = batchBegin; i < batchEnd; ++i)
             {
-                if (batch.front().first->CanBeInstanced())
-                {
-                    Submit([=]() mutable {
-                        std::vector<glm::mat4> transforms;
-                        std::vector<glm::vec4> colors;
-                        std::vector<glm::vec2> uvOffsets;
-                        std::vector<glm::vec2> uvScales;
-                        transforms.reserve(batch.size());
-                        colors.reserve(batch.size());
-                        uvOffsets.reserve(batch.size());
-                        uvScales.reserve(batch.size());
-                        for (const auto& [obj, camera] : batch)
-                        {
-                            glm::mat4 model = obj->GetTransform2DMatrix();
-                            glm::vec2 flip = obj->GetUVFlipVector();
-                            model = model * glm::scale(glm::mat4(1.0f), glm::vec3(flip, 1.0f));
-                            transforms.push_back(model);
-
-                            colors.push_back(obj->GetColor());
-                            if (obj->HasAnimation())
-                            {
-                                uvOffsets.push_back(obj->GetAnimator()->GetUVOffset());
-                                uvScales.push_back(obj->GetAnimator()->GetUVScale());
-                            }
-                            else
-                            {
-                                uvOffsets.emplace_back(0.0f, 0.0f);
-                                uvScales.emplace_back(1.0f, 1.0f);
-                            }
-                        }
-
-                        Material* material = key.material;
-                        Shader* currentShader = material->GetShader();
-
-                        if (material != lastMaterial)
-                        {
-                            material->Bind();
-                            lastMaterial = material;
-                        }
-
-                        if (currentShader != lastShader)
-                        {
-                            glm::mat4 projection;
-                            if (batch.front().first->ShouldIgnoreCamera() || batch.front().second == nullptr)
-                            {
-                                projection = glm::ortho(
-                                    -static_cast<float>(batch.front().first->GetReferenceCamera()->GetScreenWidth()) / 2,
-                                    static_cast<float>(batch.front().first->GetReferenceCamera()->GetScreenWidth()) / 2,
-                                    -static_cast<float>(batch.front().first->GetReferenceCamera()->GetScreenHeight()) / 2,
-                                    static_cast<float>(batch.front().first->GetReferenceCamera()->GetScreenHeight()) / 2
-                                );
-                            }
-                            else
-                                projection = batch.front().second->GetProjectionMatrix();
-                            material->SetUniform("u_Projection", projection);
-                            material->SetTexture("u_Texture", batch.front().first->GetAnimator()->GetTexture());
-                            lastShader = currentShader;
-                        }
-
-                        batch.front().first->Draw(engineContext);
-                        material->SendUniforms();
-
-                        key.mesh->BindVAO();
-                        material->UpdateInstanceBuffer(transforms, colors, uvOffsets, uvScales);
-                        key.mesh->DrawInstanced(static_cast<GLsizei>(transforms.size()));
-                        material->UnBind();
-                        });
-                }
-                else
-                {
-                    for (const auto& [obj, camera] : batch)
-                    {
-
-                        Submit([=]() mutable {
-                            Material* mat = key.material;
-                            Shader* currentShader = mat->GetShader();
-
-                            if (mat != lastMaterial)
-                            {
-                                mat->Bind();
-                                lastMaterial = mat;
-                            }
-
-                            if (currentShader != lastShader)
-                            {
-                                glm::mat4 projection;
-                                if (obj->ShouldIgnoreCamera() || camera == nullptr)
-                                {
-                                    projection = glm::ortho(
-                                        -static_cast<float>(obj->GetReferenceCamera()->GetScreenWidth()) / 2,
-                                        static_cast<float>(obj->GetReferenceCamera()->GetScreenWidth()) / 2,
-                                        -static_cast<float>(obj->GetReferenceCamera()->GetScreenHeight()) / 2,
-                                        static_cast<float>(obj->GetReferenceCamera()->GetScreenHeight()) / 2
-                                    );
-                                }
-                                else
-                                    projection = camera->GetProjectionMatrix();
-                                mat->SetUniform("u_Projection", projection);
-
-                                glm::mat4 model = obj->GetTransform2DMatrix();
-                                glm::vec2 flip = obj->GetUVFlipVector();
-                                model = model * glm::scale(glm::mat4(1.0f), glm::vec3(flip, 1.0f));
-
-                                mat->SetUniform("u_Model", model);
-                                mat->SetUniform("u_Color", obj->GetColor());
-
-                                lastShader = currentShader;
-                            }
-
-                            if (obj->HasAnimation())
-                            {
-                                SpriteAnimator* anim = obj->GetAnimator();
-                                mat->SetUniform("u_UVOffset", anim->GetUVOffset());
-                                mat->SetUniform("u_UVScale", anim->GetUVScale());
-                                mat->SetTexture("u_Texture", anim->GetTexture());
-                            }
-
-                            obj->Draw(engineContext);
-                            mat->SendUniforms();
-                            key.mesh->Draw();
-                            mat->UnBind();
-                            });
-                    }
-                }
+                RenderCommand& cmd = commandBuffer.emplace_back();
+                cmd.type = RenderCommandType::DrawSingle;
+                DrawSingleCommand& draw = cmd.drawSingle = {};
+                draw.mesh = key.mesh;
+                draw.material = key.material;
+                draw.object = drawItems[i].object;
+                draw.viewIndex = GetViewIndex(drawItems[i]);
             }
+            ++recordedStats.batchCount;
+            recordedStats.drawCallCount += batchEnd - batchBegin;
+        }
+
+        batchBegin = batchEnd;
+    }
+    RecordStaticDraws(nextStatic, staticEnd, UINT64_MAX);
+}
+
+void RenderManager::RecordCachedLayer(uint8_t layer, size_t itemBegin, size_t itemEnd, size_t staticBegin, size_t staticEnd, glm::ivec2 windowSize, glm::ivec2 viewportSize)
+{
+    // Targets are window sized; a scaled scene only covers part of them, which the signature has to tell apart.
+    uint64_t signature = HashLayerContents(itemBegin, itemEnd, staticBegin, staticEnd);
+    signature = HashCombine(signature, (static_cast<uint64_t>(viewportSize.x) << 32) | static_cast<uint32_t>(viewportSize.y));
+    LayerCacheStats& stats = renderLayerManager.cacheStats[layer];
+    RecordLayerChange(DrawKey::Make(layer, 0, 0, 0));
+
+    if (layerCache.Lookup(layer, signature, windowSize.x, windowSize.y))
+    {
+        ++stats.hitCount;
+        recordedStats.instanceCount -= itemEnd - itemBegin;
+    }
+    else if (!layerCache.HasTarget(layer))
+    {
+        RecordLayerDraws(itemBegin, itemEnd, staticBegin, staticEnd);
+        return;
+    }
+    else
+    {
+        ++stats.missCount;
+        RenderCommand& bindTarget = commandBuffer.emplace_back();
+        bindTarget.type = RenderCommandType::SetLayerTarget;
+        bindTarget.setLayerTarget = { layer };
+
+        RecordLayerDraws(itemBegin, itemEnd, staticBegin, staticEnd);
+
+        RenderCommand& bindDefault = commandBuffer.emplace_back();
+        bindDefault.type = RenderCommandType::SetLayerTarget;
+        bindDefault.setLayerTarget = { -1 };
+    }
+
+    RenderCommand& cmd = commandBuffer.emplace_back();
+    cmd.type = RenderCommandType::CompositeLayer;
+    cmd.compositeLayer = { layer };
+    ++recordedStats.drawCallCount;
+}
+
+uint64_t RenderManager::HashLayerContents(size_t itemBegin, size_t itemEnd, size_t staticBegin, size_t staticEnd)
+{
+    uint64_t hash = HashCombine(itemEnd - itemBegin, staticEnd - staticBegin);
+    uint32_t hashedView = UINT32_MAX;
+    auto hashView = [&](uint32_t view)
+        {
+            if (view == hashedView)
+                return;
+            hashedView = view;
+            hash = HashFloats(hash, &cameraBuffer.GetMatrix(view)[0][0], 16);
+        };
+
+    for (size_t i = itemBegin; i < itemEnd; ++i)
+    {
+        Object* obj = drawItems[i].object;
+        const Transform2D& transform = obj->GetTransform2D();
+        hash = HashPointer(hash, obj);
+        hash = HashCombine(hash, transform.GetVersion());
+        // The pose itself goes in too, so the signature never rests on pointer and version bookkeeping alone.
+        const float pose[5] = { transform.GetPosition().x, transform.GetPosition().y, transform.GetRotation(),
+            transform.GetScale().x, transform.GetScale().y };
+        hash = HashFloats(hash, pose, 5);
+        if (interpolationAlpha < 1.0f && transform.IsInterpolating())
+            hash = HashFloats(hash, &interpolationAlpha, 1);
+        hash = HashPointer(hash, obj->GetMaterial());
+        hash = HashPointer(hash, obj->GetMesh());
+        hash = HashFloats(hash, &obj->GetColor()[0], 4);
+        const glm::vec4 uvRect = obj->GetUVRect();
+        hash = HashFloats(hash, &uvRect[0], 4);
+        const glm::vec2 flip = obj->GetUVFlipVector();
+        hash = HashFloats(hash, &flip[0], 2);
+        if (obj->HasAnimation())
+            hash = HashPointer(hash, obj->GetAnimator()->GetTexture());
+        hashView(GetViewIndex(drawItems[i]));
+    }
+
+    for (size_t i = staticBegin; i < staticEnd; ++i)
+    {
+        const StaticDrawItem& item = staticDrawItems[i];
+        const StaticBatcher::Chunk& chunk = item.batcher->chunks[item.chunk];
+        hash = HashPointer(hash, item.batcher);
+        hash = HashCombine(hash, item.chunk);
+        hash = HashCombine(hash, chunk.version);
+        hash = HashFloats(hash, &chunk.color[0], 4);
+        hashView(cameraBuffer.GetViewIndex(item.camera, chunk.key.ignoreCamera, chunk.key.referenceCamera));
+    }
+    return hash;
+}
+
+void RenderManager::RecordLayerChange(uint64_t key)
+{
+    const uint8_t layer = DrawKey::GetLayer(key);
+    if (layer == recordedLayer)
+        return;
+    recordedLayer = layer;
+    RenderCommand& cmd = commandBuffer.emplace_back();
+    cmd.type = RenderCommandType::BeginLayer;
+    cmd.beginLayer = { layer };
+}
+
+uint32_t RenderManager::GetViewIndex(const DrawItem& item)
+{
+    return cameraBuffer.GetViewIndex(item.camera, item.object->ShouldIgnoreCamera(), item.object->GetReferenceCamera());
+}
+
+void RenderManager::SetViewUniforms(Material* material, uint32_t viewIndex) const
+{
+    if (material->GetShader()->UsesCameraBlock())
+        material->SetUniform(U_CAMERA_INDEX, static_cast<int>(viewIndex));
+    else
+        material->SetUniform(U_PROJECTION, cameraBuffer.GetMatrix(viewIndex));
+}
+
+void RenderManager::ResolveCommands(const EngineContext& engineContext)
+{
+    snapshotTextures.clear();
+    snapshotUniforms.clear();
+    for (RenderCommand& cmd : frameCommands)
+        ResolveCommand(cmd, engineContext);
+}
+
+void RenderManager::ResolveCommand(RenderCommand& cmd, const EngineContext& engineContext)
+{
+    switch (cmd.type)
+    {
+    case RenderCommandType::DrawInstanced:
+        ResolveDrawInstanced(cmd.drawInstanced, engineContext);
+        break;
+    case RenderCommandType::DrawSingle:
+        ResolveDrawSingle(cmd.drawSingle, engineContext);
+        break;
+    case RenderCommandType::DrawStatic:
+        ResolveDrawStatic(cmd.drawStatic);
+        break;
+    case RenderCommandType::DrawMultiIndirect:
+        ResolveDrawMultiIndirect(cmd.drawMultiIndirect, engineContext);
+        break;
+    case RenderCommandType::DrawSpriteBatch:
+        ResolveDrawSpriteBatch(cmd.drawSpriteBatch, engineContext);
+        break;
+    default:
+        break;
+    }
+}
+
+void RenderManager::ResolveDrawInstanced(DrawInstancedCommand& cmd, const EngineContext& engineContext)
+{
+    Material* material = cmd.material;
+    SetViewUniforms(material, cmd.viewIndex);
+    if (cmd.front->HasAnimation() && !material->GetShader()->UsesTextureLayer())
+        material->SetTexture(U_TEXTURE, cmd.front->GetAnimator()->GetTexture());
+
+    cmd.front->Draw(engineContext);
+    cmd.snapshot = SnapshotMaterial(material);
+}
+
+void RenderManager::ResolveDrawSingle(DrawSingleCommand& cmd, const EngineContext& engineContext)
+{
+    Material* material = cmd.material;
+    Object* obj = cmd.object;
+    SetViewUniforms(material, cmd.viewIndex);
+
+    glm::mat4 model = obj->GetInterpolatedTransform2DMatrix(interpolationAlpha);
+    glm::vec2 flip = obj->GetUVFlipVector();
+    model = model * glm::scale(glm::mat4(1.0f), glm::vec3(flip, 1.0f));
+
+    material->SetUniform(U_MODEL, model);
+    material->SetUniform(U_COLOR, obj->GetColor());
+
+    if (material->GetShader()->SupportsUVTransform())
+    {
+        const glm::vec4 uvRect = obj->GetUVRect();
+        material->SetUniform(U_UV_OFFSET, glm::vec2(uvRect.x, uvRect.y));
+        material->SetUniform(U_UV_SCALE, glm::vec2(uvRect.z, uvRect.w));
+    }
+    if (obj->HasAnimation())
+        material->SetTexture(U_TEXTURE, obj->GetAnimator()->GetTexture());
+
+    obj->Draw(engineContext);
+    cmd.snapshot = SnapshotMaterial(material);
+}
+
+void RenderManager::ResolveDrawStatic(DrawStaticCommand& cmd)
+{
+    const StaticBatcher::Chunk& chunk = cmd.batcher->chunks[cmd.chunk];
+    Material* material = chunk.key.material;
+    SetViewUniforms(material, cmd.viewIndex);
+
+    // Vertices are already in world space, with atlas sub-rects baked into their UVs.
+    material->SetUniform(U_MODEL, glm::mat4(1.0f));
+    material->SetUniform(U_COLOR, chunk.color);
+    if (material->GetShader()->SupportsUVTransform())
+    {
+        material->SetUniform(U_UV_OFFSET, glm::vec2(0.0f));
+        material->SetUniform(U_UV_SCALE, glm::vec2(1.0f));
+    }
+    cmd.snapshot = SnapshotMaterial(material);
+}
+
+void RenderManager::ResolveDrawMultiIndirect(DrawMultiIndirectCommand& cmd, const EngineContext& engineContext)
+{
+    Material* material = cmd.material;
+    SetViewUniforms(material, cmd.viewIndex);
+    if (cmd.front->HasAnimation() && !material->GetShader()->UsesTextureLayer())
+        material->SetTexture(U_TEXTURE, cmd.front->GetAnimator()->GetTexture());
+
+    cmd.front->Draw(engineContext);
+    cmd.snapshot = SnapshotMaterial(material);
+}
+
+void RenderManager::ResolveDrawSpriteBatch(DrawSpriteBatchCommand& cmd, const EngineContext& engineContext)
+{
+    cmd.front->Draw(engineContext);
+
+    // Mirror the source material after the Draw hook, which may have just changed it.
+    Material* material = cmd.material;
+    for (const Material::TextureBinding& binding : cmd.source->textures)
+        material->SetTexture(binding.id, binding.texture);
+    for (const Material::UniformEntry& uniform : cmd.source->uniforms)
+        material->SetUniform(uniform.id, uniform.value);
+    if (cmd.front->HasAnimation())
+        material->SetTexture(U_TEXTURE, cmd.front->GetAnimator()->GetTexture());
+
+    SetViewUniforms(material, cmd.viewIndex);
+    cmd.snapshot = SnapshotMaterial(material);
+}
+
+MaterialSnapshot RenderManager::SnapshotMaterial(const Material* material)
+{
+    const MaterialSnapshot snapshot{
+        static_cast<uint32_t>(snapshotTextures.size()), static_cast<uint32_t>(material->textures.size()),
+        static_cast<uint32_t>(snapshotUniforms.size()), static_cast<uint32_t>(material->uniforms.size()) };
+    snapshotTextures.insert(snapshotTextures.end(), material->textures.begin(), material->textures.end());
+    snapshotUniforms.insert(snapshotUniforms.end(), material->uniforms.begin(), material->uniforms.end());
+    return snapshot;
+}
+
+void RenderManager::SendMaterialSnapshot(const MaterialSnapshot& snapshot) const
+{
+    Material::SendUniforms(snapshotTextures.data() + snapshot.firstTexture, snapshot.textureCount,
+        snapshotUniforms.data() + snapshot.firstUniform, snapshot.uniformCount);
+}
+
+void RenderManager::ExecuteCommands(const EngineContext& engineContext)
+{
+    // Inside a scaled scene, draws go to the resolution target and window-space rects shrink with it.
+    GLuint frameFramebuffer = 0;
+    glm::vec2 rectScale(1.0f);
+    auto scaleRect = [&rectScale](int x, int y, int width, int height)
+        {
+            const glm::ivec2 min = glm::ivec2(glm::round(glm::vec2(x, y) * rectScale));
+            const glm::ivec2 max = glm::ivec2(glm::round(glm::vec2(x + width, y + height) * rectScale));
+            return glm::ivec4(min, max - min);
+        };
+
+    for (RenderCommand& cmd : frameCommands)
+    {
+        if (!isFrameResolved)
+        {
+            // Resolved one at a time, so the snapshot arrays only ever hold the current command.
+            snapshotTextures.clear();
+            snapshotUniforms.clear();
+            ResolveCommand(cmd, engineContext);
+        }
+
+        switch (cmd.type)
+        {
+        case RenderCommandType::DrawInstanced:
+            ExecuteDrawInstanced(cmd.drawInstanced);
+            break;
+        case RenderCommandType::DrawSingle:
+            ExecuteDrawSingle(cmd.drawSingle);
+            break;
+        case RenderCommandType::DrawStatic:
+            ExecuteDrawStatic(cmd.drawStatic);
+            break;
+        case RenderCommandType::DrawMultiIndirect:
+            ExecuteDrawMultiIndirect(cmd.drawMultiIndirect);
+            break;
+        case RenderCommandType::DrawSpriteBatch:
+            ExecuteDrawSpriteBatch(cmd.drawSpriteBatch);
+            break;
+        case RenderCommandType::BeginLayer:
+            gpuProfiler.EndScope();
+            gpuProfiler.BeginScope(cmd.beginLayer.layer);
+            break;
+        case RenderCommandType::SetLayerTarget:
+            layerCache.BindTarget(cmd.setLayerTarget.layer, frameFramebuffer);
+            break;
+        case RenderCommandType::CompositeLayer:
+            layerCache.Composite(cmd.compositeLayer.layer);
+            break;
+        case RenderCommandType::BeginScaledScene:
+        {
+            const SceneTargetCommand& scene = cmd.sceneTarget;
+            resolutionScaler.BindTarget(scene.sceneWidth, scene.sceneHeight);
+            frameFramebuffer = resolutionScaler.GetFramebuffer();
+            rectScale = glm::vec2(scene.sceneWidth, scene.sceneHeight) / glm::vec2(scene.windowWidth, scene.windowHeight);
+            break;
+        }
+        case RenderCommandType::UpscaleScene:
+        {
+            const SceneTargetCommand& scene = cmd.sceneTarget;
+            gpuProfiler.EndScope();
+            resolutionScaler.Upscale(scene.sceneWidth, scene.sceneHeight, scene.windowWidth, scene.windowHeight);
+            frameFramebuffer = 0;
+            rectScale = glm::vec2(1.0f);
+            break;
+        }
+        case RenderCommandType::SetViewport:
+        {
+            const SetViewportCommand& viewport = cmd.setViewport;
+            const glm::ivec4 rect = scaleRect(viewport.x, viewport.y, viewport.width, viewport.height);
+            glViewport(rect.x, rect.y, rect.z, rect.w);
+            break;
+        }
+        case RenderCommandType::Clear:
+        {
+            const ClearCommand& clear = cmd.clear;
+            const glm::ivec4 rect = scaleRect(clear.x, clear.y, clear.width, clear.height);
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(rect.x, rect.y, rect.z, rect.w);
+            glClearColor(clear.color[0], clear.color[1], clear.color[2], clear.color[3]);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glDisable(GL_SCISSOR_TEST);
+            break;
+        }
+        case RenderCommandType::UserCallback:
+            frameCallbacks[cmd.userCallback.callbackIndex]();
+            // The callback may have touched GL directly.
+            GLState::Invalidate();
+            break;
         }
     }
 }
 
+void RenderManager::ExecuteDrawInstanced(const DrawInstancedCommand& cmd)
+{
+    cmd.material->Bind();
+    SendMaterialSnapshot(cmd.snapshot);
+
+    const GLsizei count = static_cast<GLsizei>(cmd.instanceCount);
+    cmd.mesh->BindVAO();
+    cmd.mesh->BindInstanceStreams(cmd.layout, cmd.instanceBuffer, cmd.instanceOffset, count, cmd.material->GetShader()->UsesTextureLayer());
+    if (cmd.layout == InstanceLayout::Resident)
+        instanceStore.Bind();
+    cmd.mesh->DrawInstanced(count);
+}
+
+void RenderManager::ExecuteDrawSingle(const DrawSingleCommand& cmd)
+{
+    cmd.material->Bind();
+    SendMaterialSnapshot(cmd.snapshot);
+    cmd.mesh->Draw();
+}
+
+void RenderManager::ExecuteDrawStatic(const DrawStaticCommand& cmd)
+{
+    const StaticBatcher::Chunk& chunk = cmd.batcher->chunks[cmd.chunk];
+    chunk.key.material->Bind();
+    SendMaterialSnapshot(cmd.snapshot);
+
+    GLState::BindVertexArray(chunk.vao);
+    glDrawElements(GL_TRIANGLES, chunk.indexCount, GL_UNSIGNED_INT, nullptr);
+}
+
+void RenderManager::ExecuteDrawMultiIndirect(const DrawMultiIndirectCommand& cmd)
+{
+    cmd.material->Bind();
+    SendMaterialSnapshot(cmd.snapshot);
+
+    meshPool.BindVAO();
+    meshPool.BindInstanceStreams(cmd.layout, cmd.instanceBuffer, cmd.instanceOffset, static_cast<GLsizei>(cmd.instanceCount),
+        cmd.material->GetShader()->UsesTextureLayer());
+    if (cmd.layout == InstanceLayout::Resident)
+        instanceStore.Bind();
+
+    GLState::BindBuffer(GL_DRAW_INDIRECT_BUFFER, cmd.indirectBuffer);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(cmd.indirectOffset),
+        static_cast<GLsizei>(cmd.drawCount), 0);
+}
+
+void RenderManager::ExecuteDrawSpriteBatch(const DrawSpriteBatchCommand& cmd)
+{
+    cmd.material->Bind();
+    SendMaterialSnapshot(cmd.snapshot);
+
+    spriteBatcher.Bind(cmd.buffer, cmd.vertexOffset);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(cmd.indexCount), GL_UNSIGNED_INT, reinterpret_cast<const void*>(cmd.indexOffset));
+}
+
 /*
  * Usage:
  * renderManager.RegisterShader("basic", {
@@ -435,7 +1731,8 @@ void RenderManager::RegisterShader(const std::string& tag, const std::vector<std
     for (const auto& [stage, path] : sources)
         shader->AttachFromFile(stage, path);
 
-    shader->Link();
+    shader->BeginLink();
+    pendingShaders.push_back(shader.get());
     shaderMap[tag] = std::move(shader);
 }
 
@@ -472,21 +1769,25 @@ void RenderManager::RegisterTexture(const std::string& tag, std::unique_ptr<Text
 void RenderManager::RegisterMesh(const std::string& tag, const std::vector<Vertex>& vertices,
     const std::vector<unsigned int>& indices, PrimitiveType primitiveType)
 {
+    RenderThread::Sync();
     if (meshMap.find(tag) != meshMap.end())
     {
         SNAKE_WRN("Mesh with tag \"" << tag << "\" already registered.");
         return;
     }
     meshMap[tag] = std::make_unique<Mesh>(vertices, indices, primitiveType);
+    meshPool.Add(meshMap[tag].get());
 }
 
 void RenderManager::RegisterMesh(const std::string& tag, std::unique_ptr<Mesh> mesh)
 {
+    RenderThread::Sync();
     if (meshMap.find(tag) != meshMap.end())
     {
         SNAKE_WRN("Mesh with tag \"" << tag << "\" already registered.");
         return;
     }
+    meshPool.Add(mesh.get());
     meshMap[tag] = std::move(mesh);
 }
 
@@ -505,6 +1806,7 @@ void RenderManager::RegisterMaterial(const std::string& tag, const std::string&
         SNAKE_WRN("Shader not found: " << shaderTag);
         return;
     }
+    shader->FinishLink();
 
     auto material = std::make_unique<Material>(shader);
 
@@ -595,10 +1897,28 @@ SpriteSheet* RenderManager::GetSpriteSheetByTag(const std::string& tag)
     }
 }
 
+void RenderManager::WaitForShaders()
+{
+    // Programs the driver already finished are taken first, so reflecting them overlaps the rest.
+    while (!pendingShaders.empty())
+    {
+        auto ready = std::find_if(pendingShaders.begin(), pendingShaders.end(),
+            [](const Shader* shader) { return shader->IsLinkComplete(); });
+        if (ready == pendingShaders.end())
+            ready = pendingShaders.begin();
+        (*ready)->FinishLink();
+        pendingShaders.erase(ready);
+    }
+}
+
 Shader* RenderManager::GetShaderByTag(const std::string& tag)
 {
     if (shaderMap.find(tag) != shaderMap.end())
-        return shaderMap[tag].get();
+    {
+        Shader* shader = shaderMap[tag].get();
+        shader->FinishLink();
+        return shader;
+    }
     else
     {
         SNAKE_ERR("There is no Shader named '" << tag << "'");
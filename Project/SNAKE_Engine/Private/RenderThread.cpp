@@ -0,0 +1,107 @@
+#include "RenderThread.h"
+#include "glfw3.h"
+
+RenderThread* RenderThread::instance = nullptr;
+
+RenderThread::~RenderThread()
+{
+    Stop();
+}
+
+void RenderThread::Start(GLFWwindow* window_, std::function<void()> renderFrame_, std::function<void()> finishFrame_)
+{
+    if (thread.joinable())
+        return;
+
+    window = window_;
+    renderFrame = std::move(renderFrame_);
+    finishFrame = std::move(finishFrame_);
+    mainThreadID = std::this_thread::get_id();
+    stopping = false;
+    isContextOnMain = true;
+    instance = this;
+    thread = std::thread(&RenderThread::Loop, this);
+}
+
+void RenderThread::Sync()
+{
+    if (instance)
+        instance->WaitForFrame();
+}
+
+void RenderThread::WaitForFrame()
+{
+    if (isContextOnMain || std::this_thread::get_id() != mainThreadID)
+        return;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [this]() { return !hasFrame; });
+    }
+    if (window)
+        glfwMakeContextCurrent(window);
+    isContextOnMain = true;
+
+    if (isFrameUnfinished)
+    {
+        isFrameUnfinished = false;
+        finishFrame();
+    }
+}
+
+void RenderThread::Kick()
+{
+    if (!thread.joinable())
+        return;
+
+    WaitForFrame();
+    if (window)
+        glfwMakeContextCurrent(nullptr);
+    isContextOnMain = false;
+    isFrameUnfinished = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        hasFrame = true;
+    }
+    wakeCondition.notify_one();
+}
+
+void RenderThread::Stop()
+{
+    if (!thread.joinable())
+        return;
+
+    WaitForFrame();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_one();
+    thread.join();
+    instance = nullptr;
+}
+
+void RenderThread::Loop()
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [this]() { return hasFrame || stopping; });
+            if (!hasFrame)
+                return;
+        }
+
+        if (window)
+            glfwMakeContextCurrent(window);
+        renderFrame();
+        if (window)
+            glfwMakeContextCurrent(nullptr);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            hasFrame = false;
+        }
+        doneCondition.notify_one();
+    }
+}
@@ -0,0 +1,122 @@
+#include "ResolutionScaler.h"
+#include <algorithm>
+#include <cmath>
+#include "gl.h"
+#include "glm.hpp"
+
+#include "Debug.h"
+#include "GLState.h"
+#include "Shader.h"
+
+ResolutionScaler::~ResolutionScaler()
+{
+    Free();
+}
+
+void ResolutionScaler::Init(Shader* upscaleShader_)
+{
+    upscaleShader = upscaleShader_;
+    glCreateVertexArrays(1, &vertexArray);
+}
+
+void ResolutionScaler::Update(const DynamicResolutionSettings& settings, double gpuMs)
+{
+    const float minScale = std::clamp(settings.minScale, 0.1f, 1.0f);
+    const float maxScale = std::clamp(settings.maxScale, minScale, 1.0f);
+    if (gpuMs > 0.0 && settings.budgetMs > 0.0)
+    {
+        // GPU time of a fill-bound frame follows the pixel count, i.e. the square of the scale.
+        if (gpuMs > settings.budgetMs)
+        {
+            const float target = scale * static_cast<float>(std::sqrt(settings.budgetMs / gpuMs));
+            scale = std::max(target, scale - SCALE_DOWN_STEP);
+        }
+        else if (gpuMs < settings.budgetMs * HEADROOM)
+        {
+            const float target = scale * static_cast<float>(std::sqrt(settings.budgetMs * HEADROOM / gpuMs));
+            scale = std::min(target, scale + SCALE_UP_STEP);
+        }
+    }
+    scale = std::clamp(scale, minScale, maxScale);
+}
+
+bool ResolutionScaler::PrepareTarget(int width, int height)
+{
+    if (framebuffer && targetWidth == width && targetHeight == height)
+        return true;
+
+    if (framebuffer)
+        glDeleteFramebuffers(1, &framebuffer);
+    if (texture)
+        GLState::DeleteTexture(texture);
+    framebuffer = 0;
+    texture = 0;
+    targetWidth = width;
+    targetHeight = height;
+    if (width <= 0 || height <= 0)
+        return false;
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    glTextureStorage2D(texture, 1, GL_RGBA8, width, height);
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glCreateFramebuffers(1, &framebuffer);
+    glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT0, texture, 0);
+    if (glCheckNamedFramebufferStatus(framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        SNAKE_ERR("Dynamic resolution framebuffer (" << width << "x" << height << ") is incomplete; rendering at native resolution.");
+        glDeleteFramebuffers(1, &framebuffer);
+        GLState::DeleteTexture(texture);
+        framebuffer = 0;
+        texture = 0;
+        return false;
+    }
+    return true;
+}
+
+void ResolutionScaler::BindTarget(int sceneWidth, int sceneHeight) const
+{
+    const GLfloat transparent[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glClearNamedFramebufferfv(framebuffer, GL_COLOR, 0, transparent);
+    glViewport(0, 0, sceneWidth, sceneHeight);
+}
+
+void ResolutionScaler::Upscale(int sceneWidth, int sceneHeight, int windowWidth, int windowHeight) const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, windowWidth, windowHeight);
+    if (!texture)
+        return;
+
+    upscaleShader->Use();
+    upscaleShader->SendUniform("u_SourceSize", glm::vec2(sceneWidth, sceneHeight));
+    upscaleShader->SendUniform("u_OutputSize", glm::vec2(windowWidth, windowHeight));
+    GLState::BindTextureUnit(0, texture);
+    GLState::BindVertexArray(vertexArray);
+    glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void ResolutionScaler::Free()
+{
+    if (framebuffer)
+    {
+        glDeleteFramebuffers(1, &framebuffer);
+        framebuffer = 0;
+    }
+    if (texture)
+    {
+        GLState::DeleteTexture(texture);
+        texture = 0;
+    }
+    if (vertexArray)
+    {
+        GLState::DeleteVertexArray(vertexArray);
+        vertexArray = 0;
+    }
+}
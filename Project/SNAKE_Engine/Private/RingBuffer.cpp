@@ -0,0 +1,153 @@
+#include "RingBuffer.h"
+#include "gl.h"
+
+#include "Debug.h"
+#include "GLState.h"
+
+namespace
+{
+    size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+RingBuffer::~RingBuffer()
+{
+    Free();
+}
+
+void RingBuffer::Init(size_t bytesPerFrame)
+{
+    CreateStorage(AlignUp(bytesPerFrame, DEFAULT_ALIGNMENT));
+}
+
+void RingBuffer::CreateStorage(size_t bytesPerFrame)
+{
+    regionSize = bytesPerFrame;
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glCreateBuffers(1, &buffer);
+    glNamedBufferStorage(buffer, static_cast<GLsizeiptr>(regionSize * FRAME_COUNT), nullptr, flags);
+    mappedData = static_cast<unsigned char*>(glMapNamedBufferRange(buffer, 0, static_cast<GLsizeiptr>(regionSize * FRAME_COUNT), flags));
+    if (!mappedData)
+        SNAKE_ERR("Failed to persistently map ring buffer (" << regionSize * FRAME_COUNT << " bytes)");
+
+    currentRegion = 0;
+    head = 0;
+}
+
+void RingBuffer::WaitForRegion(int region)
+{
+    GLsync& fence = fences[region];
+    if (!fence)
+        return;
+
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        ++frameStats.fenceStalls;
+        do
+        {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000);
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    if (result == GL_WAIT_FAILED)
+        SNAKE_ERR("glClientWaitSync failed on ring buffer region " << region);
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void RingBuffer::BeginFrame()
+{
+    frameStats = {};
+    WaitForRegion(currentRegion);
+    head = 0;
+}
+
+void RingBuffer::SubmitFence()
+{
+    fences[currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void RingBuffer::EndFrame()
+{
+    currentRegion = (currentRegion + 1) % FRAME_COUNT;
+
+    if (!retiredBuffers.empty())
+    {
+        GLState::DeleteBuffers(static_cast<GLsizei>(retiredBuffers.size()), retiredBuffers.data());
+        retiredBuffers.clear();
+    }
+    lastFrameStats = frameStats;
+}
+
+RingAllocation RingBuffer::Allocate(size_t size, size_t alignment)
+{
+    size_t offset = AlignUp(head, alignment);
+    if (offset + size > regionSize)
+    {
+        Grow(offset + size);
+        offset = AlignUp(head, alignment);
+    }
+
+    head = offset + size;
+    frameStats.bytesStreamed += size;
+
+    const size_t absoluteOffset = static_cast<size_t>(currentRegion) * regionSize + offset;
+    return { buffer, absoluteOffset, mappedData + absoluteOffset };
+}
+
+void RingBuffer::Grow(size_t requiredBytes)
+{
+    size_t newSize = regionSize ? regionSize : DEFAULT_ALIGNMENT;
+    while (newSize < requiredBytes)
+        newSize *= 2;
+
+    SNAKE_LOG("Ring buffer grown: " << regionSize << " -> " << newSize << " bytes per frame");
+
+    // Allocations made earlier this frame still reference the old storage, so it stays alive until EndFrame.
+    for (GLsync& fence : fences)
+    {
+        if (fence)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (buffer)
+    {
+        glUnmapNamedBuffer(buffer);
+        retiredBuffers.push_back(buffer);
+        buffer = 0;
+        mappedData = nullptr;
+    }
+
+    ++frameStats.growCount;
+    CreateStorage(newSize);
+}
+
+void RingBuffer::Free()
+{
+    for (GLsync& fence : fences)
+    {
+        if (fence)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (buffer)
+    {
+        glUnmapNamedBuffer(buffer);
+        GLState::DeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+    if (!retiredBuffers.empty())
+    {
+        GLState::DeleteBuffers(static_cast<GLsizei>(retiredBuffers.size()), retiredBuffers.data());
+        retiredBuffers.clear();
+    }
+    mappedData = nullptr;
+}
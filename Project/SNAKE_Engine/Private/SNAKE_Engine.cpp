@@ -1,6 +1,8 @@
 #define GLAD_GL_IMPLEMENTATION
 #include "gl.h"
 #include "glfw3.h"
+#include <algorithm>
+#include <cmath>
 #ifdef _DEBUG
 //#include<vld.h>//TODO: remove this and directories before release (VC++ Directories -> Include Directories & Library Directories)
 #endif
@@ -9,6 +11,7 @@
 
 #include "Debug.h"
 #include "EngineTimer.h"
+#include "ProgramCache.h"
 
 
 void SNAKE_Engine::SetEngineContext()
@@ -22,9 +25,9 @@ void SNAKE_Engine::SetEngineContext()
 }
 
 
-bool SNAKE_Engine::Init(int windowWidth, int windowHeight)
+bool SNAKE_Engine::Init(const EngineConfig& config)
 {
-    if (!windowManager.Init(windowWidth, windowHeight, *this))
+    if (!windowManager.Init(config.windowWidth, config.windowHeight, config.backend, *this))
     {
         SNAKE_ERR("Window Initialization failed.");
         return false;
@@ -32,19 +35,43 @@ bool SNAKE_Engine::Init(int windowWidth, int windowHeight)
     SetEngineContext();
     inputManager.Init(windowManager.GetHandle());
     soundManager.Init();
+    ProgramCache::SetDirectory(config.shaderCacheDirectory);
     renderManager.Init(engineContext);
+    useRenderThread = config.useRenderThread;
+    tickRate = config.tickRate;
+    maxTicksPerFrame = std::max(config.maxTicksPerFrame, 1);
+    frameLimit = config.frameLimit;
 
     return true;
 }
 
+bool SNAKE_Engine::Init(int windowWidth, int windowHeight)
+{
+    EngineConfig config;
+    config.windowWidth = windowWidth;
+    config.windowHeight = windowHeight;
+    return Init(config);
+}
+
 
 void SNAKE_Engine::Run()
 {
+    if (useRenderThread)
+    {
+        // A headless window has no context to hand over, but the thread still splits recording from execution.
+        renderThread.Start(windowManager.isHeadless ? nullptr : windowManager.GetHandle(),
+            [this]() { RenderFrame(); },
+            [this]() { renderManager.FinishFrame(); });
+    }
+
     EngineTimer timer;
     timer.Start();
-    while (shouldRun && !glfwWindowShouldClose(windowManager.GetHandle()))
+    double accumulator = 0.0;
+    int frameCount = 0;
+    while (shouldRun && !glfwWindowShouldClose(windowManager.GetHandle()) && (frameLimit <= 0 || frameCount < frameLimit))
     {
-        float dt = timer.Tick();
+        ++frameCount;
+        const double dt = timer.Tick();
 
         float fps = 0.0f;
         if (timer.ShouldUpdateFPS(fps))
@@ -53,23 +80,54 @@ void SNAKE_Engine::Run()
         }
 
         windowManager.PollEvents();
-        inputManager.Update();
-        windowManager.ClearScreen();
+        if (!useRenderThread)
+            windowManager.ClearScreen();
 
-        stateManager.Update(dt, engineContext);
+        if (tickRate > 0.0)
+        {
+            const double tickTime = 1.0 / tickRate;
+            accumulator += dt;
+            int tickCount = 0;
+            while (accumulator >= tickTime && tickCount < maxTicksPerFrame)
+            {
+                inputManager.Update();
+                stateManager.Update(static_cast<float>(tickTime), engineContext);
+                accumulator -= tickTime;
+                ++tickCount;
+            }
+            if (accumulator >= tickTime)
+                accumulator = std::fmod(accumulator, tickTime);
+            interpolationAlpha = static_cast<float>(accumulator / tickTime);
+        }
+        else
+        {
+            inputManager.Update();
+            stateManager.Update(static_cast<float>(dt), engineContext);
+        }
         stateManager.Draw(engineContext);
 
         soundManager.Update();
 
-        windowManager.SwapBuffers();
+        if (useRenderThread)
+            renderThread.Kick();
+        else
+            windowManager.SwapBuffers();
     }
 
+    renderThread.Stop();
     soundManager.Free();
     stateManager.Free(engineContext);
     windowManager.Free();
     Free();
 }
 
+void SNAKE_Engine::RenderFrame()
+{
+    windowManager.ClearScreen();
+    renderManager.ExecuteFrame(engineContext);
+    windowManager.SwapBuffers();
+}
+
 void SNAKE_Engine::Free() const
 {
     glfwTerminate();
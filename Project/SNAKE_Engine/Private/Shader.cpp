@@ -1,10 +1,18 @@
 #include "Shader.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iosfwd>
 #include <sstream>
 #include <fstream>
 #include "gl.h"
+#include "glfw3.h"
 
+#include "CameraBuffer.h"
 #include "Debug.h"
+#include "GLState.h"
+#include "ProgramCache.h"
+#include "RenderThread.h"
 
 
 namespace
@@ -35,39 +43,79 @@ namespace
         }
         return "Unknown";
     }
+
+    uint32_t nextShaderSortID = 0;
+
+    // GL_KHR_parallel_shader_compile / GL_ARB_parallel_shader_compile; the generated loader does not include them.
+    constexpr GLenum COMPLETION_STATUS = 0x91B1;
+    using MaxShaderCompilerThreadsProc = void (GLAD_API_PTR*)(GLuint count);
+    int parallelCompileSupport = -1; // Queried on first use.
+
+    bool HasParallelCompile()
+    {
+        if (parallelCompileSupport >= 0)
+            return parallelCompileSupport == 1;
+
+        parallelCompileSupport = 0;
+        GLint extensionCount = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+        const char* setThreads = nullptr;
+        for (GLint i = 0; i < extensionCount && !setThreads; ++i)
+        {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+            if (!name)
+                continue;
+            if (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0)
+                setThreads = "glMaxShaderCompilerThreadsKHR";
+            else if (std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0)
+                setThreads = "glMaxShaderCompilerThreadsARB";
+        }
+        if (!setThreads)
+            return false;
+
+        parallelCompileSupport = 1;
+        // Lets the driver use as many compiler threads as it likes.
+        if (auto maxThreads = reinterpret_cast<MaxShaderCompilerThreadsProc>(glfwGetProcAddress(setThreads)))
+            maxThreads(0xFFFFFFFFu);
+        return true;
+    }
 }
-Shader::Shader() : programID(0), isSupportInstancing(false)
+Shader::Shader() : programID(0), sortID(nextShaderSortID++), instanceLayout(InstanceLayout::None)
 {
+    RenderThread::Sync();
     programID = glCreateProgram();
 }
 
 Shader::~Shader()
 {
+    RenderThread::Sync();
     for (GLuint shader : attachedShaders)
         glDeleteShader(shader);
-    glDeleteProgram(programID);
+    GLState::DeleteProgram(programID);
 }
 
 void Shader::AttachFromFile(ShaderStage stage, const FilePath& path)
 {
-    std::string src = LoadShaderSource(path);
-    GLuint shader = CompileShader(stage, src);
-    glAttachShader(programID, shader);
-    attachedShaders.push_back(shader);
     attachedStages.push_back(stage);
+    attachedSources.push_back(LoadShaderSource(path));
 }
 
 void Shader::AttachFromSource(ShaderStage stage, const std::string& source)
 {
-    GLuint shader = CompileShader(stage, source);
-    glAttachShader(programID, shader);
-    attachedShaders.push_back(shader);
     attachedStages.push_back(stage);
+    attachedSources.push_back(source);
 }
 
 
 void Shader::Link()
 {
+    BeginLink();
+    FinishLink();
+}
+
+void Shader::BeginLink()
+{
+    RenderThread::Sync();
     bool hasTCS = false;
     bool hasTES = false;
 
@@ -82,38 +130,99 @@ void Shader::Link()
         SNAKE_ERR("[Shader] Tessellation shaders must come in pairs (TCS + TES).");
         return;
     }
-    glLinkProgram(programID);
 
-    GLint success;
-    glGetProgramiv(programID, GL_LINK_STATUS, &success);
-    if (!success)
+    const auto linkStart = std::chrono::steady_clock::now();
+    HasParallelCompile();
+    const bool useCache = ProgramCache::IsEnabled();
+    cacheKey = useCache ? ProgramCache::MakeKey(attachedStages, attachedSources) : 0;
+    isLoadedFromCache = useCache && ProgramCache::Load(programID, cacheKey);
+    if (!isLoadedFromCache)
     {
-        char infoLog[1024];
-        glGetProgramInfoLog(programID, 1024, nullptr, infoLog);
-        SNAKE_ERR("Shader program link error:\n" << infoLog);
+        // No status is queried here, so the driver can keep compiling while the caller moves on.
+        for (size_t i = 0; i < attachedStages.size(); ++i)
+        {
+            GLuint shader = CompileShader(attachedStages[i], attachedSources[i]);
+            glAttachShader(programID, shader);
+            attachedShaders.push_back(shader);
+        }
+        if (useCache)
+            ProgramCache::PrepareForStore(programID);
+        glLinkProgram(programID);
+    }
+    attachedSources.clear();
+    isLinkPending = true;
+    blockedLinkMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - linkStart).count();
+}
+
+bool Shader::IsLinkComplete() const
+{
+    if (!isLinkPending || isLoadedFromCache)
+        return true;
+    if (!HasParallelCompile())
+        return false;
+    GLint isComplete = GL_FALSE;
+    glGetProgramiv(programID, COMPLETION_STATUS, &isComplete);
+    return isComplete == GL_TRUE;
+}
+
+void Shader::FinishLink()
+{
+    if (!isLinkPending)
+        return;
+    RenderThread::Sync();
+    isLinkPending = false;
+
+    const auto finishStart = std::chrono::steady_clock::now();
+    if (!isLoadedFromCache)
+    {
+        for (size_t i = 0; i < attachedShaders.size(); ++i)
+            CheckCompileStatus(attachedShaders[i], attachedStages[i]);
+
+        GLint success;
+        glGetProgramiv(programID, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            char infoLog[1024];
+            glGetProgramInfoLog(programID, 1024, nullptr, infoLog);
+            SNAKE_ERR("Shader program link error:\n" << infoLog);
+        }
+        else if (ProgramCache::IsEnabled())
+        {
+            ProgramCache::Store(programID, cacheKey);
+        }
     }
 
     CheckSupportsInstancing();
+    ReflectUniforms();
+    supportsUVTransform = GetUniformLocation(MakeUniformID("u_UVOffset")) != -1 && GetUniformLocation(MakeUniformID("u_UVScale")) != -1;
+
+    const GLuint cameraBlock = glGetUniformBlockIndex(programID, "CameraBlock");
+    usesCameraBlock = cameraBlock != GL_INVALID_INDEX;
+    if (usesCameraBlock)
+        glUniformBlockBinding(programID, cameraBlock, CameraBuffer::BINDING);
 
     for (GLuint shader : attachedShaders)
     {
         glDetachShader(programID, shader);
     }
+
+    blockedLinkMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - finishStart).count();
+    ProgramCache::RecordLink(isLoadedFromCache, blockedLinkMs);
 }
 
 void Shader::Use() const
 {
-    glUseProgram(programID);
+    GLState::UseProgram(programID);
 }
 
 void Shader::Unuse() const
 {
-    glUseProgram(0);
+    GLState::UseProgram(0);
 }
 
 void Shader::SendUniform(const std::string& name, int value) const
 {
-    GLint location = glGetUniformLocation(programID, name.c_str());
+    GLint location = GetUniformLocation(MakeUniformID(name));
     if (location == -1)
     {
         SNAKE_ERR("[Shader] Uniform not found: " << name);
@@ -124,7 +233,7 @@ void Shader::SendUniform(const std::string& name, int value) const
 
 void Shader::SendUniform(const std::string& name, float value) const
 {
-    GLint location = glGetUniformLocation(programID, name.c_str());
+    GLint location = GetUniformLocation(MakeUniformID(name));
     if (location == -1)
     {
         SNAKE_WRN("[Shader] Uniform not found: " << name);
@@ -135,7 +244,7 @@ void Shader::SendUniform(const std::string& name, float value) const
 
 void Shader::SendUniform(const std::string& name, const glm::vec2& value) const
 {
-    GLint location = glGetUniformLocation(programID, name.c_str());
+    GLint location = GetUniformLocation(MakeUniformID(name));
     if (location == -1)
     {
         SNAKE_WRN("Uniform not found: " << name);
@@ -147,7 +256,7 @@ void Shader::SendUniform(const std::string& name, const glm::vec2& value) const
 
 void Shader::SendUniform(const std::string& name, const glm::vec3& value) const
 {
-    GLint location = glGetUniformLocation(programID, name.c_str());
+    GLint location = GetUniformLocation(MakeUniformID(name));
     if (location == -1)
     {
         SNAKE_WRN("Uniform not found: " << name);
@@ -159,7 +268,7 @@ void Shader::SendUniform(const std::string& name, const glm::vec3& value) const
 
 void Shader::SendUniform(const std::string& name, const glm::vec4& value) const
 {
-    GLint location = glGetUniformLocation(programID, name.c_str());
+    GLint location = GetUniformLocation(MakeUniformID(name));
     if (location == -1)
     {
         SNAKE_WRN("Uniform not found: " << name);
@@ -171,7 +280,7 @@ void Shader::SendUniform(const std::string& name, const glm::vec4& value) const
 
 void Shader::SendUniform(const std::string& name, const glm::mat4& value) const
 {
-    GLint location = glGetUniformLocation(programID, name.c_str());
+    GLint location = GetUniformLocation(MakeUniformID(name));
     if (location == -1)
     {
         SNAKE_WRN("Uniform not found: " << name);
@@ -181,16 +290,68 @@ void Shader::SendUniform(const std::string& name, const glm::mat4& value) const
     glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]);
 }
 
+GLint Shader::GetUniformLocation(UniformID id) const
+{
+    auto it = std::lower_bound(uniformLocations.begin(), uniformLocations.end(), id,
+        [](const UniformLocation& entry, UniformID value) { return entry.id < value; });
+    return it != uniformLocations.end() && it->id == id ? it->location : -1;
+}
+
 bool Shader::SupportsInstancing() const
 {
-    return isSupportInstancing;
+    return instanceLayout != InstanceLayout::None;
 }
 
 
 void Shader::CheckSupportsInstancing()
 {
-    GLint loc = glGetAttribLocation(programID, "i_Model");
-    isSupportInstancing = loc != -1;
+    if (glGetAttribLocation(programID, "i_Model") != -1)
+        instanceLayout = InstanceLayout::Full;
+    else if (glGetAttribLocation(programID, "i_AffineRow0") != -1)
+        instanceLayout = InstanceLayout::Compact;
+    else if (glGetAttribLocation(programID, "i_Slot") != -1)
+        instanceLayout = InstanceLayout::Resident;
+    else
+        instanceLayout = InstanceLayout::None;
+
+    usesTextureLayer = instanceLayout != InstanceLayout::None && glGetAttribLocation(programID, "i_TextureLayer") != -1;
+}
+
+void Shader::ReflectUniforms()
+{
+    uniformLocations.clear();
+
+    GLint uniformCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramInterfaceiv(programID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+    glGetProgramInterfaceiv(programID, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+
+    std::string name(static_cast<size_t>(std::max(maxNameLength, 1)), '\0');
+    for (GLint i = 0; i < uniformCount; ++i)
+    {
+        const GLenum property = GL_LOCATION;
+        GLint location = -1;
+        glGetProgramResourceiv(programID, GL_UNIFORM, static_cast<GLuint>(i), 1, &property, 1, nullptr, &location);
+        if (location == -1)
+            continue; // Member of a uniform block.
+
+        GLsizei length = 0;
+        glGetProgramResourceName(programID, GL_UNIFORM, static_cast<GLuint>(i), maxNameLength, &length, name.data());
+        const std::string_view uniformName(name.data(), static_cast<size_t>(length));
+        uniformLocations.push_back({ MakeUniformID(uniformName), location });
+
+        // Arrays are reported as "name[0]"; like glGetUniformLocation, accept the bare name as well.
+        if (uniformName.size() > 3 && uniformName.substr(uniformName.size() - 3) == "[0]")
+            uniformLocations.push_back({ MakeUniformID(uniformName.substr(0, uniformName.size() - 3)), location });
+    }
+
+    std::sort(uniformLocations.begin(), uniformLocations.end(),
+        [](const UniformLocation& a, const UniformLocation& b) { return a.id < b.id; });
+    for (size_t i = 1; i < uniformLocations.size(); ++i)
+    {
+        if (uniformLocations[i].id == uniformLocations[i - 1].id)
+            SNAKE_ERR("[Shader] Two active uniforms share the ID " << uniformLocations[i].id << "; rename one of them.");
+    }
 }
 
 std::string Shader::LoadShaderSource(const FilePath& filepath)
@@ -209,13 +370,18 @@ std::string Shader::LoadShaderSource(const FilePath& filepath)
 
 GLuint Shader::CompileShader(ShaderStage stage, const std::string& source)
 {
+    RenderThread::Sync();
     GLenum glStage = ConvertShaderStageToGLenum(stage);
     GLuint shader = glCreateShader(glStage);
 
     const char* src = source.c_str();
     glShaderSource(shader, 1, &src, nullptr);
     glCompileShader(shader);
+    return shader;
+}
 
+void Shader::CheckCompileStatus(GLuint shader, ShaderStage stage) const
+{
     GLint success;
     glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
     if (!success)
@@ -224,6 +390,4 @@ GLuint Shader::CompileShader(ShaderStage stage, const std::string& source)
         glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
         SNAKE_ERR("[Shader] Compilation failed (" << ShaderStageToString(stage) << "):\n" << infoLog);
     }
-
-    return shader;
 }
@@ -0,0 +1,92 @@
+#include "SpriteBatcher.h"
+#include <algorithm>
+#include "ext/matrix_transform.hpp"
+#include "gl.h"
+
+#include "DrawItem.h"
+#include "GLState.h"
+#include "Mesh.h"
+#include "Object.h"
+
+namespace
+{
+    uint8_t PackUnorm8(float value)
+    {
+        return static_cast<uint8_t>(glm::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+}
+
+SpriteBatcher::~SpriteBatcher()
+{
+    Free();
+}
+
+void SpriteBatcher::Init()
+{
+    glCreateVertexArrays(1, &vao);
+
+    glEnableVertexArrayAttrib(vao, 0); // position
+    glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(SpriteVertex, position));
+    glVertexArrayAttribBinding(vao, 0, 0);
+
+    glEnableVertexArrayAttrib(vao, 1); // uv
+    glVertexArrayAttribFormat(vao, 1, 2, GL_FLOAT, GL_FALSE, offsetof(SpriteVertex, uv));
+    glVertexArrayAttribBinding(vao, 1, 0);
+
+    glEnableVertexArrayAttrib(vao, COLOR_LOCATION);
+    glVertexArrayAttribFormat(vao, COLOR_LOCATION, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(SpriteVertex, color));
+    glVertexArrayAttribBinding(vao, COLOR_LOCATION, 0);
+}
+
+void SpriteBatcher::Measure(const DrawItem* items, size_t count, size_t& outVertexCount, size_t& outIndexCount)
+{
+    outVertexCount = 0;
+    outIndexCount = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Mesh* mesh = items[i].object->GetMesh();
+        outVertexCount += mesh->bakeVertices.size();
+        outIndexCount += mesh->bakeIndices.size();
+    }
+}
+
+void SpriteBatcher::Write(const DrawItem* items, size_t count, float alpha, SpriteVertex* vertices, uint32_t* indices)
+{
+    uint32_t baseVertex = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Object* obj = items[i].object;
+        const Mesh* mesh = obj->GetMesh();
+        const glm::mat4 model = obj->GetInterpolatedTransform2DMatrix(alpha) * glm::scale(glm::mat4(1.0f), glm::vec3(obj->GetUVFlipVector(), 1.0f));
+        const glm::vec4 uvRect = obj->GetUVRect();
+        const glm::vec4& color = obj->GetColor();
+        const uint8_t packedColor[4] = { PackUnorm8(color.r), PackUnorm8(color.g), PackUnorm8(color.b), PackUnorm8(color.a) };
+
+        for (const Vertex& vertex : mesh->bakeVertices)
+        {
+            SpriteVertex& out = *vertices++;
+            out.position = glm::vec3(model * glm::vec4(vertex.position, 1.0f));
+            out.uv = vertex.uv * glm::vec2(uvRect.z, uvRect.w) + glm::vec2(uvRect.x, uvRect.y);
+            std::copy_n(packedColor, 4, out.color);
+        }
+        for (unsigned int index : mesh->bakeIndices)
+            *indices++ = baseVertex + index;
+        baseVertex += static_cast<uint32_t>(mesh->bakeVertices.size());
+    }
+}
+
+void SpriteBatcher::Bind(GLuint buffer, size_t vertexOffset) const
+{
+    glVertexArrayVertexBuffer(vao, 0, buffer, static_cast<GLintptr>(vertexOffset), sizeof(SpriteVertex));
+    glVertexArrayElementBuffer(vao, buffer);
+    GLState::BindVertexArray(vao);
+}
+
+void SpriteBatcher::Free()
+{
+    if (vao)
+    {
+        GLState::DeleteVertexArray(vao);
+        vao = 0;
+    }
+}
@@ -3,6 +3,7 @@
 #include "EngineContext.h"
 #include "WindowManager.h"
 #include "RenderManager.h"
+#include "RenderThread.h"
 #include "SNAKE_Engine.h"
 GameState* StateManager::GetCurrentState() const
 {
@@ -18,6 +19,8 @@ void StateManager::Update(float dt, const EngineContext& engineContext)
 {
 	if (nextState != nullptr)
 	{
+		// Loading and freeing create and delete GL resources the frame in flight may still use.
+		RenderThread::Sync();
 		if (currentState != nullptr)
 		{
 			currentState->SystemFree(engineContext);
@@ -37,12 +40,12 @@ void StateManager::Update(float dt, const EngineContext& engineContext)
 
 void StateManager::Draw(const EngineContext& engineContext)
 {
+	// No Sync here: culling and building draw items overlap the frame in flight. FlushDrawCommands
+	// and StaticBatcher take the context back once they touch GL or data that frame still reads.
 	if (currentState != nullptr)
 	{
-		currentState->Draw(engineContext);
+		currentState->SystemDraw(engineContext);
 		engineContext.renderManager->FlushDrawCommands(engineContext);
-                if (engineContext.engine->ShouldRenderDebugDraws())
-		    engineContext.renderManager->FlushDebugLineDrawCommands(engineContext);
 	}
 }
 
@@ -0,0 +1,322 @@
+#include "StaticBatcher.h"
+#include <cmath>
+#include <limits>
+#include "ext/matrix_transform.hpp"
+#include "gl.h"
+
+#include "GLState.h"
+#include "Material.h"
+#include "Mesh.h"
+#include "Object.h"
+#include "RenderLayerManager.h"
+#include "RenderThread.h"
+
+namespace
+{
+    constexpr uint32_t INVALID_MEMBER = UINT32_MAX;
+
+    uint32_t PackColor(const glm::vec4& color)
+    {
+        const glm::vec4 scaled = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+        return static_cast<uint32_t>(scaled.r) | static_cast<uint32_t>(scaled.g) << 8 |
+            static_cast<uint32_t>(scaled.b) << 16 | static_cast<uint32_t>(scaled.a) << 24;
+    }
+}
+
+size_t StaticBatcher::ChunkKeyHash::operator()(const ChunkKey& key) const
+{
+    size_t hash = std::hash<Material*>()(key.material);
+    auto combine = [&](size_t value) { hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2); };
+    combine(std::hash<Camera2D*>()(key.referenceCamera));
+    combine(key.color);
+    combine(static_cast<uint32_t>(key.cellX));
+    combine(static_cast<uint32_t>(key.cellY));
+    combine(static_cast<size_t>(key.layer) << 1 | static_cast<size_t>(key.ignoreCamera));
+    return hash;
+}
+
+StaticBatcher::~StaticBatcher()
+{
+    Clear();
+}
+
+bool StaticBatcher::CanBake(Object* obj, const RenderLayerManager& layers)
+{
+    if (!obj || !obj->IsAlive() || obj->GetType() != ObjectType::GAME || obj->HasAnimation())
+        return false;
+    if (!obj->IsStatic() && !layers.IsStatic(obj->GetRenderLayer()))
+        return false;
+
+    const Mesh* mesh = obj->GetMesh();
+    const Material* material = obj->GetMaterial();
+    return mesh && material && mesh->CanBeBaked() && !material->IsInstancingSupported();
+}
+
+bool StaticBatcher::HasChanged(const Member& member, Object* obj) const
+{
+    return member.transformVersion != obj->GetTransform2D().GetVersion() ||
+        member.isVisible != obj->IsVisible() ||
+        member.mesh != obj->GetMesh() ||
+        member.material != obj->GetMaterial() ||
+        member.layer != obj->GetRenderLayer() ||
+        member.ignoreCamera != obj->ShouldIgnoreCamera() ||
+        member.color != obj->GetColor() ||
+        member.flipX != obj->flipUV_X ||
+        member.flipY != obj->flipUV_Y;
+}
+
+void StaticBatcher::Snapshot(Member& member, Object* obj) const
+{
+    member.transformVersion = obj->GetTransform2D().GetVersion();
+    member.isVisible = obj->IsVisible();
+    member.mesh = obj->GetMesh();
+    member.material = obj->GetMaterial();
+    member.layer = obj->GetRenderLayer();
+    member.ignoreCamera = obj->ShouldIgnoreCamera();
+    member.color = obj->GetColor();
+    member.flipX = obj->flipUV_X;
+    member.flipY = obj->flipUV_Y;
+}
+
+StaticBatcher::ChunkKey StaticBatcher::MakeChunkKey(Object* obj) const
+{
+    ChunkKey key{};
+    key.material = obj->GetMaterial()->GetBatchMaterial();
+    key.color = PackColor(obj->GetColor());
+    key.layer = obj->GetRenderLayer();
+    key.ignoreCamera = obj->ShouldIgnoreCamera();
+    if (key.ignoreCamera)
+    {
+        key.referenceCamera = obj->GetReferenceCamera();
+    }
+    else
+    {
+        const glm::vec2& position = obj->GetTransform2D().GetPosition();
+        key.cellX = static_cast<int32_t>(std::floor(position.x / CHUNK_SIZE));
+        key.cellY = static_cast<int32_t>(std::floor(position.y / CHUNK_SIZE));
+    }
+    return key;
+}
+
+void StaticBatcher::Sync(const std::vector<Object*>& objects, const RenderLayerManager& layers, std::vector<Object*>& outDynamic)
+{
+    outDynamic.clear();
+    ++syncGeneration;
+
+    size_t seenCount = 0;
+    for (Object* obj : objects)
+    {
+        const uint32_t memberIndex = obj ? obj->staticBatchMember : INVALID_MEMBER;
+        const bool isMember = memberIndex < members.size() && members[memberIndex].object == obj;
+
+        if (!CanBake(obj, layers))
+        {
+            if (isMember)
+                RemoveMember(memberIndex);
+            outDynamic.push_back(obj);
+            continue;
+        }
+
+        ++seenCount;
+        if (!isMember)
+        {
+            AddMember(obj);
+            continue;
+        }
+
+        Member& member = members[memberIndex];
+        member.lastSeen = syncGeneration;
+        if (!HasChanged(member, obj))
+            continue;
+
+        Snapshot(member, obj);
+        const ChunkKey key = MakeChunkKey(obj);
+        if (key == chunks[member.chunk].key)
+        {
+            Chunk& chunk = chunks[member.chunk];
+            if (!chunk.isDirty)
+            {
+                chunk.isDirty = true;
+                dirtyChunks.push_back(member.chunk);
+            }
+        }
+        else
+        {
+            DetachFromChunk(memberIndex);
+            AttachToChunk(memberIndex, key);
+        }
+    }
+
+    // Members that are no longer in the list were destroyed; only the pointer value is compared.
+    if (seenCount < GetMemberCount())
+    {
+        for (uint32_t memberIndex = 0; memberIndex < members.size(); ++memberIndex)
+        {
+            if (members[memberIndex].object && members[memberIndex].lastSeen != syncGeneration)
+                RemoveMember(memberIndex);
+        }
+    }
+
+    RebuildDirtyChunks();
+}
+
+void StaticBatcher::AddMember(Object* obj)
+{
+    uint32_t memberIndex;
+    if (!freeMembers.empty())
+    {
+        memberIndex = freeMembers.back();
+        freeMembers.pop_back();
+        members[memberIndex] = {};
+    }
+    else
+    {
+        memberIndex = static_cast<uint32_t>(members.size());
+        members.emplace_back();
+    }
+
+    Member& member = members[memberIndex];
+    member.object = obj;
+    member.lastSeen = syncGeneration;
+    Snapshot(member, obj);
+    obj->staticBatchMember = memberIndex;
+
+    AttachToChunk(memberIndex, MakeChunkKey(obj));
+}
+
+void StaticBatcher::RemoveMember(uint32_t memberIndex)
+{
+    DetachFromChunk(memberIndex);
+    members[memberIndex].object = nullptr;
+    freeMembers.push_back(memberIndex);
+}
+
+void StaticBatcher::AttachToChunk(uint32_t memberIndex, const ChunkKey& key)
+{
+    // The frame in flight reads the chunks, so they only change once it is done.
+    RenderThread::Sync();
+    uint32_t chunkIndex;
+    auto it = chunkLookup.find(key);
+    if (it != chunkLookup.end())
+    {
+        chunkIndex = it->second;
+    }
+    else
+    {
+        chunkIndex = static_cast<uint32_t>(chunks.size());
+        Chunk& chunk = chunks.emplace_back();
+        chunk.key = key;
+        chunk.color = members[memberIndex].color;
+        chunkLookup.emplace(key, chunkIndex);
+    }
+
+    Chunk& chunk = chunks[chunkIndex];
+    Member& member = members[memberIndex];
+    member.chunk = chunkIndex;
+    member.indexInChunk = static_cast<uint32_t>(chunk.members.size());
+    chunk.members.push_back(memberIndex);
+
+    if (!chunk.isDirty)
+    {
+        chunk.isDirty = true;
+        dirtyChunks.push_back(chunkIndex);
+    }
+}
+
+void StaticBatcher::DetachFromChunk(uint32_t memberIndex)
+{
+    RenderThread::Sync();
+    const Member& member = members[memberIndex];
+    const uint32_t chunkIndex = member.chunk;
+    Chunk& chunk = chunks[chunkIndex];
+
+    const uint32_t movedIndex = chunk.members.back();
+    chunk.members[member.indexInChunk] = movedIndex;
+    members[movedIndex].indexInChunk = member.indexInChunk;
+    chunk.members.pop_back();
+
+    if (!chunk.isDirty)
+    {
+        chunk.isDirty = true;
+        dirtyChunks.push_back(chunkIndex);
+    }
+}
+
+void StaticBatcher::RebuildDirtyChunks()
+{
+    if (!dirtyChunks.empty())
+        RenderThread::Sync();
+    for (uint32_t chunkIndex : dirtyChunks)
+    {
+        RebuildChunk(chunks[chunkIndex]);
+        chunks[chunkIndex].isDirty = false;
+    }
+    lastRebuildCount = dirtyChunks.size();
+    dirtyChunks.clear();
+}
+
+void StaticBatcher::RebuildChunk(Chunk& chunk)
+{
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    glm::vec2 boundsMin(std::numeric_limits<float>::max());
+    glm::vec2 boundsMax(std::numeric_limits<float>::lowest());
+
+    for (uint32_t memberIndex : chunk.members)
+    {
+        const Member& member = members[memberIndex];
+        if (!member.isVisible)
+            continue;
+
+        Object* obj = member.object;
+        const glm::mat4 model = obj->GetTransform2DMatrix() * glm::scale(glm::mat4(1.0f), glm::vec3(obj->GetUVFlipVector(), 1.0f));
+        const glm::vec4 uvRect = obj->GetUVRect();
+        const unsigned int baseVertex = static_cast<unsigned int>(vertices.size());
+        for (const Vertex& vertex : member.mesh->bakeVertices)
+        {
+            const glm::vec4 world = model * glm::vec4(vertex.position, 1.0f);
+            vertices.push_back({ glm::vec3(world.x, world.y, vertex.position.z), vertex.uv * glm::vec2(uvRect.z, uvRect.w) + glm::vec2(uvRect.x, uvRect.y) });
+            boundsMin = glm::min(boundsMin, glm::vec2(world));
+            boundsMax = glm::max(boundsMax, glm::vec2(world));
+        }
+        for (unsigned int index : member.mesh->bakeIndices)
+            indices.push_back(baseVertex + index);
+    }
+
+    chunk.indexCount = static_cast<GLsizei>(indices.size());
+    ++chunk.version;
+    chunk.boundsMin = boundsMin;
+    chunk.boundsMax = boundsMax;
+    if (indices.empty())
+        return;
+
+    if (!chunk.vao)
+    {
+        glCreateVertexArrays(1, &chunk.vao);
+        glCreateBuffers(1, &chunk.vbo);
+        glCreateBuffers(1, &chunk.ebo);
+
+        Mesh::SetupVertexFormat(chunk.vao, chunk.vbo);
+        glVertexArrayElementBuffer(chunk.vao, chunk.ebo);
+    }
+
+    glNamedBufferData(chunk.vbo, static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex)), vertices.data(), GL_STATIC_DRAW);
+    glNamedBufferData(chunk.ebo, static_cast<GLsizeiptr>(indices.size() * sizeof(unsigned int)), indices.data(), GL_STATIC_DRAW);
+}
+
+void StaticBatcher::Clear()
+{
+    RenderThread::Sync();
+    for (Chunk& chunk : chunks)
+    {
+        if (chunk.ebo) GLState::DeleteBuffers(1, &chunk.ebo);
+        if (chunk.vbo) GLState::DeleteBuffers(1, &chunk.vbo);
+        if (chunk.vao) GLState::DeleteVertexArray(chunk.vao);
+    }
+    chunks.clear();
+    chunkLookup.clear();
+    dirtyChunks.clear();
+    members.clear();
+    freeMembers.clear();
+    lastRebuildCount = 0;
+}
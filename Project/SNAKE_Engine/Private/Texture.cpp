@@ -2,6 +2,8 @@
 #include "gl.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "Debug.h"
+#include "GLState.h"
+#include "RenderThread.h"
 #include "stb_image.h"
 
 //used anonymous namespace to hide these functions from other files
@@ -32,6 +34,19 @@ static GLint ConvertWrap(TextureWrap wrap)
     return GL_CLAMP_TO_EDGE;
 }
 
+static GLenum ConvertInternalFormat(int channels)
+{
+    switch (channels)
+    {
+    case 1: return GL_R8;
+    case 3: return GL_RGB8;
+    }
+    return GL_RGBA8;
+}
+
+Texture::Texture() :id(0), width(0), height(0), channels(0)
+{
+}
 
 Texture::Texture(const std::string& path, const TextureSettings& settings) :id(0), width(0), height(0), channels(0)
 {
@@ -57,42 +72,102 @@ Texture::Texture(const unsigned char* data, int width_, int height_, int channel
 
 Texture::~Texture()
 {
+    RenderThread::Sync();
     if (id != 0)
     {
-        glDeleteTextures(1, &id);
+        GLState::DeleteTexture(id);
+    }
+}
+
+std::unique_ptr<Texture> Texture::CreateArray(const std::vector<const Texture*>& layers)
+{
+    RenderThread::Sync();
+    if (layers.empty() || !layers.front()->id)
+        return nullptr;
+
+    const Texture* first = layers.front();
+    std::unique_ptr<Texture> array(new Texture());
+    array->width = first->width;
+    array->height = first->height;
+    array->channels = first->channels;
+    array->layerCount = static_cast<int>(layers.size());
+
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &array->id);
+    glTextureStorage3D(array->id, 1, ConvertInternalFormat(first->channels), array->width, array->height, array->layerCount);
+    for (int layer = 0; layer < array->layerCount; ++layer)
+    {
+        const Texture* source = layers[layer];
+        if (!source->id || source->width != array->width || source->height != array->height || source->channels != array->channels)
+        {
+            SNAKE_ERR("Texture array layer " << layer << " does not match the size or format of layer 0.");
+            continue;
+        }
+        glCopyImageSubData(source->id, GL_TEXTURE_2D, 0, 0, 0, 0,
+            array->id, GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, array->width, array->height, 1);
+    }
+
+    array->CopySamplerParameters(*first);
+    return array;
+}
+
+std::unique_ptr<Texture> Texture::CreateBlank(int width, int height, const Texture& settingsSource)
+{
+    std::unique_ptr<Texture> texture(new Texture());
+    texture->width = width;
+    texture->height = height;
+    texture->channels = 4;
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture->id);
+    glTextureStorage2D(texture->id, 1, GL_RGBA8, width, height);
+    texture->CopySamplerParameters(settingsSource);
+    return texture;
+}
+
+std::vector<unsigned char> Texture::ReadPixelsRGBA() const
+{
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTextureImage(id, 0, GL_RGBA, GL_UNSIGNED_BYTE, static_cast<GLsizei>(pixels.size()), pixels.data());
+    return pixels;
+}
+
+bool Texture::IsRepeating() const
+{
+    GLint wrapS = 0, wrapT = 0;
+    glGetTextureParameteriv(id, GL_TEXTURE_WRAP_S, &wrapS);
+    glGetTextureParameteriv(id, GL_TEXTURE_WRAP_T, &wrapT);
+    return wrapS == GL_REPEAT || wrapS == GL_MIRRORED_REPEAT || wrapT == GL_REPEAT || wrapT == GL_MIRRORED_REPEAT;
+}
+
+void Texture::CopySamplerParameters(const Texture& source)
+{
+    for (GLenum parameter : { GL_TEXTURE_MIN_FILTER, GL_TEXTURE_MAG_FILTER, GL_TEXTURE_WRAP_S, GL_TEXTURE_WRAP_T })
+    {
+        GLint value = 0;
+        glGetTextureParameteriv(source.id, parameter, &value);
+        glTextureParameteri(id, parameter, value);
     }
 }
 
 void Texture::BindToUnit(unsigned int unit) const
 {
-    glBindTextureUnit(unit, id);
+    GLState::BindTextureUnit(unit, id);
 }
 
 void Texture::UnBind(unsigned int unit) const
 {
-    glBindTextureUnit(unit, 0);
+    GLState::BindTextureUnit(unit, 0);
 }
 
 void Texture::GenerateTexture(const unsigned char* data, const TextureSettings& settings)
 {
-    GLenum internalFormat = GL_RGBA8;
+    RenderThread::Sync();
+    const GLenum internalFormat = ConvertInternalFormat(channels);
     GLenum pixelFormat = GL_RGBA;
-
     if (channels == 1)
-    {
-        internalFormat = GL_R8;
         pixelFormat = GL_RED;
-    }
     else if (channels == 3)
-    {
-        internalFormat = GL_RGB8;
         pixelFormat = GL_RGB;
-    }
-    else if (channels == 4)
-    {
-        internalFormat = GL_RGBA8;
-        pixelFormat = GL_RGBA;
-    }
 
     glCreateTextures(GL_TEXTURE_2D, 1, &id);
     glTextureStorage2D(id, 1, internalFormat, width, height);
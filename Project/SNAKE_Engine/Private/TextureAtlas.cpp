@@ -0,0 +1,177 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <climits>
+#include "gl.h"
+
+#include "Debug.h"
+#include "Texture.h"
+
+namespace
+{
+    // Copies RGBA8 pixels into the middle of a buffer with PADDING texels on every side, repeating the edge texels.
+    std::vector<unsigned char> MakePaddedPixels(const std::vector<unsigned char>& source, int width, int height)
+    {
+        const int paddedWidth = width + TextureAtlas::PADDING * 2;
+        const int paddedHeight = height + TextureAtlas::PADDING * 2;
+
+        std::vector<unsigned char> padded(static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+        for (int y = 0; y < paddedHeight; ++y)
+        {
+            const int sourceY = std::clamp(y - TextureAtlas::PADDING, 0, height - 1);
+            for (int x = 0; x < paddedWidth; ++x)
+            {
+                const int sourceX = std::clamp(x - TextureAtlas::PADDING, 0, width - 1);
+                std::copy_n(&source[(static_cast<size_t>(sourceY) * width + sourceX) * 4], 4,
+                    &padded[(static_cast<size_t>(y) * paddedWidth + x) * 4]);
+            }
+        }
+        return padded;
+    }
+}
+
+TextureAtlas::~TextureAtlas() = default;
+
+const AtlasRegion* TextureAtlas::FindRegion(const Texture* texture) const
+{
+    auto it = regions.find(texture);
+    return it != regions.end() ? &it->second : nullptr;
+}
+
+void TextureAtlas::Add(const Texture* texture)
+{
+    if (!texture || regions.count(texture) || std::find(pendingTextures.begin(), pendingTextures.end(), texture) != pendingTextures.end())
+        return;
+    pendingTextures.push_back(texture);
+}
+
+void TextureAtlas::Build()
+{
+    // Tallest first keeps the skyline flat, which wastes less space.
+    std::sort(pendingTextures.begin(), pendingTextures.end(), [](const Texture* a, const Texture* b) {
+        return a->GetHeight() != b->GetHeight() ? a->GetHeight() > b->GetHeight() : a->GetWidth() > b->GetWidth();
+        });
+
+    for (const Texture* texture : pendingTextures)
+    {
+        const int width = texture->GetWidth() + PADDING * 2;
+        const int height = texture->GetHeight() + PADDING * 2;
+        if (!texture->GetID() || width > PAGE_SIZE || height > PAGE_SIZE)
+        {
+            SNAKE_WRN("Texture " << texture->GetWidth() << "x" << texture->GetHeight() << " left out of the atlas: it does not fit a page.");
+            continue;
+        }
+        if (texture->IsRepeating())
+        {
+            SNAKE_WRN("Texture " << texture->GetWidth() << "x" << texture->GetHeight() << " left out of the atlas: repeating textures cannot share a page.");
+            continue;
+        }
+
+        Page* target = nullptr;
+        int x = 0, y = 0;
+        size_t node = 0;
+        for (Page& page : pages)
+        {
+            if (FindPosition(page, width, height, x, y, node))
+            {
+                target = &page;
+                break;
+            }
+        }
+        if (!target)
+        {
+            target = &CreatePage(texture);
+            if (!FindPosition(*target, width, height, x, y, node))
+                continue;
+        }
+        AddSkylineLevel(*target, node, x, y, width, height);
+
+        const std::vector<unsigned char> pixels = MakePaddedPixels(texture->ReadPixelsRGBA(), texture->GetWidth(), texture->GetHeight());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTextureSubImage2D(target->texture->GetID(), 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        AtlasRegion& region = regions[texture];
+        region.page = target->texture.get();
+        region.uvRect = glm::vec4(
+            static_cast<float>(x + PADDING) / PAGE_SIZE, static_cast<float>(y + PADDING) / PAGE_SIZE,
+            static_cast<float>(texture->GetWidth()) / PAGE_SIZE, static_cast<float>(texture->GetHeight()) / PAGE_SIZE);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    pendingTextures.clear();
+}
+
+// Bottom-left rule: the position whose top edge ends lowest wins, ties go to the narrower skyline segment.
+bool TextureAtlas::FindPosition(const Page& page, int width, int height, int& outX, int& outY, size_t& outNode)
+{
+    int bestTop = INT_MAX;
+    int bestWidth = INT_MAX;
+    for (size_t i = 0; i < page.skyline.size(); ++i)
+    {
+        const int x = page.skyline[i].x;
+        if (x + width > PAGE_SIZE)
+            break;
+
+        // The rect rests on the highest segment it spans.
+        int y = 0;
+        int widthLeft = width;
+        for (size_t j = i; widthLeft > 0; ++j)
+        {
+            y = std::max(y, page.skyline[j].y);
+            widthLeft -= page.skyline[j].width;
+        }
+        if (y + height > PAGE_SIZE)
+            continue;
+
+        if (y + height < bestTop || (y + height == bestTop && page.skyline[i].width < bestWidth))
+        {
+            bestTop = y + height;
+            bestWidth = page.skyline[i].width;
+            outX = x;
+            outY = y;
+            outNode = i;
+        }
+    }
+    return bestTop != INT_MAX;
+}
+
+void TextureAtlas::AddSkylineLevel(Page& page, size_t node, int x, int y, int width, int height)
+{
+    std::vector<SkylineNode>& skyline = page.skyline;
+    skyline.insert(skyline.begin() + node, { x, y + height, width });
+
+    // Trim or remove the segments now covered by the new one.
+    for (size_t i = node + 1; i < skyline.size();)
+    {
+        const int coveredUntil = skyline[i - 1].x + skyline[i - 1].width;
+        if (skyline[i].x >= coveredUntil)
+            break;
+
+        const int shrink = coveredUntil - skyline[i].x;
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+        if (skyline[i].width > 0)
+            break;
+        skyline.erase(skyline.begin() + i);
+    }
+
+    for (size_t i = 0; i + 1 < skyline.size();)
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+TextureAtlas::Page& TextureAtlas::CreatePage(const Texture* settingsSource)
+{
+    Page& page = pages.emplace_back();
+    page.texture = Texture::CreateBlank(PAGE_SIZE, PAGE_SIZE, *settingsSource);
+    page.skyline.push_back({ 0, 0, PAGE_SIZE });
+    SNAKE_LOG("Texture atlas page " << pages.size() << " created (" << PAGE_SIZE << "x" << PAGE_SIZE << ")");
+    return page;
+}
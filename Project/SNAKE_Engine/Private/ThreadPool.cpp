@@ -0,0 +1,112 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::~ThreadPool()
+{
+    Free();
+}
+
+void ThreadPool::Init(unsigned workerCount)
+{
+    if (!workers.empty())
+        return;
+
+    if (workerCount == 0)
+    {
+        const unsigned hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+    workerCount = std::min(workerCount, MAX_WORKERS);
+
+    stopping = false;
+    workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i)
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+void ThreadPool::Free()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+
+    for (std::thread& worker : workers)
+        worker.join();
+    workers.clear();
+}
+
+void ThreadPool::Run(size_t chunkCount, JobFunc func, void* context)
+{
+    if (chunkCount == 0)
+        return;
+
+    if (workers.empty() || chunkCount == 1)
+    {
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            func(context, chunk);
+        return;
+    }
+
+    {
+        // A worker that woke up too late for the previous job may still be leaving RunChunks.
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [this]() { return activeWorkers == 0; });
+        jobFunc = func;
+        jobContext = context;
+        jobChunkCount = chunkCount;
+        nextChunk.store(0, std::memory_order_relaxed);
+        pendingChunks.store(chunkCount, std::memory_order_relaxed);
+        ++generation;
+    }
+    wakeCondition.notify_all();
+
+    RunChunks();
+
+    // func and context belong to the caller, so no worker may still be inside a chunk on return.
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this]() {
+        return pendingChunks.load(std::memory_order_acquire) == 0 && activeWorkers == 0;
+        });
+}
+
+void ThreadPool::RunChunks()
+{
+    size_t finished = 0;
+    for (;;)
+    {
+        const size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= jobChunkCount)
+            break;
+        jobFunc(jobContext, chunk);
+        ++finished;
+    }
+
+    if (finished)
+        pendingChunks.fetch_sub(finished, std::memory_order_acq_rel);
+}
+
+void ThreadPool::WorkerLoop()
+{
+    uint64_t seenGeneration = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [&]() { return stopping || generation != seenGeneration; });
+            if (stopping)
+                return;
+            seenGeneration = generation;
+            ++activeWorkers;
+        }
+
+        RunChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --activeWorkers;
+        }
+        doneCondition.notify_one();
+    }
+}
@@ -1,15 +1,32 @@
 #include "Transform.h"
 #include "ext/matrix_transform.hpp"
 
-glm::mat4& Transform2D::GetMatrix()
+namespace
 {
-    if (isChanged)
+    glm::mat4 ComposeMatrix(const glm::vec2& position, float rotation, const glm::vec2& scale)
     {
         glm::mat4 t = glm::translate(glm::mat4(1.0f), glm::vec3(position, 0.0f));
         glm::mat4 r = glm::rotate(glm::mat4(1.0f), rotation, glm::vec3(0, 0, 1));
         glm::mat4 s = glm::scale(glm::mat4(1.0f), glm::vec3(scale, 1.0f));
-        matrix = t * r * s;
+        return t * r * s;
+    }
+}
+
+glm::mat4& Transform2D::GetMatrix()
+{
+    if (isChanged)
+    {
+        matrix = ComposeMatrix(position, rotation, scale);
         isChanged = false;
     }
     return matrix;
 }
+
+glm::mat4 Transform2D::GetInterpolatedMatrix(float alpha)
+{
+    if (alpha >= 1.0f || !IsInterpolating())
+        return GetMatrix();
+    return ComposeMatrix(glm::mix(previousPosition, position, alpha),
+        previousRotation + (rotation - previousRotation) * alpha,
+        glm::mix(previousScale, scale, alpha));
+}
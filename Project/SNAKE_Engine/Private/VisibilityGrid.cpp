@@ -0,0 +1,270 @@
+#include "VisibilityGrid.h"
+#include <algorithm>
+#include <cmath>
+
+#include "Camera2D.h"
+#include "Object.h"
+
+namespace
+{
+    uint64_t PackCellKey(int32_t cx, int32_t cy)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+    }
+
+    int32_t CellX(uint64_t key)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+    }
+
+    int32_t CellY(uint64_t key)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(key));
+    }
+}
+
+VisibilityGrid::VisibilityGrid(float cellSize) : cellSize(cellSize)
+{
+}
+
+void VisibilityGrid::SetCellSize(float size)
+{
+    if (size <= 0.0f || size == cellSize)
+        return;
+    cellSize = size;
+    Rebuild();
+}
+
+uint64_t VisibilityGrid::GetCellKey(float x, float y) const
+{
+    return PackCellKey(static_cast<int32_t>(std::floor(x / cellSize)), static_cast<int32_t>(std::floor(y / cellSize)));
+}
+
+std::vector<uint32_t>& VisibilityGrid::GetBucketList(Bucket bucket, uint64_t cellKey)
+{
+    switch (bucket)
+    {
+    case Bucket::Large:
+        return largeRecords;
+    case Bucket::ScreenSpace:
+        return screenSpaceRecords;
+    default:
+        return cells[cellKey];
+    }
+}
+
+void VisibilityGrid::Place(uint32_t recordIndex, Bucket bucket, uint64_t cellKey)
+{
+    Record& record = records[recordIndex];
+    std::vector<uint32_t>& list = GetBucketList(bucket, cellKey);
+    record.bucket = bucket;
+    record.cellKey = cellKey;
+    record.indexInBucket = static_cast<uint32_t>(list.size());
+    list.push_back(recordIndex);
+
+    if (bucket == Bucket::Cell)
+        maxCellRadius = std::max(maxCellRadius, record.radius);
+}
+
+void VisibilityGrid::Unplace(uint32_t recordIndex)
+{
+    Record& record = records[recordIndex];
+    if (record.bucket == Bucket::None)
+        return;
+
+    std::vector<uint32_t>& list = GetBucketList(record.bucket, record.cellKey);
+    const uint32_t movedIndex = list.back();
+    list[record.indexInBucket] = movedIndex;
+    records[movedIndex].indexInBucket = record.indexInBucket;
+    list.pop_back();
+    record.bucket = Bucket::None;
+}
+
+void VisibilityGrid::Sync(const std::vector<Object*>& objects)
+{
+    const size_t count = objects.size();
+    ++syncGeneration;
+
+    size_t movedCount = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Object* obj = objects[i];
+        uint32_t recordIndex = obj->visibilityRecord;
+        bool isNew = false;
+
+        // The index lives on the object, like InstanceStore's slot, so an object allocated at a freed
+        // object's address starts without one instead of inheriting the old record.
+        if (recordIndex >= records.size() || records[recordIndex].object != obj)
+        {
+            if (!freeRecords.empty())
+            {
+                recordIndex = freeRecords.back();
+                freeRecords.pop_back();
+                records[recordIndex] = {};
+            }
+            else
+            {
+                recordIndex = static_cast<uint32_t>(records.size());
+                records.emplace_back();
+            }
+            records[recordIndex].object = obj;
+            obj->visibilityRecord = recordIndex;
+            ++recordCount;
+            isNew = true;
+        }
+
+        Record& record = records[recordIndex];
+        record.slot = static_cast<uint32_t>(i);
+        record.lastSeen = syncGeneration;
+        record.isActive = obj->IsAlive() && obj->IsVisible();
+
+        const Transform2D& transform = obj->GetTransform2D();
+        const bool shapeChanged = isNew || record.mesh != obj->GetMesh() || record.transformVersion != transform.GetVersion();
+        if (shapeChanged)
+        {
+            record.mesh = obj->GetMesh();
+            record.transformVersion = transform.GetVersion();
+            record.x = transform.GetPosition().x;
+            record.y = transform.GetPosition().y;
+            record.radius = obj->GetBoundingRadius();
+        }
+
+        const Bucket bucket = obj->ShouldIgnoreCamera() ? Bucket::ScreenSpace
+            : record.radius > cellSize ? Bucket::Large : Bucket::Cell;
+        if (bucket != record.bucket || (bucket == Bucket::Cell && shapeChanged))
+        {
+            const uint64_t cellKey = bucket == Bucket::Cell ? GetCellKey(record.x, record.y) : 0;
+            if (bucket != record.bucket || cellKey != record.cellKey)
+            {
+                Unplace(recordIndex);
+                Place(recordIndex, bucket, cellKey);
+                ++movedCount;
+            }
+            else
+            {
+                maxCellRadius = std::max(maxCellRadius, record.radius);
+            }
+        }
+    }
+
+    // Objects that are no longer in the list.
+    if (recordCount > count)
+    {
+        for (uint32_t recordIndex = 0; recordIndex < records.size(); ++recordIndex)
+        {
+            Record& record = records[recordIndex];
+            if (!record.object || record.lastSeen == syncGeneration)
+                continue;
+            Unplace(recordIndex);
+            record.object = nullptr;
+            freeRecords.push_back(recordIndex);
+            --recordCount;
+        }
+    }
+
+    lastMovedCount = movedCount;
+}
+
+void VisibilityGrid::Query(const Camera2D& camera, glm::vec2 viewportSize, std::vector<uint32_t>& outSlots) const
+{
+    outSlots.clear();
+
+    for (uint32_t recordIndex : screenSpaceRecords)
+    {
+        if (records[recordIndex].isActive)
+            outSlots.push_back(records[recordIndex].slot);
+    }
+
+    const glm::vec2 camPos = camera.GetPosition();
+    const glm::vec2 halfSize = viewportSize / camera.GetZoom() * 0.5f;
+    const float minX = camPos.x - halfSize.x;
+    const float maxX = camPos.x + halfSize.x;
+    const float minY = camPos.y - halfSize.y;
+    const float maxY = camPos.y + halfSize.y;
+
+    auto collect = [&](const std::vector<uint32_t>& list) {
+        for (uint32_t recordIndex : list)
+        {
+            const Record& record = records[recordIndex];
+            if (record.isActive &&
+                record.x + record.radius >= minX && record.x - record.radius <= maxX &&
+                record.y + record.radius >= minY && record.y - record.radius <= maxY)
+                outSlots.push_back(record.slot);
+        }
+        };
+
+    collect(largeRecords);
+
+    // Objects are filed by centre only, so look as far out as the largest radius in any cell.
+    const int32_t minCellX = static_cast<int32_t>(std::floor((minX - maxCellRadius) / cellSize));
+    const int32_t maxCellX = static_cast<int32_t>(std::floor((maxX + maxCellRadius) / cellSize));
+    const int32_t minCellY = static_cast<int32_t>(std::floor((minY - maxCellRadius) / cellSize));
+    const int32_t maxCellY = static_cast<int32_t>(std::floor((maxY + maxCellRadius) / cellSize));
+
+    size_t visitedCount = 0;
+    const double rangeCellCount = (static_cast<double>(maxCellX) - minCellX + 1) * (static_cast<double>(maxCellY) - minCellY + 1);
+    if (rangeCellCount > static_cast<double>(cells.size()))
+    {
+        // Zoomed far out: walking the occupied cells is cheaper than probing every cell in range.
+        for (const auto& [key, list] : cells)
+        {
+            const int32_t cx = CellX(key);
+            const int32_t cy = CellY(key);
+            if (cx < minCellX || cx > maxCellX || cy < minCellY || cy > maxCellY)
+                continue;
+            collect(list);
+            ++visitedCount;
+        }
+    }
+    else
+    {
+        for (int32_t cy = minCellY; cy <= maxCellY; ++cy)
+        {
+            for (int32_t cx = minCellX; cx <= maxCellX; ++cx)
+            {
+                auto it = cells.find(PackCellKey(cx, cy));
+                if (it == cells.end())
+                    continue;
+                collect(it->second);
+                ++visitedCount;
+            }
+        }
+    }
+    lastVisitedCellCount = visitedCount;
+
+    // Draw items rely on submission order for equal keys, so hand slots back in list order.
+    std::sort(outSlots.begin(), outSlots.end());
+}
+
+void VisibilityGrid::Rebuild()
+{
+    cells.clear();
+    largeRecords.clear();
+    screenSpaceRecords.clear();
+    maxCellRadius = 0.0f;
+
+    for (uint32_t recordIndex = 0; recordIndex < records.size(); ++recordIndex)
+    {
+        Record& record = records[recordIndex];
+        if (!record.object || record.bucket == Bucket::None)
+            continue;
+
+        const Bucket bucket = record.bucket == Bucket::ScreenSpace ? Bucket::ScreenSpace
+            : record.radius > cellSize ? Bucket::Large : Bucket::Cell;
+        record.bucket = Bucket::None;
+        Place(recordIndex, bucket, bucket == Bucket::Cell ? GetCellKey(record.x, record.y) : 0);
+    }
+}
+
+void VisibilityGrid::Clear()
+{
+    records.clear();
+    freeRecords.clear();
+    recordCount = 0;
+    cells.clear();
+    largeRecords.clear();
+    screenSpaceRecords.clear();
+    maxCellRadius = 0.0f;
+    lastMovedCount = 0;
+    lastVisitedCellCount = 0;
+}
@@ -5,8 +5,11 @@
 #include "glfw3.h"
 #include "SNAKE_Engine.h"
 #include "GameState.h"
+#include "NullBackend.h"
+#include "RenderThread.h"
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
+    RenderThread::Sync();
     glViewport(0, 0, width, height);
     SNAKE_Engine* snakeEngine = static_cast<SNAKE_Engine*>(glfwGetWindowUserPointer(window));
     if (snakeEngine)
@@ -19,8 +22,11 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
     }
 
 }
-bool WindowManager::Init(int _windowWidth, int _windowHeight, SNAKE_Engine& engine)
+bool WindowManager::Init(int _windowWidth, int _windowHeight, RenderBackend backend, SNAKE_Engine& engine)
 {
+    isHeadless = backend == RenderBackend::Null;
+    if (isHeadless)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
 
     if (!glfwInit())
     {
@@ -28,9 +34,16 @@ bool WindowManager::Init(int _windowWidth, int _windowHeight, SNAKE_Engine& engi
         return false;
     }
 
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (isHeadless)
+    {
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    }
+    else
+    {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    }
 
     windowWidth = _windowWidth;
     windowHeight = _windowHeight;
@@ -43,12 +56,23 @@ bool WindowManager::Init(int _windowWidth, int _windowHeight, SNAKE_Engine& engi
         return false;
     }
 
-    glfwMakeContextCurrent(window);
-
-    if (!gladLoadGL(glfwGetProcAddress))
+    if (isHeadless)
     {
-        SNAKE_ERR("Failed to initialize GLAD");
-        return false;
+        if (!NullBackend::Load())
+        {
+            SNAKE_ERR("Failed to load the null GL backend");
+            return false;
+        }
+    }
+    else
+    {
+        glfwMakeContextCurrent(window);
+
+        if (!gladLoadGL(glfwGetProcAddress))
+        {
+            SNAKE_ERR("Failed to initialize GLAD");
+            return false;
+        }
     }
 
     glViewport(0, 0, windowWidth, windowHeight);
@@ -80,7 +104,8 @@ void WindowManager::Free() const
 
 void WindowManager::SwapBuffers() const
 {
-    glfwSwapBuffers(window);
+    if (!isHeadless)
+        glfwSwapBuffers(window);
 }
 
 void WindowManager::ClearScreen() const
@@ -19,11 +19,22 @@ public:
 
     [[nodiscard]] glm::mat4 GetProjectionMatrix() const;
 
+    /// Makes the current position and zoom the start point of render interpolation, like Transform2D::StorePreviousPose.
+    void StorePreviousPose();
+
+    /// Projection between the pose stored by StorePreviousPose (alpha 0) and the current one (alpha 1).
+    [[nodiscard]] glm::mat4 GetInterpolatedProjectionMatrix(float alpha) const;
+
     [[nodiscard]] bool IsInView(const glm::vec2& pos, float radius, glm::vec2 viewportSize) const;
 
 private:
+    [[nodiscard]] glm::mat4 BuildProjectionMatrix(const glm::vec2& center, float scale) const;
+
     glm::vec2 position = glm::vec2(0.0f);
     float zoom = 1.0f;
+    glm::vec2 previousPosition = glm::vec2(0.0f);
+    float previousZoom = 1.0f;
+    bool hasPreviousPose = false;
     int screenWidth = 800;
     int screenHeight = 600;
 };
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "glm.hpp"
+
+class RenderManager;
+class Camera2D;
+
+using GLuint = unsigned int;
+
+/**
+ * @brief Per-frame uniform buffer holding the view-projection matrix of every view drawn this frame.
+ *
+ * @details
+ * A view is either a camera or the screen space of a given screen size. RenderManager asks for the
+ * view of each command while recording, which computes the view's matrix the first time it is used
+ * in the frame, then uploads the whole table once before executing the commands.
+ *
+ * Shaders read it through a std140 block bound to BINDING and pick their matrix with `u_CameraIndex`:
+ * @code
+ * layout(std140) uniform CameraBlock { mat4 u_ViewProjections[64]; };
+ * uniform int u_CameraIndex;
+ * @endcode
+ * Shaders without the block still get `u_Projection`, copied from the same table.
+ */
+class CameraBuffer
+{
+    friend RenderManager;
+public:
+    static constexpr uint32_t MAX_VIEWS = 64;
+    static constexpr GLuint BINDING = 0;
+
+    CameraBuffer() = default;
+    ~CameraBuffer();
+
+    CameraBuffer(const CameraBuffer&) = delete;
+    CameraBuffer& operator=(const CameraBuffer&) = delete;
+
+    [[nodiscard]] size_t GetViewCount() const { return matrices.size(); }
+
+private:
+    void Init();
+
+    /// Starts a new set of views, whose cameras are blended by @p interpolationAlpha between their last two ticks.
+    void BeginFrame(float interpolationAlpha);
+
+    /// Index of the view drawn through @p camera, or of the screen space of @p referenceCamera when @p screenSpace is set or there is no camera.
+    [[nodiscard]] uint32_t GetViewIndex(const Camera2D* camera, bool screenSpace, const Camera2D* referenceCamera);
+
+    [[nodiscard]] const glm::mat4& GetMatrix(uint32_t viewIndex) const { return matrices[viewIndex]; }
+
+    /// Sends this frame's matrices to the GPU and binds the buffer. Must run before the draws that read them.
+    void Upload();
+
+    void Free();
+
+    struct View
+    {
+        const Camera2D* camera; ///< nullptr for a screen space view.
+        int screenWidth;
+        int screenHeight;
+    };
+
+    GLuint buffer = 0;
+    std::vector<View> views;
+    std::vector<glm::mat4> matrices;
+    bool hasOverflowed = false;
+    float alpha = 1.0f;
+};
@@ -47,6 +47,15 @@ public:
         }
     }
 
+    void StorePreviousPoses()
+    {
+        for (auto& [tag, cam] : cameraMap)
+        {
+            if (cam)
+                cam->StorePreviousPose();
+        }
+    }
+
     void SetScreenSize(const std::string& tag, int width, int height)
     {
         if (cameraMap[tag])
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Object;
+class Mesh;
+
+namespace CullFlag
+{
+    constexpr uint32_t ACTIVE = 1u << 0;        ///< Object is alive and visible.
+    constexpr uint32_t IGNORE_CAMERA = 1u << 1; ///< Object is drawn in screen space and always passes culling.
+}
+
+/**
+ * @brief Structure-of-arrays copy of the culling data of an object list.
+ *
+ * @details
+ * Entry i mirrors objects[i] of the list passed to Sync: bounding circle centre, radius and
+ * CullFlag bits, each in its own tightly packed array so the culler can test several objects
+ * per SIMD instruction without touching the objects themselves.
+ *
+ * Sync refreshes flags every call but only recomputes the bounding circle of entries whose
+ * object, mesh or Transform2D version changed since the previous call.
+ */
+class CullingBounds
+{
+public:
+    void Sync(const std::vector<Object*>& objects);
+
+    void Clear();
+
+    [[nodiscard]] size_t GetCount() const { return x.size(); }
+
+    [[nodiscard]] const float* GetX() const { return x.data(); }
+
+    [[nodiscard]] const float* GetY() const { return y.data(); }
+
+    [[nodiscard]] const float* GetRadius() const { return radius.data(); }
+
+    [[nodiscard]] const uint32_t* GetFlags() const { return flags.data(); }
+
+    /// Number of bounding circles recomputed by the last Sync.
+    [[nodiscard]] size_t GetLastRefreshCount() const { return lastRefreshCount; }
+
+private:
+    struct SyncState
+    {
+        const Object* object = nullptr;
+        const Mesh* mesh = nullptr;
+        uint64_t transformVersion = 0;
+    };
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> radius;
+    std::vector<uint32_t> flags;
+    std::vector<SyncState> syncStates;
+    size_t lastRefreshCount = 0;
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glm.hpp"
+#include "RingBuffer.h"
+
+class RenderManager;
+class Camera2D;
+class Shader;
+
+using GLuint = unsigned int;
+
+enum class DebugShape : uint32_t
+{
+    Line,
+    Rect,
+    Circle
+};
+
+/**
+ * @brief One debug primitive. Drawn as an instanced quad whose outline is shaded with a signed distance field.
+ */
+struct DebugShapeInstance
+{
+    glm::vec2 a;     ///< Line start, or the rect/circle center.
+    glm::vec2 b;     ///< Line end, the rect half size, or the circle radius in x.
+    glm::vec4 color;
+    float lineWidth; ///< In screen pixels, independent of camera zoom.
+    DebugShape shape;
+};
+
+static_assert(sizeof(DebugShapeInstance) == 40, "DebugShapeInstance must match the instance attribute layout");
+
+/**
+ * @brief Collects debug lines, rects and circles during the frame and draws them with one instanced call per camera.
+ *
+ * @details
+ * Shapes are appended to per-camera arrays that keep their capacity between frames, then copied
+ * into a persistently mapped ring buffer by Prepare, so a steady stream of debug draws does not
+ * allocate. Prepare runs on the recording thread and leaves only plain draw ranges for Draw, which
+ * may run on the render thread. Every shape is a four-vertex quad generated from gl_VertexID; the fragment shader
+ * computes the distance to the segment, rect outline or circle outline in pixels, which gives
+ * any line width and antialiasing without glLineWidth.
+ */
+class DebugRenderer
+{
+    friend RenderManager;
+public:
+    DebugRenderer() = default;
+    ~DebugRenderer();
+
+    DebugRenderer(const DebugRenderer&) = delete;
+    DebugRenderer& operator=(const DebugRenderer&) = delete;
+
+    /// Number of shapes prepared for the last frame.
+    [[nodiscard]] size_t GetLastShapeCount() const { return lastShapeCount; }
+
+private:
+    void Init();
+
+    void Add(Camera2D* camera, const DebugShapeInstance& shape);
+
+    /// Uploads and clears everything added since the last frame. Shapes without a camera use screen space.
+    void Prepare(int screenWidth, int screenHeight, float interpolationAlpha);
+
+    /// Draws what the last Prepare uploaded.
+    void Draw(Shader* shader);
+
+    /// Releases the frame's ring region once Draw has been issued.
+    void EndFrame();
+
+    /// Drops everything added since the last frame without drawing it.
+    void Clear();
+
+    void Free();
+
+    struct View
+    {
+        Camera2D* camera;
+        std::vector<DebugShapeInstance> shapes;
+    };
+
+    struct ViewDraw
+    {
+        glm::mat4 projection;
+        float pixelSize;
+        GLuint buffer;
+        size_t offset;
+        uint32_t shapeCount;
+    };
+
+    std::vector<View> views;
+    size_t lastViewIndex = 0;
+    std::vector<ViewDraw> viewDraws;
+    RingBuffer ringBuffer;
+    GLuint vao = 0;
+    size_t lastShapeCount = 0;
+};
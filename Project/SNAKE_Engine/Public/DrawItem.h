@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "RenderLayerManager.h"
+
+class Object;
+class Camera2D;
+
+/**
+ * @brief Packed 64-bit sort key of a draw item.
+ *
+ * @details
+ * Bit layout, from most to least significant:
+ * | layer (4) | shader (12) | material (16) | mesh (16) | depth (16) |
+ *
+ * Shader, material and mesh fields hold the creation-order sort IDs of those resources, so the
+ * resulting batch order is deterministic and does not depend on pointer addresses. Sorting by the
+ * key groups everything that can share one draw call next to each other; the depth field only
+ * orders items inside such a group.
+ */
+namespace DrawKey
+{
+    constexpr int DEPTH_BITS = 16;
+    constexpr int MESH_BITS = 16;
+    constexpr int MATERIAL_BITS = 16;
+    constexpr int SHADER_BITS = 12;
+    constexpr int LAYER_BITS = 4;
+
+    constexpr int MESH_SHIFT = DEPTH_BITS;
+    constexpr int MATERIAL_SHIFT = MESH_SHIFT + MESH_BITS;
+    constexpr int SHADER_SHIFT = MATERIAL_SHIFT + MATERIAL_BITS;
+    constexpr int LAYER_SHIFT = SHADER_SHIFT + SHADER_BITS;
+
+    static_assert(LAYER_SHIFT + LAYER_BITS == 64, "DrawKey fields must fill 64 bits");
+    static_assert(RenderLayerManager::MAX_LAYERS <= (1u << LAYER_BITS), "DrawKey layer field is too small for MAX_LAYERS");
+
+    /// Mask of the fields that identify a batch (everything except depth).
+    constexpr uint64_t BATCH_MASK = ~((uint64_t(1) << DEPTH_BITS) - 1);
+
+    /// Mask of the layer, shader and material fields; batches that only differ by mesh share it.
+    constexpr uint64_t MATERIAL_MASK = ~((uint64_t(1) << MATERIAL_SHIFT) - 1);
+
+    [[nodiscard]] constexpr uint64_t Field(uint32_t value, int bits, int shift)
+    {
+        return (static_cast<uint64_t>(value) & ((uint64_t(1) << bits) - 1)) << shift;
+    }
+
+    [[nodiscard]] constexpr uint64_t Make(uint8_t layer, uint32_t shaderID, uint32_t materialID, uint32_t meshID, uint16_t depth = 0)
+    {
+        return Field(layer, LAYER_BITS, LAYER_SHIFT) |
+            Field(shaderID, SHADER_BITS, SHADER_SHIFT) |
+            Field(materialID, MATERIAL_BITS, MATERIAL_SHIFT) |
+            Field(meshID, MESH_BITS, MESH_SHIFT) |
+            Field(depth, DEPTH_BITS, 0);
+    }
+
+    [[nodiscard]] constexpr uint8_t GetLayer(uint64_t key)
+    {
+        return static_cast<uint8_t>(key >> LAYER_SHIFT);
+    }
+}
+
+/**
+ * @brief One visible object queued for rendering this frame.
+ */
+struct DrawItem
+{
+    uint64_t key;      ///< Sort key built with DrawKey::Make.
+    Object* object;    ///< Object to draw.
+    Camera2D* camera;  ///< Camera the object was submitted with (nullptr for screen space).
+};
+
+/**
+ * @brief Stable LSD radix sort of draw items by key.
+ *
+ * @details
+ * Byte passes whose digit is identical for every key are skipped, so in practice only the bytes
+ * that actually vary (usually layer, shader and material) are sorted. Items with equal keys keep
+ * their submission order. @p scratch is resized as needed and can be reused between frames.
+ */
+void RadixSortDrawItems(std::vector<DrawItem>& items, std::vector<DrawItem>& scratch);
@@ -22,6 +22,8 @@
 #include "Font.h"
 
 #include "EngineTimer.h"
+#include "NullBackend.h"
+#include "ProgramCache.h"
 
 #include "Camera2D.h"
 
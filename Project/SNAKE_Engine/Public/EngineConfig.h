@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+
+/**
+ * @brief Where GL calls go. See NullBackend.
+ */
+enum class RenderBackend
+{
+    OpenGL, ///< A GLFW window with an OpenGL 4.6 core context.
+    Null,   ///< No window system, no context: GL calls are recorded by NullBackend.
+};
+
+/**
+ * @brief Startup options of SNAKE_Engine::Init.
+ */
+struct EngineConfig
+{
+    int windowWidth = 800;
+    int windowHeight = 600;
+
+    /**
+     * @brief Backend the engine renders through.
+     *
+     * @details
+     * RenderBackend::Null runs the whole engine, including RenderManager and resource loading,
+     * on GLFW's null platform without a display or GPU, for CPU benchmarks on headless machines.
+     * Input never reports a key or button, and nothing is presented.
+     */
+    RenderBackend backend = RenderBackend::OpenGL;
+
+    /// Frames Run executes before it returns; 0 runs until the window closes or RequestQuit.
+    int frameLimit = 0;
+
+    /**
+     * @brief Simulation ticks per second. 0 runs one Update per frame with the measured frame time.
+     *
+     * @details
+     * With a tick rate, Update always receives 1 / tickRate and runs as many times per frame as
+     * real time requires. Objects and cameras are drawn blended between their poses of the last two
+     * ticks, so simulation can run at 30-60 Hz while rendering at display rate. Input is sampled
+     * once per tick.
+     */
+    double tickRate = 0.0;
+
+    /// Ticks run at most per frame. Time beyond that is dropped, so a long stall slows the game down instead of snowballing.
+    int maxTicksPerFrame = 5;
+
+    /**
+     * @brief Executes recorded frames on a dedicated render thread that owns the GL context.
+     *
+     * @details
+     * The main thread records and resolves frame N, hands it over, and runs the next Update, culling
+     * and draw item building while the render thread executes and presents it. Recording itself
+     * (FlushDrawCommands) and static chunk rebuilds wait for that frame, since they write buffers
+     * and chunks it still reads. Draw-phase hooks (Object::Draw) still run on the main thread;
+     * RenderManager::Submit callbacks run on the render thread.
+     */
+    bool useRenderThread = false;
+
+    /**
+     * @brief Where linked shader programs are cached between launches; see ProgramCache.
+     *
+     * @details
+     * Empty by default, which disables the cache. A relative path would follow the working
+     * directory, so games should pass an absolute one, e.g. next to the executable.
+     */
+    std::string shaderCacheDirectory;
+};
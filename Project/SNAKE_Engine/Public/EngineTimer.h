@@ -1,14 +1,16 @@
 #pragma once
+#include <cstdint>
 
 struct EngineTimer
 {
     void Start();
 
-    [[nodiscard]] float Tick();
+    /// Seconds since the previous Tick, measured on GLFW's integer timer so long sessions keep full precision.
+    [[nodiscard]] double Tick();
 
     [[nodiscard]] bool ShouldUpdateFPS(float& outFPS);
 
-    float lastTime = 0.0f;
-    float fpsTimer = 0.0f;
+    uint64_t lastCounter = 0;
+    double fpsTimer = 0.0;
     int frameCount = 0;
 };
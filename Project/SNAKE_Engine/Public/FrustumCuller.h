@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glm.hpp"
+
+class Camera2D;
+class Object;
+class CullingBounds;
+
+/**
+ * @brief Instruction set used by FrustumCuller::CullBounds.
+ */
+enum class CullPath
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+class FrustumCuller
+{
+public:
+    /**
+     * @brief Tests one object against the camera.
+     *
+     * @param viewSize Viewport size already divided by the camera zoom.
+     */
+    [[nodiscard]] static bool IsVisible(const Camera2D& camera, Object* obj, glm::vec2 viewSize);
+
+    static void CullVisible(const Camera2D& camera, const std::vector<Object*>& allObjects,
+        std::vector<Object*>& outVisibleList, glm::vec2 viewportSize);
+
+    /**
+     * @brief Culls entries [begin, end) of packed bounds and writes the indices of visible ones.
+     *
+     * @details
+     * Uses the widest instruction set the CPU supports (see GetBestCullPath). Entries pass if they
+     * are CullFlag::ACTIVE and either CullFlag::IGNORE_CAMERA or overlapping the view rectangle.
+     *
+     * @param outIndices Receives visible indices in ascending order. Must hold end - begin entries.
+     * @return Number of indices written.
+     */
+    [[nodiscard]] static size_t CullBounds(const Camera2D& camera, const CullingBounds& bounds, glm::vec2 viewportSize,
+        size_t begin, size_t end, uint32_t* outIndices);
+
+    /**
+     * @brief Same as above with an explicit path. Falls back to the best supported path if @p path is not available.
+     */
+    [[nodiscard]] static size_t CullBounds(const Camera2D& camera, const CullingBounds& bounds, glm::vec2 viewportSize,
+        size_t begin, size_t end, uint32_t* outIndices, CullPath path);
+
+    /**
+     * @brief Widest culling path supported by this CPU, detected once.
+     */
+    [[nodiscard]] static CullPath GetBestCullPath();
+
+    [[nodiscard]] static const char* GetCullPathName(CullPath path);
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+
+using GLuint = unsigned int;
+using GLenum = unsigned int;
+using GLsizei = int;
+
+/**
+ * @brief Calls issued to and suppressed by GLState since the last ResetStats.
+ */
+struct GLStateStats
+{
+    size_t issuedCount = 0;     ///< Binds that changed GL state and reached the driver.
+    size_t suppressedCount = 0; ///< Binds skipped because the object was already bound.
+    size_t textureBindCount = 0; ///< Issued binds that were texture unit binds.
+};
+
+/**
+ * @brief Shadow of the GL bindings the engine changes, so redundant binds never reach the driver.
+ *
+ * @details
+ * Every engine bind of a program, vertex array, texture unit, buffer target or indexed storage
+ * buffer goes through here. A bind is forwarded to GL only when it differs from the tracked one.
+ * Nothing is unbound after a draw: the next draw simply binds what it needs.
+ *
+ * Objects must also be deleted through GLState, because GL resets the bindings of a deleted name
+ * and a recycled name would otherwise look bound already. Code that calls GL directly, such as a
+ * RenderManager::Submit callback, leaves the shadow stale; Invalidate forgets everything, and
+ * RenderManager calls it after each user callback.
+ *
+ * The engine draws into a single context that is current on one thread at a time (see
+ * RenderThread), so the tracked state is global.
+ */
+class GLState
+{
+public:
+    static constexpr GLuint MAX_TEXTURE_UNITS = 32;
+    static constexpr GLuint MAX_STORAGE_BINDINGS = 16;
+
+    static void UseProgram(GLuint program);
+
+    static void BindVertexArray(GLuint vao);
+
+    /// Binds @p texture to @p unit with glBindTextureUnit; units past MAX_TEXTURE_UNITS are always forwarded.
+    static void BindTextureUnit(GLuint unit, GLuint texture);
+
+    /// Tracks GL_ARRAY_BUFFER and GL_DRAW_INDIRECT_BUFFER; other targets are always forwarded.
+    static void BindBuffer(GLenum target, GLuint buffer);
+
+    /// Tracks GL_SHADER_STORAGE_BUFFER bindings below MAX_STORAGE_BINDINGS; others are always forwarded.
+    static void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+    static void DeleteProgram(GLuint program);
+
+    static void DeleteVertexArray(GLuint vao);
+
+    static void DeleteTexture(GLuint texture);
+
+    static void DeleteBuffers(GLsizei count, const GLuint* buffers);
+
+    /// Forgets all tracked bindings, so the next bind of each kind is issued.
+    static void Invalidate();
+
+    static void ResetStats();
+
+    [[nodiscard]] static const GLStateStats& GetStats();
+};
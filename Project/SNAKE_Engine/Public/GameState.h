@@ -66,15 +66,28 @@ private:
 
     virtual void SystemUpdate(float dt, const EngineContext& engineContext)
     {
+        if (engineContext.engine->GetTickRate() > 0.0)
+        {
+            objectManager.StorePreviousPoses();
+            cameraManager.StorePreviousPoses();
+        }
+
         Update(dt, engineContext);
 
         objectManager.CheckCollision();
-        if (engineContext.engine->ShouldRenderDebugDraws())
-            objectManager.DrawColliderDebug(engineContext.renderManager, cameraManager.GetActiveCamera());
 
         LateUpdate(dt, engineContext);
     }
 
+    virtual void SystemDraw(const EngineContext& engineContext)
+    {
+        Draw(engineContext);
+
+        // Drawn per frame rather than per tick, so they neither flicker nor double up when ticks and frames differ.
+        if (engineContext.engine->ShouldRenderDebugDraws())
+            objectManager.DrawColliderDebug(engineContext.renderManager, cameraManager.GetActiveCamera());
+    }
+
     virtual void SystemFree(const EngineContext& engineContext)
     {
         Free(engineContext);
@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+
+#include "RenderLayerManager.h"
+
+class RenderManager;
+
+using GLuint = unsigned int;
+
+/**
+ * @brief GPU time spent per render layer and on debug shapes, in milliseconds.
+ */
+struct GpuTimings
+{
+    std::array<double, RenderLayerManager::MAX_LAYERS> layerMs{}; ///< 0 for layers that drew nothing.
+    double debugMs = 0.0;
+    double totalMs = 0.0; ///< Sum of the measured scopes; clears, viewports and user callbacks are not included.
+};
+
+/**
+ * @brief Measures GPU time per render layer with GL_TIME_ELAPSED queries.
+ *
+ * @details
+ * Every frame owns one query per scope, and FRAME_COUNT frames of queries are kept in flight.
+ * A frame's results are read back when its queries are about to be reused, FRAME_COUNT - 1 frames
+ * later, so the readback never waits for the GPU. If the results are still not available the
+ * frame is dropped and the previous timings are kept.
+ *
+ * Time-elapsed queries cannot nest, so scopes are strictly sequential.
+ */
+class GpuProfiler
+{
+    friend RenderManager;
+public:
+    static constexpr int FRAME_COUNT = 3;
+    static constexpr int DEBUG_SCOPE = RenderLayerManager::MAX_LAYERS;
+    static constexpr int SCOPE_COUNT = DEBUG_SCOPE + 1;
+
+    GpuProfiler() = default;
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    /// Timings of the most recent frame whose queries have been read back.
+    [[nodiscard]] const GpuTimings& GetTimings() const { return timings; }
+
+private:
+    void Init();
+
+    /// Reads back the oldest frame in flight and starts recording into its queries.
+    void BeginFrame();
+
+    /// Starts timing @p scope, a render layer ID or DEBUG_SCOPE. A scope is timed at most once per frame.
+    void BeginScope(int scope);
+
+    void EndScope();
+
+    void Collect(int frame);
+
+    void Free();
+
+    GLuint queries[FRAME_COUNT][SCOPE_COUNT] = {};
+    bool isPending[FRAME_COUNT][SCOPE_COUNT] = {};
+    int currentFrame = 0;
+    int openScope = -1;
+    GpuTimings timings;
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "glm.hpp"
+
+/**
+ * @brief Per-instance vertex layout an instancing shader expects.
+ *
+ * @details
+ * Detected from the shader's attributes when it is linked:
+ * - Full: `i_Model` (mat4), `i_Color` (vec4), `i_UVOffset` and `i_UVScale` (vec2), each in its own stream.
+ * - Compact: `i_AffineRow0`/`i_AffineRow1` (vec3), `i_Color` (normalized RGBA8) and `i_UVRect`
+ *   (normalized 16-bit offset.xy, scale.xy), interleaved as one CompactInstance per instance.
+ * - Resident: `i_Slot` (uint) only. The shader reads a ResidentInstance from the InstanceStore
+ *   storage buffer, which keeps each object's data on the GPU between frames.
+ *
+ * Any of them may also declare `i_TextureLayer` (uint). Its materials are then merged into texture
+ * arrays by RenderManager::MergeTextureArrays and the layer of each instance's texture is streamed
+ * right after the instance data.
+ */
+enum class InstanceLayout : uint8_t
+{
+    None,
+    Full,
+    Compact,
+    Resident
+};
+
+/// Bytes per instance of the Full layout: mat4 + vec4 + vec2 + vec2.
+constexpr size_t FULL_INSTANCE_BYTES = sizeof(glm::mat4) + sizeof(glm::vec4) + sizeof(glm::vec2) * 2;
+
+/**
+ * @brief One instance of the Compact layout.
+ *
+ * @details
+ * The 2D affine transform is stored as the first two rows of the model matrix, so the shader
+ * computes `vec2(dot(row0, p), dot(row1, p))` with `p = vec3(aPos.xy, 1)`. UV offset and scale
+ * must be within [0, 1], which holds for whole textures and sprite sheet frames.
+ */
+struct CompactInstance
+{
+    float affineRow0[3]; ///< m00, m01, tx
+    float affineRow1[3]; ///< m10, m11, ty
+    uint8_t color[4];    ///< RGBA, 0..255 maps to 0..1
+    uint16_t uvRect[4];  ///< UV offset x, y and UV scale x, y, 0..65535 maps to 0..1
+};
+
+static_assert(sizeof(CompactInstance) == 36, "CompactInstance must stay tightly packed");
+
+/// Bytes per instance of the Compact layout.
+constexpr size_t COMPACT_INSTANCE_BYTES = sizeof(CompactInstance);
+
+/**
+ * @brief One slot of the InstanceStore, laid out to match a std430 array of four vec4.
+ *
+ * @details
+ * The affine rows hold m00, m01, tx and m10, m11, ty in xyz. uvRect is offset.xy, scale.zw.
+ */
+struct ResidentInstance
+{
+    glm::vec4 affineRow0;
+    glm::vec4 affineRow1;
+    glm::vec4 color;
+    glm::vec4 uvRect;
+};
+
+static_assert(sizeof(ResidentInstance) == 64, "ResidentInstance must match the std430 layout in the shader");
+
+/// Bytes per instance of the optional `i_TextureLayer` stream.
+constexpr size_t TEXTURE_LAYER_BYTES = sizeof(uint32_t);
+
+/// Bytes per instance of the streams @p layout writes, not counting the texture layer stream.
+constexpr size_t GetInstanceBytes(InstanceLayout layout)
+{
+    switch (layout)
+    {
+    case InstanceLayout::Full: return FULL_INSTANCE_BYTES;
+    case InstanceLayout::Compact: return COMPACT_INSTANCE_BYTES;
+    case InstanceLayout::Resident: return sizeof(uint32_t);
+    default: return 0;
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "InstanceData.h"
+
+class RenderManager;
+class Object;
+
+using GLuint = unsigned int;
+
+/**
+ * @brief Per-frame upload counters of an InstanceStore.
+ */
+struct InstanceStoreStats
+{
+    uint32_t residentCount = 0; ///< Slots owned by objects at the end of the frame.
+    uint32_t dirtyCount = 0;    ///< Slots rewritten because their object changed.
+    uint32_t uploadRanges = 0;  ///< Contiguous ranges sent to the GPU.
+    size_t uploadedBytes = 0;   ///< Bytes sent to the GPU, including clean slots inside merged ranges.
+};
+
+/**
+ * @brief Persistent GPU storage of instance data for the Resident instance layout.
+ *
+ * @details
+ * Each object drawn with a Resident material owns a slot in a shader storage buffer. A slot is only
+ * rewritten when the object's transform version, color, UV flip or animation frame changed, and the
+ * dirty slots are uploaded once per frame as merged contiguous ranges. Objects drawn between two
+ * different tick poses are rewritten every frame until they stop moving. Draws then only stream one
+ * slot index per instance. Slots that have not been drawn for a while are recycled, so objects that
+ * are destroyed or stay hidden do not need to release them.
+ */
+class InstanceStore
+{
+    friend RenderManager;
+public:
+    static constexpr GLuint BINDING = 0;
+
+    InstanceStore() = default;
+    ~InstanceStore();
+
+    InstanceStore(const InstanceStore&) = delete;
+    InstanceStore& operator=(const InstanceStore&) = delete;
+
+    [[nodiscard]] const InstanceStoreStats& GetLastFrameStats() const { return lastFrameStats; }
+
+private:
+    void Init(uint32_t initialSlotCount);
+
+    /// Returns the object's slot, rewriting it first if the object changed since it was last written
+    /// or is drawn between two of its tick poses at @p alpha.
+    [[nodiscard]] uint32_t Update(Object* obj, float alpha);
+
+    /// Sends this frame's dirty slots to the GPU. Must run before the draws that read them.
+    void Upload();
+
+    void Bind() const;
+
+    [[nodiscard]] uint32_t AllocateSlot(Object* obj);
+
+    void WriteSlot(uint32_t slot, Object* obj, float alpha);
+
+    void RecycleStaleSlots();
+
+    void Free();
+
+    /// Dirty slots at most this far apart are uploaded as one range.
+    static constexpr uint32_t MAX_MERGE_GAP = 8;
+    /// Slots not drawn for this many frames go back to the free list.
+    static constexpr uint32_t STALE_FRAME_COUNT = 120;
+
+    struct SlotState
+    {
+        Object* object = nullptr;
+        uint64_t transformVersion = 0;
+        glm::vec4 color = glm::vec4(0);
+        glm::vec4 uvRect = glm::vec4(0);
+        glm::vec2 flip = glm::vec2(0);
+        uint32_t lastUsedFrame = 0;
+        bool isDirty = false;
+        bool isInterpolated = false; ///< Written with a blended pose, so it must be rewritten once the blend moves on.
+    };
+
+    GLuint buffer = 0;
+    uint32_t gpuSlotCount = 0;
+    std::vector<ResidentInstance> instances;
+    std::vector<SlotState> slotStates;
+    std::vector<uint32_t> freeSlots;
+    std::vector<uint32_t> dirtySlots;
+    uint32_t frameIndex = 1;
+
+    InstanceStoreStats frameStats;
+    InstanceStoreStats lastFrameStats;
+};
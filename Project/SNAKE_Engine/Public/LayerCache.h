@@ -0,0 +1,75 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "RenderLayerManager.h"
+
+class RenderManager;
+class Shader;
+
+using GLuint = unsigned int;
+
+/**
+ * @brief Offscreen color targets holding the last rendering of each cached render layer.
+ *
+ * @details
+ * RenderManager hashes everything a cached layer's draws depend on into a signature while it
+ * records the frame. When the signature and the framebuffer size match the target's, the layer is
+ * drawn by compositing the target over the frame with one full-screen triangle; otherwise the
+ * layer's draws are redirected into the target, which is then composited the same way.
+ *
+ * Targets hold premultiplied color: RenderManager blends alpha with (ONE, ONE_MINUS_SRC_ALPHA),
+ * so a layer rendered into a cleared target composites exactly like drawing it directly.
+ */
+class LayerCache
+{
+    friend RenderManager;
+public:
+    LayerCache() = default;
+    ~LayerCache();
+
+    LayerCache(const LayerCache&) = delete;
+    LayerCache& operator=(const LayerCache&) = delete;
+
+private:
+    struct Target
+    {
+        GLuint framebuffer = 0;
+        GLuint texture = 0;
+        int width = 0;
+        int height = 0;
+        uint64_t signature = 0;
+        bool isValid = false;
+    };
+
+    void Init(Shader* compositeShader);
+
+    /**
+     * @brief Whether @p layer's target already holds the rendering described by @p signature.
+     *
+     * On a miss the target is resized to @p width x @p height if needed and takes the signature,
+     * so the draws recorded next must render into it.
+     */
+    [[nodiscard]] bool Lookup(uint8_t layer, uint64_t signature, int width, int height);
+
+    /// False when the target could not be created, e.g. for an empty window; the layer is then drawn uncached.
+    [[nodiscard]] bool HasTarget(uint8_t layer) const { return targets[layer].framebuffer != 0; }
+
+    void Invalidate(uint8_t layer);
+
+    /// Binds @p layer's target and clears it to transparent, or @p frameFramebuffer for a negative layer.
+    void BindTarget(int layer, GLuint frameFramebuffer) const;
+
+    /// Blends @p layer's target over the bound framebuffer, pixel for pixel.
+    void Composite(uint8_t layer) const;
+
+    void CreateTarget(Target& target, int width, int height);
+
+    void DeleteTarget(Target& target);
+
+    void Free();
+
+    std::array<Target, RenderLayerManager::MAX_LAYERS> targets;
+    Shader* compositeShader = nullptr;
+    GLuint vertexArray = 0;
+};
@@ -1,8 +1,10 @@
 #pragma once
-#include <string>
-#include <unordered_map>
+#include <cstdint>
+#include <string_view>
 #include <variant>
+#include <vector>
 #include "glm.hpp"
+#include "UniformID.h"
 
 class RenderManager;
 class ObjectManager;
@@ -11,6 +13,7 @@ class Texture;
 class Mesh;
 
 using GLuint = unsigned int;
+using GLint = int;
 using UniformValue = std::variant<
     int,
     float,
@@ -24,37 +27,67 @@ class Material {
     friend RenderManager;
 
 public:
-    Material(Shader* _shader) : shader(_shader), isInstancingEnabled(false), instanceVBO(){}
+    Material(Shader* _shader);
 
-    void SetTexture(const std::string& uniformName, Texture* texture)
-    {
-        textures[uniformName] = texture;
-    }
+    void SetTexture(std::string_view uniformName, Texture* texture);
 
-    void SetUniform(const std::string& name, UniformValue value)
-    {
-        uniforms[name] = value;
-    }
+    /// Same as the name overload, for IDs resolved ahead of time with MakeUniformID.
+    void SetTexture(UniformID uniformID, Texture* texture);
+
+    void SetUniform(std::string_view name, const UniformValue& value);
+
+    /// Same as the name overload, for IDs resolved ahead of time with MakeUniformID.
+    void SetUniform(UniformID id, const UniformValue& value);
 
     [[nodiscard]] bool IsInstancingSupported() const;
 
+    [[nodiscard]] uint32_t GetSortID() const { return sortID; }
+
     void EnableInstancing(bool enable, Mesh* mesh);
 
+    /// The merged texture-array material this material is drawn with, or the material itself if it was not merged.
+    [[nodiscard]] Material* GetBatchMaterial() { return batchMaterial ? batchMaterial : this; }
+
+    /// Layer of this material's texture inside its batch material's texture array.
+    [[nodiscard]] uint32_t GetTextureLayer() const { return textureLayer; }
+
+    /// Sub-rect of this material's texture inside its batch material's atlas page: UV offset in xy, UV scale in zw.
+    [[nodiscard]] const glm::vec4& GetTextureUVRect() const { return textureUVRect; }
+
 private:
     void Bind() const;
 
-    void UnBind() const;
+    [[nodiscard]] Shader* GetShader() const { return shader; }
 
-    void SendUniforms();
+    struct TextureBinding
+    {
+        UniformID id;
+        GLint location;
+        Texture* texture;
+    };
 
-    void UpdateInstanceBuffer(const std::vector<glm::mat4>& transforms, const std::vector<glm::vec4>& colors, const std::vector<glm::vec2>& uvOffsets, const std::vector<glm::vec2>& uvScales) const;
+    struct UniformEntry
+    {
+        UniformID id;
+        GLint location;     ///< Resolved from the shader when the uniform is first set; -1 if the shader lacks it.
+        UniformValue value;
 
-    [[nodiscard]] Shader* GetShader() const { return shader; }
+        bool operator==(const UniformEntry& other) const { return id == other.id && value == other.value; }
+        bool operator!=(const UniformEntry& other) const { return !(*this == other); }
+    };
+
+    /// Sends textures and uniforms copied from a material, to the program that material's shader has bound.
+    static void SendUniforms(const TextureBinding* textureBindings, size_t textureCount, const UniformEntry* uniformEntries, size_t uniformCount);
 
     Shader* shader;
-    std::unordered_map<std::string, Texture*> textures;
-    std::unordered_map<std::string, UniformValue> uniforms;
+    uint32_t sortID;
+    std::vector<TextureBinding> textures;  ///< In texture unit order.
+    std::vector<UniformEntry> uniforms;    ///< Sorted by ID, so materials with the same values compare equal.
 
-    GLuint instanceVBO[4];
     bool isInstancingEnabled;
+
+    Material* batchMaterial = nullptr;
+    Material* spriteBatchMaterial = nullptr; ///< Copy of this material on its shader's sprite batch variant, created on first use.
+    uint32_t textureLayer = 0;
+    glm::vec4 textureUVRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
 };
@@ -1,8 +1,12 @@
 #pragma once
 #include <vector>
+#include "InstanceData.h"
 #include "Material.h"
 
 class ObjectManager;
+class StaticBatcher;
+class MeshPool;
+class SpriteBatcher;
 
 using GLuint = unsigned int;
 using GLsizei = int;
@@ -26,6 +30,9 @@ struct Vertex
 class Mesh {
     friend Material;
     friend RenderManager;
+    friend StaticBatcher;
+    friend MeshPool;
+    friend SpriteBatcher;
 
 public:
     Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices = {}, PrimitiveType primitiveType = PrimitiveType::Triangles);
@@ -34,10 +41,27 @@ public:
 
     [[nodiscard]] glm::vec2 GetLocalBoundsHalfSize() const { return localHalfSize; }
 
+    [[nodiscard]] uint32_t GetSortID() const { return sortID; }
+
+    /// Only triangle lists keep the CPU copy StaticBatcher needs.
+    [[nodiscard]] bool CanBeBaked() const { return !bakeVertices.empty(); }
+
+    /// Whether the geometry was also copied into the RenderManager's MeshPool for indirect draws.
+    [[nodiscard]] bool IsPooled() const { return isPooled; }
+
 private:
     void BindVAO() const;
 
-    void SetupInstanceAttributes(GLuint* instanceVBO) const;
+    void SetupInstanceAttributes(InstanceLayout layout) const;
+
+    void BindInstanceStreams(InstanceLayout layout, GLuint buffer, size_t offset, GLsizei instanceCount, bool hasTextureLayers = false) const;
+
+    // VAO setup shared with MeshPool and StaticBatcher, which own VAOs in the same vertex format.
+    static void SetupVertexFormat(GLuint vao, GLuint vbo);
+
+    static void SetupInstanceAttributes(GLuint vao, InstanceLayout layout, InstanceLayout& activeLayout, uint8_t& configuredLayouts);
+
+    static void BindInstanceStreams(GLuint vao, InstanceLayout layout, GLuint buffer, size_t offset, GLsizei instanceCount, bool hasTextureLayers);
 
     void Draw() const;
 
@@ -72,13 +96,33 @@ private:
         localHalfSize = size * 0.5f;
     }
 
+    uint32_t sortID;
     GLuint vao;
     GLuint vbo;
     GLuint ebo;
     GLsizei indexCount;
 
     bool useIndex;
+    static constexpr GLuint FULL_MODEL_LOCATION = 2;
+    static constexpr GLuint FULL_LAST_LOCATION = 8;
+    static constexpr GLuint COMPACT_FIRST_LOCATION = 9;
+    static constexpr GLuint COMPACT_LAST_LOCATION = 12;
+    static constexpr GLuint COMPACT_BINDING = 5;
+    static constexpr GLuint RESIDENT_SLOT_LOCATION = 13;
+    static constexpr GLuint RESIDENT_BINDING = 6;
+    static constexpr GLuint TEXTURE_LAYER_LOCATION = 14;
+    static constexpr GLuint TEXTURE_LAYER_BINDING = 7;
+
+    mutable InstanceLayout activeInstanceLayout = InstanceLayout::None;
+    mutable uint8_t configuredInstanceLayouts = 0;
 
     PrimitiveType primitiveType;
     glm::vec2 localHalfSize;
+
+    std::vector<Vertex> bakeVertices;
+    std::vector<unsigned int> bakeIndices;
+
+    int32_t poolBaseVertex = 0;
+    uint32_t poolFirstIndex = 0;
+    bool isPooled = false;
 };
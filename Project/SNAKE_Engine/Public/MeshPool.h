@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "InstanceData.h"
+
+class Mesh;
+class RenderManager;
+
+using GLuint = unsigned int;
+using GLsizei = int;
+
+/**
+ * @brief Layout of one command in a GL_DRAW_INDIRECT_BUFFER for glMultiDrawElementsIndirect.
+ */
+struct DrawElementsIndirectCommand
+{
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+};
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "DrawElementsIndirectCommand must match the GL layout");
+
+/**
+ * @brief One vertex and index buffer shared by every pooled mesh, with a single VAO.
+ *
+ * @details
+ * RenderManager appends each registered triangle-list mesh to the pool, so meshes of the same
+ * vertex format can be drawn together with one glMultiDrawElementsIndirect, each command pointing
+ * at its mesh through firstIndex and baseVertex. The pool only grows; geometry stays until the
+ * RenderManager is destroyed.
+ */
+class MeshPool
+{
+    friend RenderManager;
+public:
+    MeshPool() = default;
+    ~MeshPool();
+
+    MeshPool(const MeshPool&) = delete;
+    MeshPool& operator=(const MeshPool&) = delete;
+
+    [[nodiscard]] size_t GetVertexCount() const { return vertexCount; }
+
+    [[nodiscard]] size_t GetIndexCount() const { return indexCount; }
+
+private:
+    void Init(size_t initialVertexCount, size_t initialIndexCount);
+
+    /// Copies the mesh's triangles into the pool. Meshes that are not triangle lists are skipped.
+    void Add(Mesh* mesh);
+
+    void Reserve(size_t requiredVertexCount, size_t requiredIndexCount);
+
+    void BindVAO() const;
+
+    void BindInstanceStreams(InstanceLayout layout, GLuint buffer, size_t offset, GLsizei instanceCount, bool hasTextureLayers) const;
+
+    [[nodiscard]] static DrawElementsIndirectCommand MakeCommand(const Mesh* mesh, uint32_t instanceCount, uint32_t baseInstance);
+
+    void Free();
+
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    GLuint ebo = 0;
+    size_t vertexCapacity = 0;
+    size_t vertexCount = 0;
+    size_t indexCapacity = 0;
+    size_t indexCount = 0;
+
+    mutable InstanceLayout activeInstanceLayout = InstanceLayout::None;
+    mutable uint8_t configuredInstanceLayouts = 0;
+};
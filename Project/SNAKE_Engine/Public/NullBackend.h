@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+using GLuint = unsigned int;
+
+/**
+ * @brief GL work recorded by the null backend since the last ResetStats.
+ */
+struct NullBackendStats
+{
+    size_t callCount = 0;          ///< Every GL entry point the engine called.
+    size_t drawCount = 0;          ///< glDraw* calls plus the draws inside each multi-draw.
+    size_t instanceCount = 0;      ///< Instances submitted by all draws; a non-instanced draw counts as one.
+    size_t programBindCount = 0;
+    size_t vertexArrayBindCount = 0;
+    size_t textureBindCount = 0;
+    size_t bufferBindCount = 0;    ///< glBindBuffer and glBindBufferBase.
+    size_t uniformCount = 0;       ///< glUniform* calls.
+    size_t bufferUploadCount = 0;  ///< Buffer data, sub data and copy calls that carry bytes.
+    size_t bufferUploadBytes = 0;
+    size_t textureUploadCount = 0;
+    size_t textureUploadBytes = 0;
+    size_t mappedBytes = 0;        ///< Bytes handed out by glMapNamedBufferRange.
+    size_t createdCount = 0;       ///< Buffers, vertex arrays, textures, framebuffers, shaders, programs, queries and fences.
+    size_t deletedCount = 0;
+};
+
+/**
+ * @brief One GL call as seen by the null backend, kept while recording is enabled.
+ */
+struct NullCommand
+{
+    const char* function = nullptr; ///< GL entry point name, e.g. "glDrawElementsInstanced".
+    GLuint object = 0;              ///< Buffer, texture, program or vertex array the call acts on, if any.
+    size_t count = 0;               ///< Elements, instances, draws or objects, depending on the call.
+    size_t bytes = 0;               ///< Bytes uploaded or mapped.
+};
+
+/**
+ * @brief GL backend that records the command stream instead of talking to a driver.
+ *
+ * @details
+ * The engine reaches GL only through glad's function pointers, so the backend is chosen when they
+ * are loaded: the GL backend loads them from the context, and Load points them at recording stubs
+ * that need no window, context or GPU. RenderManager, Material, Mesh, Texture, Font and GLState run
+ * unchanged on top, which keeps the CPU cost of recording, sorting, batching and uploading
+ * measurable on headless machines.
+ *
+ * The stubs answer queries the way a conforming driver would: objects get unique names, compiles
+ * and links succeed, mapped buffers are backed by host memory, fences and queries are signaled
+ * at once, and programs are reflected from their GLSL source, so attribute, uniform and uniform
+ * block lookups match what the GL backend reports and the same draw paths are taken. Nothing is
+ * rasterized and texture readbacks return zeros.
+ *
+ * Only the entry points the engine calls are stubbed; the rest stay null, so a new GL call needs a
+ * stub here before it runs headless. The state is global, like the GL context it replaces.
+ */
+class NullBackend
+{
+public:
+    /// Points glad at the recording stubs. Returns false if glad rejects them.
+    [[nodiscard]] static bool Load();
+
+    /// True once Load succeeded, i.e. the engine is running without a GL context.
+    [[nodiscard]] static bool IsActive();
+
+    [[nodiscard]] static const NullBackendStats& GetStats();
+
+    static void ResetStats();
+
+    /// Starts or stops appending every call to the command log. Recording is off by default.
+    static void SetRecording(bool shouldRecord);
+
+    [[nodiscard]] static const std::vector<NullCommand>& GetCommands();
+
+    static void ClearCommands();
+};
@@ -7,6 +7,10 @@
 #include "Mesh.h"
 #include "Transform.h"
 class FrustumCuller;
+class CullingBounds;
+class VisibilityGrid;
+class InstanceStore;
+class StaticBatcher;
 struct EngineContext;
 enum class ObjectType
 {
@@ -16,6 +20,10 @@ enum class ObjectType
 class Object
 {
     friend FrustumCuller;
+    friend CullingBounds;
+    friend VisibilityGrid;
+    friend InstanceStore;
+    friend StaticBatcher;
 public:
     Object() = delete;
     virtual void Init([[maybe_unused]] const EngineContext& engineContext) = 0;
@@ -55,8 +63,31 @@ public:
 
     [[nodiscard]] bool CanBeInstanced() const;
 
+    /**
+     * @brief Marks the object as not moving, so ObjectManager::DrawAll bakes it into merged static geometry.
+     *
+     * @details
+     * Static objects may still change; their chunk is rebuilt on the next draw. Objects that change
+     * every frame should stay dynamic. See StaticBatcher for what can be baked.
+     */
+    void SetStatic(bool shouldBeStatic) { isStatic = shouldBeStatic; }
+    [[nodiscard]] bool IsStatic() const { return isStatic; }
+
+    /**
+     * @brief Lets RenderManager merge the object into sprite batches; see RenderManager::SetSpriteBatchShader.
+     *
+     * @details
+     * A batch runs only its first object's Draw hook, so only opt in objects whose Draw sets no
+     * per-object state, or whose state is the same for every object of the batch.
+     */
+    void SetSpriteBatchable(bool shouldBeBatched) { isSpriteBatchable = shouldBeBatched; }
+    [[nodiscard]] bool IsSpriteBatchable() const { return isSpriteBatchable; }
+
     [[nodiscard]] glm::mat4 GetTransform2DMatrix();
 
+    /// Matrix to draw with between simulation ticks; see Transform2D::GetInterpolatedMatrix.
+    [[nodiscard]] glm::mat4 GetInterpolatedTransform2DMatrix(float alpha);
+
     [[nodiscard]] Transform2D& GetTransform2D();
 
     void SetColor(const  glm::vec4& color_);
@@ -89,6 +120,9 @@ public:
     void SetFlipUV_Y(bool shouldFlip) { flipUV_Y = shouldFlip; }
     [[nodiscard]] glm::vec2 GetUVFlipVector() const;
 
+    /// UV offset (xy) and scale (zw) to draw with: the animation frame, else the material's atlas sub-rect.
+    [[nodiscard]] glm::vec4 GetUVRect();
+
 protected:
     Object(ObjectType objectType) : type(objectType) {}
     ObjectType type;
@@ -97,6 +131,8 @@ protected:
 
     bool isAlive = true;
     bool isVisible = true;
+    bool isStatic = false;
+    bool isSpriteBatchable = false;
 
     bool ignoreCamera = false;
     Camera2D* referenceCamera = nullptr;
@@ -118,4 +154,9 @@ protected:
 
     bool flipUV_X = false;
     bool flipUV_Y = false;
+
+private:
+    uint32_t instanceSlot = UINT32_MAX;
+    uint32_t staticBatchMember = UINT32_MAX;
+    uint32_t visibilityRecord = UINT32_MAX;
 };
@@ -26,12 +26,31 @@ public:
 
     void FreeAll(const EngineContext& engineContext);
 
+    /// Stores every object's pose as the start point of render interpolation; see Transform2D::StorePreviousPose.
+    void StorePreviousPoses();
+
     [[nodiscard]] Object* FindByTag(const std::string& tag) const;
     void FindByTag(const std::string& tag, std::vector<Object*>& result);
     void CheckCollision();
     void DrawColliderDebug(RenderManager* rm, Camera2D* cam);
 
     [[nodiscard]] CollisionGroupRegistry& GetCollisionGroupRegistry() { return collisionGroupRegistry; }
+
+    /**
+     * @brief Culls DrawAll through a persistent spatial index instead of testing every object.
+     *
+     * @details
+     * Worth enabling for large worlds where the camera only sees a small part of the scene.
+     * Objects that ignore the camera are always drawn and are not stored in the index.
+     */
+    void SetUseSpatialIndex(bool shouldUse, float cellSize = VisibilityGrid::DEFAULT_CELL_SIZE);
+
+    [[nodiscard]] bool IsUsingSpatialIndex() const { return useSpatialIndex; }
+
+    [[nodiscard]] const VisibilityGrid& GetVisibilityGrid() const { return visibilityGrid; }
+
+    /// Static objects are only baked by DrawAll; DrawObjects and DrawObjectsWithTag draw them like any other object.
+    [[nodiscard]] const StaticBatcher& GetStaticBatcher() const { return staticBatcher; }
 private:
     void AddAllPendingObjects(const EngineContext& engineContext);
     void EraseDeadObjects(const EngineContext& engineContext);
@@ -40,6 +59,11 @@ private:
     std::vector<std::unique_ptr<Object>> pendingObjects;
     std::unordered_map<std::string, Object*> objectMap;
     std::vector<Object*> rawPtrObjects;
+    std::vector<Object*> dynamicObjects;
+    StaticBatcher staticBatcher;
+    CullingBounds cullingBounds;
+    VisibilityGrid visibilityGrid;
+    bool useSpatialIndex = false;
     SpatialHashGrid broadPhaseGrid;
     CollisionGroupRegistry collisionGroupRegistry;
 };
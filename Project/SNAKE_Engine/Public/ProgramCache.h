@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class ShaderStage;
+class Shader;
+
+using GLuint = unsigned int;
+
+/**
+ * @brief Shader programs linked since startup, split by whether they came from the cache.
+ */
+struct ProgramCacheStats
+{
+    size_t loadedCount = 0;    ///< Programs restored from a cached binary.
+    size_t compiledCount = 0;  ///< Programs compiled and linked from source, including rejected binaries.
+    size_t storedCount = 0;    ///< Binaries written for the compiled programs.
+    double loadMs = 0.0;       ///< Time Shader::BeginLink and FinishLink blocked for loaded programs.
+    double compileMs = 0.0;    ///< Time they blocked for compiled programs, including writing the binary.
+};
+
+/**
+ * @brief On-disk cache of linked shader programs, so later launches skip GLSL compilation.
+ *
+ * @details
+ * Shader::BeginLink looks a program up by a key hashed from its stages, their sources and the driver's
+ * GL_VENDOR, GL_RENDERER and GL_VERSION strings, and restores it with glProgramBinary. When no
+ * binary exists, or the driver rejects it, the program is compiled from source as before and its
+ * glGetProgramBinary result is written to `<directory>/<key>.bin` for the next launch.
+ *
+ * A changed source or driver yields a new key, so stale binaries are never loaded; they stay on
+ * disk until the directory is cleared. The cache is off when the directory is empty, as it is by default, or the driver
+ * supports no binary formats, e.g. under NullBackend.
+ */
+class ProgramCache
+{
+    friend Shader;
+public:
+    /// Directory the binaries are read from and written to, created on first write. Empty disables the cache.
+    static void SetDirectory(const std::string& directory);
+
+    [[nodiscard]] static const std::string& GetDirectory();
+
+    [[nodiscard]] static const ProgramCacheStats& GetStats();
+
+private:
+    /// False while disabled. Queries the driver once, so it needs a current context.
+    [[nodiscard]] static bool IsEnabled();
+
+    [[nodiscard]] static uint64_t MakeKey(const std::vector<ShaderStage>& stages, const std::vector<std::string>& sources);
+
+    /// Restores @p program from the binary stored under @p key. False if there is none or the driver rejects it.
+    [[nodiscard]] static bool Load(GLuint program, uint64_t key);
+
+    /// Asks the driver to keep @p program's binary retrievable; call before linking it.
+    static void PrepareForStore(GLuint program);
+
+    /// Writes the binary of the linked @p program under @p key.
+    static void Store(GLuint program, uint64_t key);
+
+    static void RecordLink(bool wasLoaded, double ms);
+};
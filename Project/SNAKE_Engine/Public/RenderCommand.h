@@ -0,0 +1,179 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "InstanceData.h"
+
+class Object;
+class Mesh;
+class Material;
+class StaticBatcher;
+
+using GLuint = unsigned int;
+
+enum class RenderCommandType : uint8_t
+{
+    DrawInstanced,
+    DrawSingle,
+    DrawStatic,
+    DrawMultiIndirect,
+    DrawSpriteBatch,
+    BeginLayer,
+    SetLayerTarget,
+    CompositeLayer,
+    BeginScaledScene,
+    UpscaleScene,
+    SetViewport,
+    Clear,
+    UserCallback
+};
+
+/**
+ * @brief Textures and uniforms a draw sends, copied out of its material when the command is resolved.
+ *
+ * @details
+ * Ranges into RenderManager's per-frame snapshot arrays. Resolving runs the Draw hooks and fills
+ * in the per-draw uniforms on the recording thread, so executing the command never reads an
+ * Object or a Material that game code may be changing in the meantime.
+ */
+struct MaterialSnapshot
+{
+    uint32_t firstTexture;
+    uint32_t textureCount;
+    uint32_t firstUniform;
+    uint32_t uniformCount;
+};
+
+struct DrawInstancedCommand
+{
+    Mesh* mesh;
+    Material* material;
+    Object* front;          ///< First object of the batch, used for per-batch uniforms and its Draw hook.
+    uint32_t viewIndex;     ///< Entry of the frame's CameraBuffer the batch is drawn with.
+    GLuint instanceBuffer;  ///< Ring buffer storage holding the batch's instance streams.
+    uint32_t instanceCount;
+    size_t instanceOffset;
+    InstanceLayout layout;  ///< Layout the instance data was written in.
+    MaterialSnapshot snapshot;
+};
+
+struct DrawSingleCommand
+{
+    Mesh* mesh;
+    Material* material;
+    Object* object;
+    uint32_t viewIndex;
+    MaterialSnapshot snapshot;
+};
+
+struct DrawStaticCommand
+{
+    const StaticBatcher* batcher;
+    uint32_t chunk;         ///< Index of the baked chunk inside the batcher.
+    uint32_t viewIndex;
+    MaterialSnapshot snapshot;
+};
+
+struct DrawMultiIndirectCommand
+{
+    Material* material;
+    Object* front;          ///< First object of the run, used for per-run uniforms and its Draw hook.
+    uint32_t viewIndex;
+    GLuint instanceBuffer;  ///< Ring buffer storage holding the instance streams of the whole run.
+    uint32_t instanceCount;
+    size_t instanceOffset;
+    GLuint indirectBuffer;  ///< Ring buffer storage holding one DrawElementsIndirectCommand per mesh.
+    uint32_t drawCount;
+    size_t indirectOffset;
+    InstanceLayout layout;
+    MaterialSnapshot snapshot;
+};
+
+struct DrawSpriteBatchCommand
+{
+    Material* material;     ///< Sprite batch material the run is drawn with.
+    Material* source;       ///< Batch material of the run's objects; its textures and uniforms are mirrored onto material.
+    Object* front;          ///< First object of the run, used for per-run uniforms and its Draw hook.
+    uint32_t viewIndex;
+    GLuint buffer;          ///< Ring buffer storage holding the run's SpriteVertex data followed by its indices.
+    size_t vertexOffset;
+    size_t indexOffset;
+    uint32_t indexCount;
+    MaterialSnapshot snapshot;
+};
+
+struct BeginLayerCommand
+{
+    uint8_t layer;          ///< Render layer the following draws belong to, until the next BeginLayer.
+};
+
+struct SetLayerTargetCommand
+{
+    int layer;              ///< Cached layer whose target the following draws render into, or -1 for the frame's own target.
+};
+
+struct CompositeLayerCommand
+{
+    uint8_t layer;          ///< Cached layer whose target is blended over the frame's own target.
+};
+
+/**
+ * @brief Scene and window size of a frame drawn with dynamic resolution.
+ *
+ * BeginScaledScene redirects the following commands into the scaled scene target; UpscaleScene
+ * blends that target over the window and returns to it. Clear and SetViewport rects stay in window
+ * pixels and are scaled in between.
+ */
+struct SceneTargetCommand
+{
+    int sceneWidth, sceneHeight;
+    int windowWidth, windowHeight;
+};
+
+struct SetViewportCommand
+{
+    int x, y, width, height;
+};
+
+struct ClearCommand
+{
+    int x, y, width, height;
+    float color[4];
+};
+
+struct UserCallbackCommand
+{
+    uint32_t callbackIndex; ///< Index into RenderManager's user callback list.
+};
+
+/**
+ * @brief One entry of the render command stream.
+ *
+ * @details
+ * Commands are plain data recorded into a reusable array and executed in order by
+ * RenderManager. Anything that cannot be expressed as data goes through UserCallback,
+ * which refers to a std::function stored next to the stream.
+ *
+ * Draw commands are resolved before they execute, which fills in their MaterialSnapshot.
+ * With a render thread the whole stream is resolved on the main thread and executed on
+ * the render thread; otherwise each command is resolved right before it executes.
+ */
+struct RenderCommand
+{
+    RenderCommandType type;
+    union
+    {
+        DrawInstancedCommand drawInstanced;
+        DrawSingleCommand drawSingle;
+        DrawStaticCommand drawStatic;
+        DrawMultiIndirectCommand drawMultiIndirect;
+        DrawSpriteBatchCommand drawSpriteBatch;
+        BeginLayerCommand beginLayer;
+        SetLayerTargetCommand setLayerTarget;
+        CompositeLayerCommand compositeLayer;
+        SceneTargetCommand sceneTarget;
+        SetViewportCommand setViewport;
+        ClearCommand clear;
+        UserCallbackCommand userCallback;
+    };
+};
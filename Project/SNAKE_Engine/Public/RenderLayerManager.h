@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -7,6 +8,17 @@
 
 #include "Debug.h"
 
+class RenderManager;
+
+/**
+ * @brief How often a cached layer was composited from its target and how often it was re-rendered.
+ */
+struct LayerCacheStats
+{
+    size_t hitCount = 0;
+    size_t missCount = 0;
+};
+
 class RenderLayerManager
 {
     friend RenderManager;
@@ -26,6 +38,68 @@ public:
         return idToName.at(id);
     }
 
+    /// Treats every object on the layer as static (see Object::SetStatic).
+    void SetStatic(const std::string& name, bool isStatic)
+    {
+        auto it = nameToID.find(name);
+        if (it == nameToID.end())
+        {
+            SNAKE_WRN("There is no render layer named '" << name << "'\n");
+            return;
+        }
+        staticLayers[it->second] = isStatic;
+    }
+
+    [[nodiscard]] bool IsStatic(uint8_t id) const
+    {
+        return id < MAX_LAYERS && staticLayers[id];
+    }
+
+    /**
+     * @brief Renders the layer into an offscreen target and reuses it while nothing on it changes.
+     *
+     * @details
+     * The layer is re-rendered when an object drawn on it moves, changes color, UV rect, flip,
+     * material, mesh or visibility, enters or leaves view, when its camera moves or zooms, or when
+     * the window is resized. Otherwise the previous rendering is composited with a single
+     * full-screen draw, and the layer's Object::Draw hooks do not run. Changes the signature cannot
+     * see, such as uniforms set on a shared Material, need InvalidateCache.
+     */
+    void SetCached(const std::string& name, bool isCached)
+    {
+        auto it = nameToID.find(name);
+        if (it == nameToID.end())
+        {
+            SNAKE_WRN("There is no render layer named '" << name << "'\n");
+            return;
+        }
+        cachedLayers[it->second] = isCached;
+        invalidatedLayers[it->second] = true;
+    }
+
+    [[nodiscard]] bool IsCached(uint8_t id) const
+    {
+        return id < MAX_LAYERS && cachedLayers[id];
+    }
+
+    /// Forces a cached layer to be re-rendered next frame.
+    void InvalidateCache(const std::string& name)
+    {
+        auto it = nameToID.find(name);
+        if (it != nameToID.end())
+            invalidatedLayers[it->second] = true;
+    }
+
+    [[nodiscard]] const LayerCacheStats& GetCacheStats(uint8_t id) const
+    {
+        return cacheStats.at(id);
+    }
+
+    void ResetCacheStats()
+    {
+        cacheStats.fill({});
+    }
+
 private:
     void RegisterLayer(const std::string& name)
     {
@@ -49,5 +123,9 @@ private:
 
     std::unordered_map<std::string, uint8_t> nameToID;
     std::array<std::string, MAX_LAYERS> idToName;
+    std::array<bool, MAX_LAYERS> staticLayers{};
+    std::array<bool, MAX_LAYERS> cachedLayers{};
+    std::array<bool, MAX_LAYERS> invalidatedLayers{};
+    std::array<LayerCacheStats, MAX_LAYERS> cacheStats{};
     uint8_t nextID = 0;
 };
@@ -14,29 +14,74 @@
 #include "Shader.h"
 #include "Texture.h"
 #include "Camera2D.h"
+#include "CameraBuffer.h"
+#include "DebugRenderer.h"
+#include "CullingBounds.h"
+#include "DrawItem.h"
 #include "Font.h"
+#include "FrustumCuller.h"
 #include "GameObject.h"
+#include "GLState.h"
+#include "GpuProfiler.h"
 #include "InstanceBatchKey.h"
+#include "InstanceStore.h"
+#include "LayerCache.h"
+#include "MeshPool.h"
+#include "RenderCommand.h"
 #include "RenderLayerManager.h"
+#include "ResolutionScaler.h"
+#include "RingBuffer.h"
+#include "SpriteBatcher.h"
+#include "StaticBatcher.h"
+#include "TextureAtlas.h"
+#include "ThreadPool.h"
+#include "VisibilityGrid.h"
 
 struct TextInstance;
+class TextObject;
 class SNAKE_Engine;
 class StateManager;
 
 using TextureTag = std::string;
 using UniformName = std::string;
 using FilePath = std::string;
-using RenderCommand = std::function<void()>;
 
-using ShaderMap = std::map<Shader*, std::map<InstanceBatchKey, std::vector<std::pair<Object*, Camera2D*>>>>;
-using RenderMap = std::array<ShaderMap, RenderLayerManager::MAX_LAYERS>;
+/**
+ * @brief Batch, draw call, state change and upload counts of the last executed frame.
+ *
+ * @details
+ * A batch is one group of consecutive draw items sharing mesh, material and camera, or one static
+ * chunk. Non-instanced batches cost one draw call per object unless they are sprite batched; a
+ * multi-draw run or a sprite batch counts as one batch drawn with one call. State changes are the
+ * binds GLState forwarded to GL, and suppressed ones the binds it skipped as redundant. Debug
+ * shapes and user callbacks are not counted.
+ *
+ * Instances are the objects drawn, including those baked into static chunks. Uploaded bytes cover
+ * the instance ring buffer, resident instance updates and the camera block.
+ */
+struct RenderStats
+{
+    size_t batchCount = 0;
+    size_t drawCallCount = 0;
+    size_t instanceCount = 0;
+    size_t stateChangeCount = 0;
+    size_t suppressedStateChangeCount = 0;
+    size_t textureBindCount = 0;
+    size_t uploadedBytes = 0;
+};
 
-struct LineInstance
+/**
+ * @brief How RenderManager turns instanced batches into GL draw calls.
+ *
+ * @details
+ * Direct issues one glDraw*Instanced per mesh/material batch. MultiDrawIndirect draws every
+ * consecutive batch of the same material and camera whose meshes live in the shared MeshPool with
+ * one glMultiDrawElementsIndirect, writing one DrawElementsIndirectCommand per mesh.
+ */
+enum class SubmissionMode : uint8_t
 {
-    glm::vec2 from = { 0,0 };
-    glm::vec2 to = { 0,0 };
-    glm::vec4 color = { 1,1,1,1 };
-    float lineWidth = 1;
+    Direct,
+    MultiDrawIndirect
 };
 
 class RenderManager
@@ -46,6 +91,11 @@ class RenderManager
     friend SNAKE_Engine;
 
 public:
+    RenderManager() = default;
+
+    ~RenderManager();
+
+    /// Starts compiling @p sources and returns without waiting; see WaitForShaders.
     void RegisterShader(const std::string& tag, const std::vector<std::pair<ShaderStage, FilePath>>& sources);
 
     void RegisterShader(const std::string& tag, std::unique_ptr<Shader> shader);
@@ -72,6 +122,18 @@ public:
 
 
 
+    /**
+     * @brief Finishes every shader registration still compiling, reporting errors and reflecting the programs.
+     *
+     * @details
+     * RegisterShader only submits the sources to the driver, so registering shaders first and
+     * loading textures, fonts and sounds afterwards overlaps compilation with that work. A pending
+     * shader is also finished on its own when it is looked up by GetShaderByTag or RegisterMaterial,
+     * and everything left is finished before a frame is drawn.
+     */
+    void WaitForShaders();
+
+    /// Finishes the shader's registration first if it is still compiling.
     [[nodiscard]] Shader* GetShaderByTag(const std::string& tag);
 
     [[nodiscard]] Texture* GetTextureByTag(const std::string& tag);
@@ -84,6 +146,14 @@ public:
 
     SpriteSheet* GetSpriteSheetByTag(const std::string& tag);
 
+    /**
+     * @brief Records @p drawFunc to be called, with the context current, at this point of the frame.
+     *
+     * @details
+     * With EngineConfig::useRenderThread the call happens on the render thread, after the main
+     * thread has moved on to the next frame. The callback must therefore only issue GL calls and
+     * read what it captured by value, not objects the game may change in the meantime.
+     */
     void Submit(std::function<void()>&& drawFunc);
 
     void FlushDrawCommands(const EngineContext& engineContext);
@@ -94,48 +164,310 @@ public:
 
     void DrawDebugLine(const glm::vec2& from, const glm::vec2& to, Camera2D* camera = nullptr, const glm::vec4& color = { 1,1,1,1 }, float lineWidth = 1.0f);
 
+    /// Rect outline around @p center. @p lineWidth is in screen pixels, as for every debug shape.
+    void DrawDebugRect(const glm::vec2& center, const glm::vec2& halfSize, Camera2D* camera = nullptr, const glm::vec4& color = { 1,1,1,1 }, float lineWidth = 1.0f);
+
+    void DrawDebugCircle(const glm::vec2& center, float radius, Camera2D* camera = nullptr, const glm::vec4& color = { 1,1,1,1 }, float lineWidth = 1.0f);
+
+    [[nodiscard]] const DebugRenderer& GetDebugRenderer() const;
+
     [[nodiscard]] RenderLayerManager& GetRenderLayerManager();
+
+    [[nodiscard]] const RingBufferStats& GetInstanceStreamStats() const;
+
+    [[nodiscard]] const InstanceStoreStats& GetInstanceStoreStats() const;
+
+    void SetSubmissionMode(SubmissionMode mode);
+
+    [[nodiscard]] SubmissionMode GetSubmissionMode() const;
+
+    [[nodiscard]] const MeshPool& GetMeshPool() const;
+
+    /**
+     * @brief Lets non-instanced materials of @p shaderTag be drawn as dynamic sprite batches.
+     *
+     * @details
+     * @p batchShaderTag is the variant the batches are drawn with. It reads position, UV and the
+     * object color per vertex (`aColor` at SpriteBatcher::COLOR_LOCATION) and has no `u_Model` or
+     * `u_Color`; textures and other uniforms are mirrored from the original material by name. The
+     * built-in `internal_sprite_batch` variant samples `u_Texture` and multiplies it by the color,
+     * which matches a plain textured sprite shader.
+     *
+     * Consecutive objects with the same material and camera are then transformed on the CPU and
+     * drawn with one call instead of one per object. Only the first object's Draw hook runs, so
+     * objects take part only after Object::SetSpriteBatchable opts them in; the rest are drawn one
+     * by one with their own hooks as before.
+     */
+    void SetSpriteBatchShader(const std::string& shaderTag, const std::string& batchShaderTag = "internal_sprite_batch");
+
+    void SetSpriteBatching(bool enable);
+
+    [[nodiscard]] bool IsSpriteBatchingEnabled() const;
+
+    [[nodiscard]] const RenderStats& GetRenderStats() const;
+
+    /// GPU time per render layer and for debug shapes, a few frames behind so reading it never stalls.
+    [[nodiscard]] const GpuTimings& GetGpuTimings() const;
+
+    /**
+     * @brief Shows RenderStats and GpuTimings as text in the top-left corner of the screen.
+     *
+     * @details
+     * The overlay is a TextObject owned by RenderManager and drawn above every render layer. Its text
+     * is refreshed every few frames from the previous frame's numbers.
+     */
+    void SetStatsOverlay(bool enable, const std::string& fontTag = "default");
+
+    [[nodiscard]] bool IsStatsOverlayEnabled() const;
+
+    /**
+     * @brief Renders the scene below window resolution when the GPU falls behind, then upscales it.
+     *
+     * @details
+     * Each frame the scene is drawn into an offscreen target whose size follows the measured GPU
+     * time towards DynamicResolutionSettings::budgetMs, and the target is stretched over the window.
+     * With renderUiAtNativeResolution, objects that ignore the camera are drawn afterwards at full
+     * resolution, on top of every camera-space layer. Camera screen sizes, culling and mouse
+     * coordinates stay in window pixels; see ResolutionScaler.
+     */
+    void SetDynamicResolution(const DynamicResolutionSettings& settings);
+
+    [[nodiscard]] const DynamicResolutionSettings& GetDynamicResolution() const;
+
+    /// Fraction of the window size, per axis, the scene was last drawn at; 1 without dynamic resolution.
+    [[nodiscard]] float GetResolutionScale() const;
+
+    /**
+     * @brief Packs the textures of instancing materials into texture arrays so they batch together.
+     *
+     * @details
+     * Only materials whose shader declares `i_TextureLayer` (and samples `u_Texture` as a sampler2DArray)
+     * are merged. Materials with the same shader, the same uniforms and exactly one texture of the same
+     * size and format share one array and one batch material; each instance streams its texture's layer.
+     * Call it after registering the materials; materials registered later need another call, and uniforms
+     * set on a merged material afterwards are not seen by its batch material.
+     */
+    void MergeTextureArrays();
+
+    /**
+     * @brief Queues a registered texture to be packed into the atlas of @p atlasGroup by BuildTextureAtlases.
+     */
+    void AddTextureToAtlas(const std::string& textureTag, const std::string& atlasGroup = "default");
+
+    /**
+     * @brief Packs the queued textures and redirects the materials using them to the atlas pages.
+     *
+     * @details
+     * A material is redirected when it has exactly one texture, that texture was packed, and its shader
+     * can draw a sub-rect: any instancing shader, or one with `u_UVOffset` and `u_UVScale` uniforms.
+     * Materials with the same shader and uniforms whose textures landed on the same page share one
+     * batch material, so their objects batch together; each object samples its material's sub-rect.
+     * Other materials keep drawing from the original texture.
+     */
+    void BuildTextureAtlases();
+
+    [[nodiscard]] const TextureAtlas* GetTextureAtlas(const std::string& atlasGroup) const;
 private:
     void Init(const EngineContext& engineContext);
 
-    void BuildRenderMap(const std::vector<Object*>& source, Camera2D* camera);
+    void BuildDrawItems(Object* const* objects, size_t count, Camera2D* camera, glm::vec2 viewportSize, std::vector<DrawItem>& out) const;
+
+    void BuildDrawItems(Object* const* objects, const uint32_t* indices, size_t count, Camera2D* camera, std::vector<DrawItem>& out) const;
+
+    void AppendDrawItem(Object* obj, Camera2D* camera, std::vector<DrawItem>& out) const;
+
+    void SubmitDrawItems(const EngineContext& engineContext);
+
+    /**
+     * @brief Records draw items [itemBegin, itemEnd) and static items [staticBegin, staticEnd) layer by layer.
+     *
+     * @p viewportSize is the size the layers are rendered at, @p windowSize the size of cache targets.
+     * Layers already set in @p recordedLayers are drawn uncached; every recorded layer is set.
+     */
+    void RecordLayers(size_t itemBegin, size_t itemEnd, size_t staticBegin, size_t staticEnd,
+        glm::ivec2 windowSize, glm::ivec2 viewportSize, std::array<bool, RenderLayerManager::MAX_LAYERS>& recordedLayers);
+
+    /// Records the draws of one layer: draw items [itemBegin, itemEnd) merged with static items [staticBegin, staticEnd).
+    void RecordLayerDraws(size_t itemBegin, size_t itemEnd, size_t staticBegin, size_t staticEnd);
+
+    /// Records a cached layer as a composite of its target, re-rendering the target first when the layer changed.
+    void RecordCachedLayer(uint8_t layer, size_t itemBegin, size_t itemEnd, size_t staticBegin, size_t staticEnd, glm::ivec2 windowSize, glm::ivec2 viewportSize);
+
+    /// Hash of everything the layer's draws depend on: objects, their poses and looks, chunks and view matrices.
+    [[nodiscard]] uint64_t HashLayerContents(size_t itemBegin, size_t itemEnd, size_t staticBegin, size_t staticEnd);
+
+    /// Starts a new GPU timing scope when @p key belongs to another layer than the previous command.
+    void RecordLayerChange(uint64_t key);
+
+    void SubmitStatsOverlay(const EngineContext& engineContext);
+
+    [[nodiscard]] std::string FormatStatsOverlay() const;
+
+    [[nodiscard]] size_t FindBatchEnd(size_t batchBegin) const;
+
+    [[nodiscard]] RingAllocation WriteInstanceData(size_t begin, size_t count, InstanceLayout layout, bool hasTextureLayers);
+
+    /// Records one multi-draw for the run of batches starting at @p runBegin and returns where the run ends.
+    [[nodiscard]] size_t RecordMultiDrawRun(size_t runBegin, size_t firstBatchEnd);
+
+    /// Resolves the whole recorded frame ahead of execution, for a render thread to execute later.
+    void ResolveCommands(const EngineContext& engineContext);
+
+    /// Runs the Draw hook of a draw command, sets its per-draw uniforms and snapshots its material.
+    void ResolveCommand(RenderCommand& cmd, const EngineContext& engineContext);
+
+    void ResolveDrawInstanced(DrawInstancedCommand& cmd, const EngineContext& engineContext);
+
+    void ResolveDrawSingle(DrawSingleCommand& cmd, const EngineContext& engineContext);
+
+    void ResolveDrawStatic(DrawStaticCommand& cmd);
+
+    void ResolveDrawMultiIndirect(DrawMultiIndirectCommand& cmd, const EngineContext& engineContext);
+
+    void ResolveDrawSpriteBatch(DrawSpriteBatchCommand& cmd, const EngineContext& engineContext);
+
+    [[nodiscard]] MaterialSnapshot SnapshotMaterial(const Material* material);
+
+    void SendMaterialSnapshot(const MaterialSnapshot& snapshot) const;
+
+    /**
+     * @brief Executes the recorded frame: its command stream, then its debug shapes.
+     *
+     * @details
+     * Runs on whichever thread holds the GL context. Commands that were not resolved ahead are
+     * resolved one at a time right before they execute, which needs @p engineContext for the hooks.
+     */
+    void ExecuteFrame(const EngineContext& engineContext);
+
+    /// Publishes the stats of the executed frame and releases its ring regions. Runs on the main thread.
+    void FinishFrame();
 
-    void SubmitRenderMap(const EngineContext& engineContext);
+    void ExecuteCommands(const EngineContext& engineContext);
+
+    void ExecuteDrawInstanced(const DrawInstancedCommand& cmd);
+
+    void ExecuteDrawSingle(const DrawSingleCommand& cmd);
+
+    void ExecuteDrawStatic(const DrawStaticCommand& cmd);
+
+    void ExecuteDrawMultiIndirect(const DrawMultiIndirectCommand& cmd);
+
+    void ExecuteDrawSpriteBatch(const DrawSpriteBatchCommand& cmd);
+
+    [[nodiscard]] bool CanSpriteBatch(Object* obj) const;
+
+    /// Records one sprite batch for the run of items starting at @p runBegin and returns where the run ends.
+    [[nodiscard]] size_t RecordSpriteBatch(size_t runBegin);
+
+    [[nodiscard]] Material* GetSpriteBatchMaterial(Material* material);
+
+    void RecordStaticDraws(size_t& next, size_t end, uint64_t upToKey);
+
+    /// Index of the CameraBuffer view the item is drawn with, adding the view on first use this frame.
+    [[nodiscard]] uint32_t GetViewIndex(const DrawItem& item);
+
+    /// Selects the command's view in the material's shader: `u_CameraIndex` with a CameraBlock, else `u_Projection`.
+    void SetViewUniforms(Material* material, uint32_t viewIndex) const;
 
     void Submit(const EngineContext& engineContext, const std::vector<Object*>& objects, Camera2D* camera);
 
-    void FlushDebugLineDrawCommands(const EngineContext& engineContext);
+    void Submit(const EngineContext& engineContext, const std::vector<Object*>& objects, const CullingBounds& bounds, Camera2D* camera);
+
+    void Submit(const EngineContext& engineContext, const std::vector<Object*>& objects, const VisibilityGrid& grid, Camera2D* camera);
+
+    void Submit(const EngineContext& engineContext, const StaticBatcher& batcher, Camera2D* camera);
+
+    [[nodiscard]] size_t GetBuildChunkCount(size_t objectCount);
+
+    void MergeBuildChunks(size_t chunkCount);
+
+    /// Uploads the debug shapes of the frame when debug draws are enabled, and discards them either way.
+    void PrepareDebugDraws(const EngineContext& engineContext);
 
     std::unordered_map<std::string, std::unique_ptr<Shader>> shaderMap;
+    std::vector<Shader*> pendingShaders; ///< Registered shaders whose link has begun but not finished.
     std::unordered_map<std::string, std::unique_ptr<Texture>> textureMap;
     std::unordered_map<std::string, std::unique_ptr<Mesh>> meshMap;
     std::unordered_map<std::string, std::unique_ptr<Material>> materialMap;
     std::unordered_map<std::string, std::unique_ptr<Font>> fontMap;
     std::unordered_map<std::string, std::unique_ptr<SpriteSheet>> spritesheetMap;
-    std::vector<RenderCommand> renderQueue;
+    std::vector<RenderCommand> commandBuffer;
+    std::vector<std::function<void()>> userCallbacks;
 
+    /// The recorded frame, swapped out of commandBuffer so the next frame can record while it executes.
+    std::vector<RenderCommand> frameCommands;
+    std::vector<std::function<void()>> frameCallbacks;
+    std::vector<Material::TextureBinding> snapshotTextures;
+    std::vector<Material::UniformEntry> snapshotUniforms;
+    bool hasRecordedFrame = false;
+    bool isFrameResolved = false;
 
-    using CameraAndWidth = std::pair<Camera2D*, float>;
-    struct CameraAndWidthHash
+    LayerCache layerCache;
+
+    ResolutionScaler resolutionScaler;
+    DynamicResolutionSettings dynamicResolution;
+
+    DebugRenderer debugRenderer;
+    Shader* debugShapeShader = nullptr;
+
+    GpuProfiler gpuProfiler;
+    int recordedLayer = -1;
+    static constexpr int STATS_OVERLAY_INTERVAL = 15; ///< Frames between overlay text refreshes.
+    std::unique_ptr<TextObject> statsOverlay;
+    Camera2D statsOverlayCamera;
+    int statsOverlayFrame = 0;
+
+    std::vector<DrawItem> drawItems;
+    std::vector<DrawItem> drawItemScratch;
+
+    struct StaticDrawItem
     {
-        std::size_t operator()(const CameraAndWidth& key) const
-        {
-            return std::hash<Camera2D*>()(key.first) ^ std::hash<float>()(key.second);
-        }
+        uint64_t key;
+        const StaticBatcher* batcher;
+        uint32_t chunk;
+        Camera2D* camera;
     };
-    std::unordered_map<CameraAndWidth, std::vector<LineInstance>, CameraAndWidthHash> debugLineMap;
-    GLuint debugLineVAO = 0, debugLineVBO = 0;
-    Shader* debugLineShader;
-
-    RenderMap renderMap;
+    std::vector<StaticDrawItem> staticDrawItems;
     RenderLayerManager renderLayerManager;
-};
 
+    static constexpr size_t INITIAL_INSTANCE_STREAM_BYTES = 4 * 1024 * 1024;
+    RingBuffer instanceRingBuffer;
 
+    static constexpr uint32_t INITIAL_RESIDENT_INSTANCE_SLOTS = 4096;
+    InstanceStore instanceStore;
 
-class FrustumCuller
-{
-public:
-    static void CullVisible(const Camera2D& camera, const std::vector<Object*>& allObjects,
-        std::vector<Object*>& outVisibleList, glm::vec2 viewportSize);
+    static constexpr size_t INITIAL_POOL_VERTICES = 16 * 1024;
+    static constexpr size_t INITIAL_POOL_INDICES = 48 * 1024;
+    MeshPool meshPool;
+    CameraBuffer cameraBuffer;
+    SubmissionMode submissionMode = SubmissionMode::Direct;
+    std::vector<DrawElementsIndirectCommand> indirectScratch;
+
+    SpriteBatcher spriteBatcher;
+    bool isSpriteBatchingEnabled = true;
+    std::vector<std::unique_ptr<Material>> spriteBatchMaterials;
+
+    std::vector<std::unique_ptr<Texture>> textureArrays;
+    std::vector<std::unique_ptr<Material>> mergedMaterials;
+    std::unordered_map<std::string, std::unique_ptr<TextureAtlas>> textureAtlases;
+
+    float interpolationAlpha = 1.0f; ///< Of the frame being recorded; see SNAKE_Engine::GetInterpolationAlpha.
+    RenderStats renderStats;
+    RenderStats recordedStats;      ///< Counted while recording; published with the GL counters by FinishFrame.
+    GLStateStats executedGLStats;
+    GpuTimings gpuTimings;
+
+    /// Below this many objects, culling and draw item generation stay on the calling thread.
+    static constexpr size_t PARALLEL_BUILD_THRESHOLD = 4096;
+    static constexpr size_t MIN_OBJECTS_PER_CHUNK = 1024;
+    static constexpr size_t CHUNKS_PER_THREAD = 4;
+    ThreadPool threadPool;
+
+    struct BuildChunk
+    {
+        std::vector<uint32_t> visibleIndices;
+        std::vector<DrawItem> drawItems;
+    };
+    std::vector<BuildChunk> buildChunks;
+    std::vector<uint32_t> visibleIndices;
 };
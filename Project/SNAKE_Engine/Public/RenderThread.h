@@ -0,0 +1,74 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class SNAKE_Engine;
+struct GLFWwindow;
+
+/**
+ * @brief Thread that owns the GL context and executes the frames the main thread records.
+ *
+ * @details
+ * The context is current on exactly one thread at a time. Kick releases it on the main thread and
+ * wakes the render thread, which makes it current, runs the frame function (execute and swap) and
+ * releases it again. Sync waits for that frame to finish, makes the context current on the main
+ * thread again and runs the finish function there.
+ *
+ * Everything that issues GL calls from the main thread calls Sync first: resource constructors
+ * and destructors, registration, state changes, static chunk changes and recording. Culling and
+ * draw item building do not, so they overlap the frame in flight. Sync returns immediately when
+ * the main thread already holds the context, when it is called from another thread, or when no
+ * render thread is running, so single-threaded code pays for one check.
+ */
+class RenderThread
+{
+    friend SNAKE_Engine;
+public:
+    RenderThread() = default;
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /// Waits for the frame in flight and takes the GL context back onto the main thread.
+    static void Sync();
+
+    /// True while a render thread executes the frames, i.e. RenderManager only records on the main thread.
+    [[nodiscard]] static bool IsRunning() { return instance != nullptr; }
+
+private:
+    /**
+     * @param window Window whose context is handed back and forth, or null when there is none, as under NullBackend.
+     * @param renderFrame Runs on the render thread with the context current.
+     * @param finishFrame Runs on the main thread in the Sync after the frame, with the context current.
+     */
+    void Start(GLFWwindow* window, std::function<void()> renderFrame, std::function<void()> finishFrame);
+
+    /// Hands the recorded frame to the render thread. The main thread gives up the context until the next Sync.
+    void Kick();
+
+    void Stop();
+
+    void WaitForFrame();
+
+    void Loop();
+
+    static RenderThread* instance;
+
+    std::thread thread;
+    std::thread::id mainThreadID;
+    GLFWwindow* window = nullptr;
+    std::function<void()> renderFrame;
+    std::function<void()> finishFrame;
+
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    bool hasFrame = false;
+    bool stopping = false;
+
+    bool isContextOnMain = true;     ///< Only touched by the main thread.
+    bool isFrameUnfinished = false;  ///< A kicked frame whose finish function has not run yet.
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+class RenderManager;
+class Shader;
+
+using GLuint = unsigned int;
+
+/**
+ * @brief Options of RenderManager::SetDynamicResolution.
+ */
+struct DynamicResolutionSettings
+{
+    bool isEnabled = false;
+    double budgetMs = 14.0;              ///< GPU time per frame the scale is steered towards, a little under the frame time to leave room for the CPU.
+    float minScale = 0.5f;               ///< Lowest fraction of the window size the scene is rendered at, per axis.
+    float maxScale = 1.0f;
+    bool renderUiAtNativeResolution = true; ///< Draws objects that ignore the camera after the upscale, at window resolution.
+};
+
+/**
+ * @brief Renders the scene into an offscreen target below window resolution and upscales it.
+ *
+ * @details
+ * The target is allocated at window size and the scene is drawn into its lower-left corner with a
+ * smaller viewport, so changing the scale never reallocates anything. Projections map to NDC, so
+ * only the viewport changes: Camera2D keeps the window size as its screen size, and culling, mouse
+ * picking and InputManager::GetMouseWorldPos work in window pixels as before.
+ *
+ * The scale follows the measured GPU time of the frames a few frames back (see GpuProfiler): it
+ * drops quickly when the frame is over budget and creeps back up once there is headroom again.
+ * The target holds premultiplied color, like LayerCache targets, and is blended over the cleared
+ * window.
+ */
+class ResolutionScaler
+{
+    friend RenderManager;
+public:
+    ResolutionScaler() = default;
+    ~ResolutionScaler();
+
+    ResolutionScaler(const ResolutionScaler&) = delete;
+    ResolutionScaler& operator=(const ResolutionScaler&) = delete;
+
+    /// Fraction of the window size, per axis, the scene was last recorded at.
+    [[nodiscard]] float GetScale() const { return scale; }
+
+private:
+    void Init(Shader* upscaleShader);
+
+    /// Moves the scale towards the budget, given the GPU time of the last measured frame; 0 leaves it alone.
+    void Update(const DynamicResolutionSettings& settings, double gpuMs);
+
+    /// Makes sure the target covers a @p width x @p height window. False when it cannot be created.
+    [[nodiscard]] bool PrepareTarget(int width, int height);
+
+    /// Binds the target, clears it to transparent and sets the viewport to the scaled scene.
+    void BindTarget(int sceneWidth, int sceneHeight) const;
+
+    /// Binds the default framebuffer and blends the scaled scene over the whole window.
+    void Upscale(int sceneWidth, int sceneHeight, int windowWidth, int windowHeight) const;
+
+    [[nodiscard]] GLuint GetFramebuffer() const { return framebuffer; }
+
+    void Free();
+
+    static constexpr float SCALE_DOWN_STEP = 0.05f;  ///< Largest drop per frame.
+    static constexpr float SCALE_UP_STEP = 0.01f;    ///< Largest rise per frame; slower, since the measured time lags a few frames.
+    static constexpr double HEADROOM = 0.85;        ///< Fraction of the budget below which the scale may rise.
+
+    Shader* upscaleShader = nullptr;
+    GLuint framebuffer = 0;
+    GLuint texture = 0;
+    GLuint vertexArray = 0;
+    int targetWidth = 0;
+    int targetHeight = 0;
+    float scale = 1.0f;
+};
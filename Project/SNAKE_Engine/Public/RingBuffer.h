@@ -0,0 +1,96 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class RenderManager;
+class DebugRenderer;
+
+using GLuint = unsigned int;
+typedef struct __GLsync* GLsync;
+
+/**
+ * @brief Sub-range of the ring buffer handed out for one upload.
+ *
+ * @details
+ * `data` points into persistently mapped memory and can be written directly.
+ * `buffer` and `offset` are what draw calls bind to read the data back.
+ */
+struct RingAllocation
+{
+    GLuint buffer = 0;
+    size_t offset = 0;
+    void* data = nullptr;
+};
+
+/**
+ * @brief Per-frame streaming counters of a RingBuffer.
+ */
+struct RingBufferStats
+{
+    size_t bytesStreamed = 0; ///< Bytes written into the ring during the frame.
+    uint32_t fenceStalls = 0; ///< Times the CPU had to block on a GPU fence before reusing a region.
+    uint32_t growCount = 0;   ///< Times the ring was reallocated because a frame did not fit.
+};
+
+/**
+ * @brief Persistently mapped, fenced streaming buffer for per-frame GPU data.
+ *
+ * @details
+ * The buffer is split into FRAME_COUNT regions. Each frame writes into its own region and places
+ * a fence when it is submitted, so the CPU only waits if it laps the GPU by FRAME_COUNT frames.
+ * The fence is placed by SubmitFence on the thread that issued the frame's draws, which may be
+ * the render thread; EndFrame then runs on the recording thread once that frame has executed.
+ * If a frame needs more than one region, the ring grows and the old storage is retired at the end
+ * of the frame so allocations made earlier in the frame stay valid.
+ */
+class RingBuffer
+{
+    friend RenderManager;
+    friend DebugRenderer;
+public:
+    static constexpr int FRAME_COUNT = 3;
+    static constexpr size_t DEFAULT_ALIGNMENT = 16;
+
+    RingBuffer() = default;
+    ~RingBuffer();
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    [[nodiscard]] const RingBufferStats& GetLastFrameStats() const { return lastFrameStats; }
+
+    [[nodiscard]] size_t GetBytesPerFrame() const { return regionSize; }
+
+private:
+    void Init(size_t bytesPerFrame);
+
+    void BeginFrame();
+
+    /// Fences the current region after the draws reading it were issued.
+    void SubmitFence();
+
+    void EndFrame();
+
+    [[nodiscard]] RingAllocation Allocate(size_t size, size_t alignment = DEFAULT_ALIGNMENT);
+
+    void Grow(size_t requiredBytes);
+
+    void CreateStorage(size_t bytesPerFrame);
+
+    void WaitForRegion(int region);
+
+    void Free();
+
+    GLuint buffer = 0;
+    unsigned char* mappedData = nullptr;
+    size_t regionSize = 0;
+    size_t head = 0;
+    int currentRegion = 0;
+    std::array<GLsync, FRAME_COUNT> fences{};
+    std::vector<GLuint> retiredBuffers;
+
+    RingBufferStats frameStats;
+    RingBufferStats lastFrameStats;
+};
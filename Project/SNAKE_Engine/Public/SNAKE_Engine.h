@@ -1,11 +1,15 @@
 #pragma once
+#include "EngineConfig.h"
 #include "EngineContext.h"
+#include "RenderThread.h"
 
 class SNAKE_Engine
 {
 public:
     SNAKE_Engine() = default;
 
+    [[nodiscard]] bool Init(const EngineConfig& config);
+
     [[nodiscard]] bool Init(int windowWidth, int windowHeight);
 
     void Run();
@@ -17,17 +21,32 @@ public:
     void RenderDebugDraws(bool shouldShow) { showDebugDraw = shouldShow; }
 
     [[nodiscard]] bool ShouldRenderDebugDraws() const { return showDebugDraw; }
+
+    /// Simulation ticks per second, or 0 when Update runs once per frame with a variable step.
+    [[nodiscard]] double GetTickRate() const { return tickRate; }
+
+    /// How far the current frame lies between the last two ticks, from 0 to 1. Always 1 without a tick rate.
+    [[nodiscard]] float GetInterpolationAlpha() const { return interpolationAlpha; }
 private:
     void Free() const;
 
     void SetEngineContext();
 
+    /// Executes the frame handed over by the main thread. Runs on the render thread.
+    void RenderFrame();
+
     EngineContext engineContext;
     StateManager stateManager;
     WindowManager windowManager;
     InputManager inputManager;
     RenderManager renderManager;
     SoundManager soundManager;
+    RenderThread renderThread;
+    bool useRenderThread = false;
+    double tickRate = 0.0;
+    int maxTicksPerFrame = 5;
+    int frameLimit = 0;
+    float interpolationAlpha = 1.0f;
     bool shouldRun = true;
     bool showDebugDraw = false;
 };
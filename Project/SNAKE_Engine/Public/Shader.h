@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "glm.hpp"
+#include "InstanceData.h"
+#include "UniformID.h"
 
 enum class ShaderStage
 {
@@ -16,14 +19,21 @@ enum class ShaderStage
 
 class RenderManager;
 class Material;
+class DebugRenderer;
+class LayerCache;
+class ResolutionScaler;
 
 using GLuint = unsigned int;
+using GLint = int;
 using GLenum = unsigned int;
 using FilePath = std::string;
 
 class Shader {
     friend Material;
     friend RenderManager;
+    friend DebugRenderer;
+    friend LayerCache;
+    friend ResolutionScaler;
 
 public:
     Shader();
@@ -44,6 +54,22 @@ public:
 
     [[nodiscard]] GLuint GetProgramID() const { return programID; }
 
+    /// Location of an active uniform, looked up in the table reflected at link time; -1 if the program has no such uniform.
+    [[nodiscard]] GLint GetUniformLocation(UniformID id) const;
+
+    [[nodiscard]] uint32_t GetSortID() const { return sortID; }
+
+    [[nodiscard]] InstanceLayout GetInstanceLayout() const { return instanceLayout; }
+
+    /// Whether the shader reads its texture from an array layer given by the `i_TextureLayer` instance attribute.
+    [[nodiscard]] bool UsesTextureLayer() const { return usesTextureLayer; }
+
+    /// Whether the shader maps its UVs with the `u_UVOffset` and `u_UVScale` uniforms, which lets it draw atlas sub-rects.
+    [[nodiscard]] bool SupportsUVTransform() const { return supportsUVTransform; }
+
+    /// Whether the shader reads its view-projection from the `CameraBlock` uniform block, indexed by `u_CameraIndex`.
+    [[nodiscard]] bool UsesCameraBlock() const { return usesCameraBlock; }
+
 private:
     void Use() const;
 
@@ -51,21 +77,63 @@ private:
 
     [[nodiscard]] bool SupportsInstancing() const;
 
+    /// Compiles the attached sources and links them, or restores the program from ProgramCache. Blocks until done.
     void Link();
 
+    /**
+     * @brief Starts compiling and linking without waiting for the driver.
+     *
+     * @details
+     * No compile or link status is queried, so with GL_KHR_parallel_shader_compile (or a driver that
+     * compiles on its own threads) the work overlaps whatever the caller does next. FinishLink must
+     * run before the program is used; RenderManager does that on first lookup or in WaitForShaders.
+     */
+    void BeginLink();
+
+    /// False while the driver is still compiling; only known with GL_KHR_parallel_shader_compile, otherwise false until FinishLink.
+    [[nodiscard]] bool IsLinkComplete() const;
+
+    /// Waits for BeginLink's work, reports errors, stores the binary and reflects the program. Does nothing if no link is pending.
+    void FinishLink();
+
+    [[nodiscard]] bool IsLinkPending() const { return isLinkPending; }
+
     void AttachFromFile(ShaderStage stage, const FilePath& filepath);
 
     void AttachFromSource(ShaderStage stage, const std::string& source);
 
     [[nodiscard]] std::string LoadShaderSource(const FilePath& filepath);
 
+    /// Creates and compiles a shader object without waiting for the result; see CheckCompileStatus.
     [[nodiscard]] GLuint CompileShader(ShaderStage stage, const std::string& source);
 
+    void CheckCompileStatus(GLuint shader, ShaderStage stage) const;
+
     void CheckSupportsInstancing();
 
+    void ReflectUniforms();
+
     GLuint programID;
+    uint32_t sortID;
     std::vector<GLuint> attachedShaders;
     std::vector<ShaderStage> attachedStages;
-
-    bool isSupportInstancing;
+    std::vector<std::string> attachedSources; ///< Compiled by Link, unless the program comes from the cache.
+    uint64_t cacheKey = 0;
+    bool isLinkPending = false;
+    bool isLoadedFromCache = false;
+    double blockedLinkMs = 0.0; ///< Time BeginLink and FinishLink spent on the calling thread.
+
+    struct UniformLocation
+    {
+        UniformID id;
+        GLint location;
+    };
+    std::vector<UniformLocation> uniformLocations; ///< Active uniforms sorted by ID.
+
+    InstanceLayout instanceLayout;
+    bool usesTextureLayer = false;
+    bool supportsUVTransform = false;
+    bool usesCameraBlock = false;
+
+    Shader* spriteBatchShader = nullptr; ///< Variant with per-vertex color that draws this shader's dynamic sprite batches.
 };
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "glm.hpp"
+
+class RenderManager;
+struct DrawItem;
+
+using GLuint = unsigned int;
+
+/**
+ * @brief Vertex of a dynamic sprite batch: world-space position, final UV and the object's color.
+ */
+struct SpriteVertex
+{
+    glm::vec3 position;
+    glm::vec2 uv;
+    uint8_t color[4]; ///< RGBA, 0..255 maps to 0..1
+};
+
+static_assert(sizeof(SpriteVertex) == 24, "SpriteVertex must stay tightly packed");
+
+/**
+ * @brief Draws runs of non-instanced objects with one call by transforming their vertices on the CPU.
+ *
+ * @details
+ * RenderManager hands over consecutive draw items that share a material, camera and per-run state.
+ * Their meshes are transformed into world space, with each object's UV rect and color applied per
+ * vertex, and written into the instance ring buffer together with rebased indices. The run is then
+ * drawn with the sprite batch variant of the material's shader (RenderManager::SetSpriteBatchShader),
+ * which reads `aColor` at COLOR_LOCATION instead of `u_Model` and `u_Color`.
+ *
+ * Only meshes that keep a CPU copy (Mesh::CanBeBaked) can be batched.
+ */
+class SpriteBatcher
+{
+    friend RenderManager;
+public:
+    static constexpr GLuint COLOR_LOCATION = 2;
+
+    SpriteBatcher() = default;
+    ~SpriteBatcher();
+
+    SpriteBatcher(const SpriteBatcher&) = delete;
+    SpriteBatcher& operator=(const SpriteBatcher&) = delete;
+
+private:
+    void Init();
+
+    /// Vertex and index counts @p items need once batched.
+    static void Measure(const DrawItem* items, size_t count, size_t& outVertexCount, size_t& outIndexCount);
+
+    /// Writes the batched geometry of @p items, posed at @p alpha between their last two ticks; indices are relative to the first vertex written.
+    static void Write(const DrawItem* items, size_t count, float alpha, SpriteVertex* vertices, uint32_t* indices);
+
+    /// Binds the batch VAO reading vertices at @p vertexOffset and indices from @p buffer.
+    void Bind(GLuint buffer, size_t vertexOffset) const;
+
+    void Free();
+
+    GLuint vao = 0;
+};
@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "glm.hpp"
+
+class Object;
+class Mesh;
+class Material;
+class Camera2D;
+class RenderManager;
+class RenderLayerManager;
+
+using GLuint = unsigned int;
+using GLsizei = int;
+
+/**
+ * @brief Bakes static objects into merged, chunked world-space geometry.
+ *
+ * @details
+ * Objects marked static (Object::SetStatic, or a layer marked with RenderLayerManager::SetStatic)
+ * are grouped by layer, material, color and a CHUNK_SIZE grid cell of their position. Each chunk
+ * owns one vertex/index buffer holding its members' mesh triangles already transformed to world
+ * space, so a chunk is culled with one AABB test and drawn with one call.
+ *
+ * Sync walks the object list once, hands every object that cannot be baked back as dynamic and
+ * marks a chunk dirty only when one of its members moved, changed its look, was hidden or is no
+ * longer in the list. Dirty chunks are rebuilt before they are drawn; clean chunks cost nothing.
+ *
+ * Objects with a sprite animator, text objects, instancing materials and meshes that are not plain
+ * triangle lists are never baked. Per-object Draw hooks are not called for baked objects.
+ */
+class StaticBatcher
+{
+    friend RenderManager;
+public:
+    static constexpr float CHUNK_SIZE = 1024.0f;
+
+    StaticBatcher() = default;
+    ~StaticBatcher();
+
+    StaticBatcher(const StaticBatcher&) = delete;
+    StaticBatcher& operator=(const StaticBatcher&) = delete;
+
+    /**
+     * @brief Picks up static objects from @p objects and collects everything else in @p outDynamic.
+     *
+     * @param outDynamic Cleared, then filled in list order with the objects that must be drawn normally.
+     */
+    void Sync(const std::vector<Object*>& objects, const RenderLayerManager& layers, std::vector<Object*>& outDynamic);
+
+    void Clear();
+
+    [[nodiscard]] size_t GetMemberCount() const { return members.size() - freeMembers.size(); }
+
+    [[nodiscard]] size_t GetChunkCount() const { return chunks.size(); }
+
+    /// Chunks whose geometry was rebuilt by the last Sync.
+    [[nodiscard]] size_t GetLastRebuildCount() const { return lastRebuildCount; }
+
+private:
+    struct ChunkKey
+    {
+        Material* material;
+        Camera2D* referenceCamera; ///< Only set for screen-space chunks.
+        uint32_t color;            ///< RGBA8, baked objects are drawn with the chunk's u_Color.
+        int32_t cellX, cellY;
+        uint8_t layer;
+        bool ignoreCamera;
+
+        bool operator==(const ChunkKey& other) const
+        {
+            return material == other.material && referenceCamera == other.referenceCamera && color == other.color &&
+                cellX == other.cellX && cellY == other.cellY && layer == other.layer && ignoreCamera == other.ignoreCamera;
+        }
+    };
+
+    struct ChunkKeyHash
+    {
+        size_t operator()(const ChunkKey& key) const;
+    };
+
+    struct Chunk
+    {
+        ChunkKey key;
+        glm::vec4 color = glm::vec4(1);
+        std::vector<uint32_t> members;
+        glm::vec2 boundsMin = glm::vec2(0);
+        glm::vec2 boundsMax = glm::vec2(0);
+        GLuint vao = 0, vbo = 0, ebo = 0;
+        GLsizei indexCount = 0;
+        uint32_t version = 0;      ///< Incremented by every rebuild, so a cached rendering of the chunk can tell it is stale.
+        bool isDirty = false;
+    };
+
+    struct Member
+    {
+        Object* object = nullptr;
+        const Mesh* mesh = nullptr;
+        Material* material = nullptr;
+        glm::vec4 color = glm::vec4(1);
+        uint64_t transformVersion = 0;
+        uint32_t chunk = 0;
+        uint32_t indexInChunk = 0;
+        uint32_t lastSeen = 0;
+        uint8_t layer = 0;
+        bool isVisible = false;
+        bool ignoreCamera = false;
+        bool flipX = false, flipY = false;
+    };
+
+    [[nodiscard]] static bool CanBake(Object* obj, const RenderLayerManager& layers);
+
+    [[nodiscard]] bool HasChanged(const Member& member, Object* obj) const;
+
+    void Snapshot(Member& member, Object* obj) const;
+
+    [[nodiscard]] ChunkKey MakeChunkKey(Object* obj) const;
+
+    void AddMember(Object* obj);
+
+    void RemoveMember(uint32_t memberIndex);
+
+    void AttachToChunk(uint32_t memberIndex, const ChunkKey& key);
+
+    void DetachFromChunk(uint32_t memberIndex);
+
+    void RebuildChunk(Chunk& chunk);
+
+    void RebuildDirtyChunks();
+
+    std::vector<Member> members;
+    std::vector<uint32_t> freeMembers;
+    uint32_t syncGeneration = 0;
+
+    std::vector<Chunk> chunks;
+    std::unordered_map<ChunkKey, uint32_t, ChunkKeyHash> chunkLookup;
+    std::vector<uint32_t> dirtyChunks;
+
+    size_t lastRebuildCount = 0;
+};
@@ -1,5 +1,7 @@
 #pragma once
+#include <memory>
 #include <string>
+#include <vector>
 
 using FilePath = std::string;
 
@@ -34,6 +36,7 @@ class Texture
 {
     friend class Material;
     friend class RenderManager;
+    friend class TextureAtlas;
 public:
     Texture(const FilePath& path, const TextureSettings& settings = {});
     Texture(const unsigned char* data, int width_, int height_, int channels_, const TextureSettings& settings = {});
@@ -42,7 +45,32 @@ public:
     [[nodiscard]] int GetHeight() const { return height; }
     [[nodiscard]] unsigned int GetID() const { return id; }
 
+    [[nodiscard]] int GetChannels() const { return channels; }
+
+    [[nodiscard]] int GetLayerCount() const { return layerCount; }
+
 private:
+    Texture();
+
+    /**
+     * @brief Copies same-size 2D textures into the layers of a new GL_TEXTURE_2D_ARRAY.
+     *
+     * @details
+     * Layer i holds layers[i]. Every texture must have the size and channel count of the first one;
+     * filtering and wrapping are taken from the first texture.
+     */
+    [[nodiscard]] static std::unique_ptr<Texture> CreateArray(const std::vector<const Texture*>& layers);
+
+    /// Creates an uninitialized RGBA8 texture that filters like @p settingsSource.
+    [[nodiscard]] static std::unique_ptr<Texture> CreateBlank(int width, int height, const Texture& settingsSource);
+
+    /// Reads level 0 back as tightly packed RGBA8 rows, bottom row first.
+    [[nodiscard]] std::vector<unsigned char> ReadPixelsRGBA() const;
+
+    [[nodiscard]] bool IsRepeating() const;
+
+    void CopySamplerParameters(const Texture& source);
+
     void BindToUnit(unsigned int unit) const;
 
     void UnBind(unsigned int unit) const;
@@ -50,4 +78,5 @@ private:
     void GenerateTexture(const unsigned char* data, const TextureSettings& settings);
     unsigned int id;
     int width, height, channels;
+    int layerCount = 1;
 };
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "glm.hpp"
+
+class Texture;
+class RenderManager;
+
+/**
+ * @brief Where a texture was packed inside an atlas page.
+ */
+struct AtlasRegion
+{
+    Texture* page = nullptr;
+    glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f); ///< UV offset in xy, UV scale in zw.
+};
+
+/**
+ * @brief Packs small textures into shared RGBA8 pages with a skyline bottom-left packer.
+ *
+ * @details
+ * RenderManager owns one atlas per group passed to RenderManager::AddTextureToAtlas. Build copies
+ * every pending texture into the first page with room for it, opening a new PAGE_SIZE page when
+ * none has. Each texture is surrounded by PADDING texels repeating its edge, so linear filtering
+ * at the border of a sub-rect does not pick up its neighbours. Packing is incremental: textures
+ * added after a Build go into the free space of the existing pages.
+ *
+ * The source textures stay valid; materials using them are redirected to the page by RenderManager.
+ * Textures that repeat or are larger than a page are left out.
+ */
+class TextureAtlas
+{
+    friend RenderManager;
+public:
+    static constexpr int PAGE_SIZE = 1024;
+    static constexpr int PADDING = 2;
+
+    TextureAtlas() = default;
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    /// Region of @p texture, or nullptr if it is not packed into this atlas.
+    [[nodiscard]] const AtlasRegion* FindRegion(const Texture* texture) const;
+
+    [[nodiscard]] size_t GetPageCount() const { return pages.size(); }
+
+    [[nodiscard]] size_t GetRegionCount() const { return regions.size(); }
+
+private:
+    struct SkylineNode
+    {
+        int x, y, width;
+    };
+
+    struct Page
+    {
+        std::unique_ptr<Texture> texture;
+        std::vector<SkylineNode> skyline;
+    };
+
+    void Add(const Texture* texture);
+
+    void Build();
+
+    [[nodiscard]] static bool FindPosition(const Page& page, int width, int height, int& outX, int& outY, size_t& outNode);
+
+    static void AddSkylineLevel(Page& page, size_t node, int x, int y, int width, int height);
+
+    [[nodiscard]] Page& CreatePage(const Texture* settingsSource);
+
+    std::vector<Page> pages;
+    std::vector<const Texture*> pendingTextures;
+    std::unordered_map<const Texture*, AtlasRegion> regions;
+};
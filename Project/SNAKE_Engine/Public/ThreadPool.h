@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads for data-parallel jobs.
+ *
+ * @details
+ * ParallelFor splits a job into chunks that workers and the calling thread pull from a shared
+ * counter, and returns once every chunk has finished. Only one job runs at a time, and the caller
+ * always takes part, so a pool without workers simply runs the job inline.
+ *
+ * Jobs must not issue GL calls: workers have no context.
+ */
+class ThreadPool
+{
+public:
+    /// Upper bound on workers; the calling thread comes on top of this.
+    static constexpr unsigned MAX_WORKERS = 7;
+
+    ThreadPool() = default;
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param workerCount Number of workers. 0 picks hardware_concurrency - 1, capped at MAX_WORKERS.
+     */
+    void Init(unsigned workerCount = 0);
+
+    /**
+     * @brief Stops and joins the worker threads.
+     */
+    void Free();
+
+    /**
+     * @brief Number of threads that take part in a job, including the caller.
+     */
+    [[nodiscard]] unsigned GetThreadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    /**
+     * @brief Calls func(chunkIndex) for every chunk in [0, chunkCount) and waits for all of them.
+     *
+     * @details
+     * Chunks run in no particular order and possibly concurrently, so func must only write to
+     * per-chunk state.
+     */
+    template<typename Func>
+    void ParallelFor(size_t chunkCount, Func&& func)
+    {
+        using FuncType = std::remove_reference_t<Func>;
+        Run(chunkCount, [](void* context, size_t chunk) { (*static_cast<FuncType*>(context))(chunk); }, &func);
+    }
+
+private:
+    using JobFunc = void(*)(void* context, size_t chunk);
+
+    void Run(size_t chunkCount, JobFunc func, void* context);
+
+    void RunChunks();
+
+    void WorkerLoop();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+    bool stopping = false;
+    uint64_t generation = 0;
+    unsigned activeWorkers = 0;
+
+    JobFunc jobFunc = nullptr;
+    void* jobContext = nullptr;
+    size_t jobChunkCount = 0;
+    std::atomic<size_t> nextChunk{ 0 };
+    std::atomic<size_t> pendingChunks{ 0 };
+};
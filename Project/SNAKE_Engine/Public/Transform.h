@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include "glm.hpp"
 
 class Transform2D
@@ -14,36 +15,42 @@ public:
     {
         position = pos;
         isChanged = true;
+        version = ++nextVersion;
     }
 
     void AddPosition(const glm::vec2& pos)
     {
         position += pos;
         isChanged = true;
+        version = ++nextVersion;
     }
 
     void SetRotation(float rot)
     {
         rotation = rot;
         isChanged = true;
+        version = ++nextVersion;
     }
 
     void AddRotation(float rot)
     {
         rotation += rot;
         isChanged = true;
+        version = ++nextVersion;
     }
 
     void SetScale(const glm::vec2& scl)
     {
         scale = scl;
         isChanged = true;
+        version = ++nextVersion;
     }
 
     void AddScale(const glm::vec2& scl)
     {
         scale += scl;
         isChanged = true;
+        version = ++nextVersion;
     }
 
     [[nodiscard]] const glm::vec2& GetPosition() const { return position; }
@@ -54,10 +61,52 @@ public:
 
     [[nodiscard]] glm::mat4& GetMatrix();
 
+    /**
+     * @brief Changes with every setter, so caches can tell whether the transform changed since they last looked.
+     *
+     * @details
+     * Versions come from one counter shared by all transforms, including the initial one, so no two
+     * poses ever share a version. An object allocated at a freed object's address therefore never
+     * matches what a cache remembered about the old one.
+     */
+    [[nodiscard]] uint64_t GetVersion() const { return version; }
+
+    /**
+     * @brief Makes the current pose the start point of render interpolation.
+     *
+     * @details
+     * With a fixed tick rate the engine calls this for every managed object before each tick, and
+     * frames drawn between ticks blend from this pose to the current one. Call it after teleporting
+     * an object so it does not visibly slide to its new position.
+     */
+    void StorePreviousPose()
+    {
+        previousPosition = position;
+        previousRotation = rotation;
+        previousScale = scale;
+        previousVersion = version;
+        hasPreviousPose = true;
+    }
+
+    /// True when the pose changed since StorePreviousPose, so frames between ticks draw it blended.
+    [[nodiscard]] bool IsInterpolating() const { return hasPreviousPose && version != previousVersion; }
+
+    /// Matrix between the pose stored by StorePreviousPose (alpha 0) and the current one (alpha 1).
+    [[nodiscard]] glm::mat4 GetInterpolatedMatrix(float alpha);
+
 private:
     glm::vec2 position;
     float rotation;
     glm::vec2 scale;
     glm::mat4 matrix;
     bool isChanged;
+    uint64_t version = ++nextVersion;
+
+    glm::vec2 previousPosition = glm::vec2(0.f);
+    float previousRotation = 0.f;
+    glm::vec2 previousScale = glm::vec2(1.f);
+    uint64_t previousVersion = 0;
+    bool hasPreviousPose = false;
+
+    inline static uint64_t nextVersion = 0; ///< Only touched by the thread that updates objects.
 };
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+/// 32-bit FNV-1a hash of a uniform name. Shader and Material key their uniform tables by it.
+using UniformID = uint32_t;
+
+/**
+ * @brief Hashes a uniform name into its UniformID.
+ *
+ * @details
+ * The function is constexpr, so IDs of string literals can be resolved at compile time and hot
+ * paths never touch the name again:
+ * @code
+ * constexpr UniformID U_COLOR = MakeUniformID("u_Color");
+ * material->SetUniform(U_COLOR, color);
+ * @endcode
+ * Shader::Link reports an error if two active uniforms of a program hash to the same ID.
+ */
+[[nodiscard]] constexpr UniformID MakeUniformID(std::string_view name)
+{
+    uint32_t hash = 2166136261u;
+    for (char c : name)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "glm.hpp"
+
+class Object;
+class Mesh;
+class Camera2D;
+
+/**
+ * @brief Persistent loose grid over an object list, used to cull without visiting every object.
+ *
+ * @details
+ * Each object lives in the cell containing its centre, and queries grow the view rectangle by the
+ * largest radius stored in any cell, so an object never needs more than one cell. Objects larger
+ * than a cell are kept in a separate list that every query tests, and screen-space objects
+ * (ShouldIgnoreCamera) bypass the grid entirely and always pass.
+ *
+ * Sync walks the object list once to pick up slot changes and flags, but only moves objects whose
+ * Transform2D version or mesh changed. Query cost depends on the cells around the view and the
+ * objects in them, not on the size of the world.
+ */
+class VisibilityGrid
+{
+public:
+    static constexpr float DEFAULT_CELL_SIZE = 256.0f;
+
+    explicit VisibilityGrid(float cellSize = DEFAULT_CELL_SIZE);
+
+    void SetCellSize(float size);
+
+    [[nodiscard]] float GetCellSize() const { return cellSize; }
+
+    void Sync(const std::vector<Object*>& objects);
+
+    /**
+     * @brief Collects the slots (indices into the synced list) of objects visible from the camera.
+     *
+     * @param outSlots Cleared, then filled in ascending slot order.
+     */
+    void Query(const Camera2D& camera, glm::vec2 viewportSize, std::vector<uint32_t>& outSlots) const;
+
+    void Clear();
+
+    /// Objects re-inserted by the last Sync because they were new, moved or changed shape.
+    [[nodiscard]] size_t GetLastMovedCount() const { return lastMovedCount; }
+
+    /// Cells visited by the last Query.
+    [[nodiscard]] size_t GetLastVisitedCellCount() const { return lastVisitedCellCount; }
+
+private:
+    enum class Bucket : uint8_t
+    {
+        None,
+        Cell,
+        Large,
+        ScreenSpace
+    };
+
+    struct Record
+    {
+        Object* object = nullptr;
+        const Mesh* mesh = nullptr;
+        float x = 0.0f, y = 0.0f, radius = 0.0f;
+        uint32_t slot = 0;
+        uint64_t transformVersion = 0;
+        uint32_t lastSeen = 0;
+        uint64_t cellKey = 0;
+        uint32_t indexInBucket = 0;
+        Bucket bucket = Bucket::None;
+        bool isActive = false;
+    };
+
+    [[nodiscard]] uint64_t GetCellKey(float x, float y) const;
+
+    [[nodiscard]] std::vector<uint32_t>& GetBucketList(Bucket bucket, uint64_t cellKey);
+
+    void Place(uint32_t recordIndex, Bucket bucket, uint64_t cellKey);
+
+    void Unplace(uint32_t recordIndex);
+
+    void Rebuild();
+
+    float cellSize;
+    float maxCellRadius = 0.0f;
+
+    std::vector<Record> records;
+    std::vector<uint32_t> freeRecords;
+    size_t recordCount = 0;  ///< Records in use, i.e. not in freeRecords.
+    uint32_t syncGeneration = 0;
+
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells;
+    std::vector<uint32_t> largeRecords;
+    std::vector<uint32_t> screenSpaceRecords;
+
+    size_t lastMovedCount = 0;
+    mutable size_t lastVisitedCellCount = 0;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include "EngineConfig.h"
 class SNAKE_Engine;
 struct GLFWwindow;
 struct EngineContext;
@@ -22,7 +23,7 @@ public:
     void SetTitle(const std::string& title) const;
 
 private:
-    bool Init(int _windowWidth, int _windowHeight, SNAKE_Engine& engine);
+    bool Init(int _windowWidth, int _windowHeight, RenderBackend backend, SNAKE_Engine& engine);
 
     void SetWidth(int width) { this->windowWidth = width; }
 
@@ -39,4 +40,5 @@ private:
     GLFWwindow* window;
     int windowWidth;
     int windowHeight;
+    bool isHeadless = false;
 };